@@ -13,6 +13,7 @@ option(OSSIA_DATAFLOW "Dataflow features" ON)
 option(OSSIA_EDITOR "Editor features" ON)
 option(OSSIA_GFX "Graphics features" ON)
 option(OSSIA_HIDE_ALL_SYMBOLS "Hide all symbols from the ossia lib" OFF)
+option(OSSIA_AUDIO_FLOAT "Use 32-bit float samples in the audio ports instead of double" OFF)
 
 # Bindings :
 option(OSSIA_JAVA "Build JNI bindings" OFF)
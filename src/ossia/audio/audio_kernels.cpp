@@ -0,0 +1,430 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/audio/audio_kernels.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OSSIA_AUDIO_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace ossia::audio_kernels
+{
+namespace scalar
+{
+struct vec
+{
+  using reg = double;
+  static constexpr std::size_t width = 1;
+  static constexpr std::size_t frames = 0;
+
+  static reg load(const double* p) noexcept { return *p; }
+  static void store(double* p, reg r) noexcept { *p = r; }
+  static reg set1(double d) noexcept { return d; }
+  static reg add(reg a, reg b) noexcept { return a + b; }
+  static reg mul(reg a, reg b) noexcept { return a * b; }
+  static reg load_float(const float* p) noexcept { return *p; }
+  static void store_float(float* p, reg r) noexcept { *p = float(r); }
+  static void interleave2(float*, const float*, const float*) noexcept { }
+  static void deinterleave2(float*, float*, const float*) noexcept { }
+};
+
+struct fvec
+{
+  using reg = float;
+  static constexpr std::size_t width = 1;
+
+  static reg load(const float* p) noexcept { return *p; }
+  static void store(float* p, reg r) noexcept { *p = r; }
+  static reg set1(float f) noexcept { return f; }
+  static reg add(reg a, reg b) noexcept { return a + b; }
+  static reg mul(reg a, reg b) noexcept { return a * b; }
+};
+
+#include <ossia/audio/audio_kernels_impl.hpp>
+}
+
+#if defined(OSSIA_AUDIO_KERNELS_X86)
+// SSE2 is part of x86-64: no specific target is needed.
+namespace sse2
+{
+struct vec
+{
+  using reg = __m128d;
+  static constexpr std::size_t width = 2;
+  static constexpr std::size_t frames = 4;
+
+  static reg load(const double* p) noexcept { return _mm_loadu_pd(p); }
+  static void store(double* p, reg r) noexcept { _mm_storeu_pd(p, r); }
+  static reg set1(double d) noexcept { return _mm_set1_pd(d); }
+  static reg add(reg a, reg b) noexcept { return _mm_add_pd(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm_mul_pd(a, b); }
+
+  static reg load_float(const float* p) noexcept
+  {
+    return _mm_cvtps_pd(_mm_castsi128_ps(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+  }
+  static void store_float(float* p, reg r) noexcept
+  {
+    _mm_storel_epi64(
+        reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(r)));
+  }
+
+  static void interleave2(float* dst, const float* l, const float* r) noexcept
+  {
+    const __m128 a = _mm_loadu_ps(l);
+    const __m128 b = _mm_loadu_ps(r);
+    _mm_storeu_ps(dst, _mm_unpacklo_ps(a, b));
+    _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(a, b));
+  }
+  static void deinterleave2(float* l, float* r, const float* src) noexcept
+  {
+    const __m128 a = _mm_loadu_ps(src);
+    const __m128 b = _mm_loadu_ps(src + 4);
+    _mm_storeu_ps(l, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(r, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+};
+
+struct fvec
+{
+  using reg = __m128;
+  static constexpr std::size_t width = 4;
+
+  static reg load(const float* p) noexcept { return _mm_loadu_ps(p); }
+  static void store(float* p, reg r) noexcept { _mm_storeu_ps(p, r); }
+  static reg set1(float f) noexcept { return _mm_set1_ps(f); }
+  static reg add(reg a, reg b) noexcept { return _mm_add_ps(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm_mul_ps(a, b); }
+};
+
+#include <ossia/audio/audio_kernels_impl.hpp>
+}
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+namespace avx2
+{
+struct vec
+{
+  using reg = __m256d;
+  static constexpr std::size_t width = 4;
+  static constexpr std::size_t frames = 8;
+
+  static reg load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+  static void store(double* p, reg r) noexcept { _mm256_storeu_pd(p, r); }
+  static reg set1(double d) noexcept { return _mm256_set1_pd(d); }
+  static reg add(reg a, reg b) noexcept { return _mm256_add_pd(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm256_mul_pd(a, b); }
+
+  static reg load_float(const float* p) noexcept
+  {
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+  }
+  static void store_float(float* p, reg r) noexcept
+  {
+    _mm_storeu_ps(p, _mm256_cvtpd_ps(r));
+  }
+
+  static void interleave2(float* dst, const float* l, const float* r) noexcept
+  {
+    const __m256 a = _mm256_loadu_ps(l);
+    const __m256 b = _mm256_loadu_ps(r);
+    // Unpacking works inside each 128-bit lane: the lanes are put back in order after
+    const __m256 lo = _mm256_unpacklo_ps(a, b);
+    const __m256 hi = _mm256_unpackhi_ps(a, b);
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+  static void deinterleave2(float* l, float* r, const float* src) noexcept
+  {
+    const __m256 x = _mm256_loadu_ps(src);
+    const __m256 y = _mm256_loadu_ps(src + 8);
+    const __m256 a = _mm256_permute2f128_ps(x, y, 0x20);
+    const __m256 b = _mm256_permute2f128_ps(x, y, 0x31);
+    _mm256_storeu_ps(l, _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm256_storeu_ps(r, _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+};
+
+struct fvec
+{
+  using reg = __m256;
+  static constexpr std::size_t width = 8;
+
+  static reg load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+  static void store(float* p, reg r) noexcept { _mm256_storeu_ps(p, r); }
+  static reg set1(float f) noexcept { return _mm256_set1_ps(f); }
+  static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+};
+
+#include <ossia/audio/audio_kernels_impl.hpp>
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+namespace avx512
+{
+// Stereo (de)interleaving is done on 256-bit registers, as with AVX2
+struct vec : avx2::vec
+{
+  using reg = __m512d;
+  static constexpr std::size_t width = 8;
+
+  static reg load(const double* p) noexcept { return _mm512_loadu_pd(p); }
+  static void store(double* p, reg r) noexcept { _mm512_storeu_pd(p, r); }
+  static reg set1(double d) noexcept { return _mm512_set1_pd(d); }
+  static reg add(reg a, reg b) noexcept { return _mm512_add_pd(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm512_mul_pd(a, b); }
+
+  static reg load_float(const float* p) noexcept
+  {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+  }
+  static void store_float(float* p, reg r) noexcept
+  {
+    _mm256_storeu_ps(p, _mm512_cvtpd_ps(r));
+  }
+};
+
+struct fvec
+{
+  using reg = __m512;
+  static constexpr std::size_t width = 16;
+
+  static reg load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+  static void store(float* p, reg r) noexcept { _mm512_storeu_ps(p, r); }
+  static reg set1(float f) noexcept { return _mm512_set1_ps(f); }
+  static reg add(reg a, reg b) noexcept { return _mm512_add_ps(a, b); }
+  static reg mul(reg a, reg b) noexcept { return _mm512_mul_ps(a, b); }
+};
+
+#include <ossia/audio/audio_kernels_impl.hpp>
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+
+namespace
+{
+struct kernel_table
+{
+  void (*add)(double*, const double*, std::size_t) noexcept;
+  void (*add_scaled)(double*, const double*, double, std::size_t) noexcept;
+  void (*scale)(double*, const double*, double, std::size_t) noexcept;
+  void (*multiply)(double*, const double*, const float*, std::size_t) noexcept;
+  void (*add_spread)(
+      double* const*, const double*, std::size_t, const double*,
+      std::size_t) noexcept;
+  void (*convert_to_double)(double*, const float*, std::size_t) noexcept;
+  void (*convert_to_float)(float*, const double*, std::size_t) noexcept;
+  void (*add_to_double)(double*, const float*, std::size_t) noexcept;
+  void (*add_to_float)(float*, const double*, double, std::size_t) noexcept;
+  void (*add_float)(float*, const float*, std::size_t) noexcept;
+  void (*add_scaled_float)(float*, const float*, double, std::size_t) noexcept;
+  void (*scale_float)(float*, const float*, double, std::size_t) noexcept;
+  void (*multiply_float)(float*, const float*, const float*, std::size_t) noexcept;
+  void (*add_spread_float)(
+      float* const*, const double*, std::size_t, const float*,
+      std::size_t) noexcept;
+  void (*interleave)(float*, const float* const*, std::size_t, std::size_t) noexcept;
+  void (*deinterleave)(float* const*, const float*, std::size_t, std::size_t) noexcept;
+};
+
+#define OSSIA_AUDIO_KERNEL_TABLE(ns)                                        \
+  kernel_table                                                              \
+  {                                                                         \
+    &ns::add, &ns::add_scaled, &ns::scale, &ns::multiply, &ns::add_spread, \
+        &ns::convert, &ns::convert, &ns::add_converted,                     \
+        &ns::add_converted, &ns::add, &ns::add_scaled, &ns::scale,          \
+        &ns::multiply, &ns::add_spread, &ns::interleave, &ns::deinterleave  \
+  }
+
+const kernel_table tables[] = {
+    OSSIA_AUDIO_KERNEL_TABLE(scalar),
+#if defined(OSSIA_AUDIO_KERNELS_X86)
+    OSSIA_AUDIO_KERNEL_TABLE(sse2),
+    OSSIA_AUDIO_KERNEL_TABLE(avx2),
+    OSSIA_AUDIO_KERNEL_TABLE(avx512),
+#endif
+};
+
+isa detect_isa() noexcept
+{
+#if defined(OSSIA_AUDIO_KERNELS_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+
+  __cpuid(info, 1);
+  const bool osxsave = info[2] & (1 << 27);
+  const bool avx = info[2] & (1 << 28);
+  if (!osxsave || !avx || max_leaf < 7)
+    return isa::sse2;
+
+  // The OS must save the AVX (and AVX-512) registers on context switches
+  const auto xcr0 = _xgetbv(0);
+  if ((xcr0 & 0x6) != 0x6)
+    return isa::sse2;
+
+  __cpuidex(info, 7, 0);
+  if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)
+    return isa::avx512;
+  if (info[1] & (1 << 5))
+    return isa::avx2;
+  return isa::sse2;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return isa::avx512;
+  if (__builtin_cpu_supports("avx2"))
+    return isa::avx2;
+  return isa::sse2;
+#endif
+#else
+  return isa::scalar;
+#endif
+}
+
+std::atomic<const kernel_table*> current_table{};
+
+const kernel_table& kernels() noexcept
+{
+  if (auto t = current_table.load(std::memory_order_relaxed))
+    return *t;
+
+  auto t = &tables[int(best_isa())];
+  current_table.store(t, std::memory_order_relaxed);
+  return *t;
+}
+}
+
+isa best_isa() noexcept
+{
+  static const isa best = detect_isa();
+  return best;
+}
+
+isa current_isa() noexcept
+{
+  return isa(&kernels() - tables);
+}
+
+void set_isa(isa i) noexcept
+{
+  i = std::min(i, best_isa());
+  current_table.store(&tables[int(i)], std::memory_order_relaxed);
+}
+
+void add(double* dst, const double* src, std::size_t n) noexcept
+{
+  kernels().add(dst, src, n);
+}
+
+void add_scaled(double* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  kernels().add_scaled(dst, src, gain, n);
+}
+
+void scale(double* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  kernels().scale(dst, src, gain, n);
+}
+
+void multiply(double* dst, const double* src, const float* gains, std::size_t n) noexcept
+{
+  kernels().multiply(dst, src, gains, n);
+}
+
+void add_spread(
+    double* const* dst, const double* weights, std::size_t channels,
+    const double* src, std::size_t n) noexcept
+{
+  kernels().add_spread(dst, weights, channels, src, n);
+}
+
+void convert(double* dst, const float* src, std::size_t n) noexcept
+{
+  kernels().convert_to_double(dst, src, n);
+}
+
+void convert(float* dst, const double* src, std::size_t n) noexcept
+{
+  kernels().convert_to_float(dst, src, n);
+}
+
+void add_converted(double* dst, const float* src, std::size_t n) noexcept
+{
+  kernels().add_to_double(dst, src, n);
+}
+
+void add_converted(float* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  kernels().add_to_float(dst, src, gain, n);
+}
+
+void add(float* dst, const float* src, std::size_t n) noexcept
+{
+  kernels().add_float(dst, src, n);
+}
+
+void add_scaled(float* dst, const float* src, double gain, std::size_t n) noexcept
+{
+  kernels().add_scaled_float(dst, src, gain, n);
+}
+
+void scale(float* dst, const float* src, double gain, std::size_t n) noexcept
+{
+  kernels().scale_float(dst, src, gain, n);
+}
+
+void multiply(float* dst, const float* src, const float* gains, std::size_t n) noexcept
+{
+  kernels().multiply_float(dst, src, gains, n);
+}
+
+void add_spread(
+    float* const* dst, const double* weights, std::size_t channels,
+    const float* src, std::size_t n) noexcept
+{
+  kernels().add_spread_float(dst, weights, channels, src, n);
+}
+
+void interleave(
+    float* dst, const float* const* src, std::size_t channels,
+    std::size_t n) noexcept
+{
+  kernels().interleave(dst, src, channels, n);
+}
+
+void deinterleave(
+    float* const* dst, const float* src, std::size_t channels,
+    std::size_t n) noexcept
+{
+  kernels().deinterleave(dst, src, channels, n);
+}
+}
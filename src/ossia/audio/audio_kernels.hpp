@@ -0,0 +1,140 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+
+/**
+ * \file audio_kernels.hpp
+ *
+ * Vectorized loops used on the audio buffers.
+ *
+ * On x86, the implementation is chosen once at startup among SSE2, AVX2 and
+ * AVX-512 according to what the CPU supports. Other architectures use
+ * plain loops, left to the compiler's auto-vectorizer.
+ *
+ * Unless stated otherwise the buffers may not overlap, except when
+ * dst and src are the same pointer.
+ */
+namespace ossia::audio_kernels
+{
+enum class isa : int8_t
+{
+  scalar,
+  sse2,
+  avx2,
+  avx512
+};
+
+//! Instruction set used by the kernels
+OSSIA_EXPORT
+isa current_isa() noexcept;
+
+//! Best instruction set supported by the CPU
+OSSIA_EXPORT
+isa best_isa() noexcept;
+
+/**
+ * @brief Changes the instruction set used by the kernels.
+ *
+ * Clamped to \ref best_isa. Meant for tests and benchmarks:
+ * must not be called while kernels run in other threads.
+ */
+OSSIA_EXPORT
+void set_isa(isa) noexcept;
+
+//! dst[i] += src[i]
+OSSIA_EXPORT
+void add(double* dst, const double* src, std::size_t n) noexcept;
+
+//! dst[i] += gain * src[i]
+OSSIA_EXPORT
+void add_scaled(double* dst, const double* src, double gain, std::size_t n) noexcept;
+
+//! dst[i] = gain * src[i]
+OSSIA_EXPORT
+void scale(double* dst, const double* src, double gain, std::size_t n) noexcept;
+
+//! dst[i] = gains[i] * src[i]
+OSSIA_EXPORT
+void multiply(double* dst, const double* src, const float* gains, std::size_t n) noexcept;
+
+//! dst[c][i] += weights[c] * src[i], e.g. to pan a mono signal
+OSSIA_EXPORT
+void add_spread(
+    double* const* dst, const double* weights, std::size_t channels,
+    const double* src, std::size_t n) noexcept;
+
+//! dst[i] += src[i]
+OSSIA_EXPORT
+void add(float* dst, const float* src, std::size_t n) noexcept;
+
+//! dst[i] += gain * src[i]
+OSSIA_EXPORT
+void add_scaled(float* dst, const float* src, double gain, std::size_t n) noexcept;
+
+//! dst[i] = gain * src[i]
+OSSIA_EXPORT
+void scale(float* dst, const float* src, double gain, std::size_t n) noexcept;
+
+//! dst[i] = gains[i] * src[i]
+OSSIA_EXPORT
+void multiply(float* dst, const float* src, const float* gains, std::size_t n) noexcept;
+
+//! dst[c][i] += weights[c] * src[i]
+OSSIA_EXPORT
+void add_spread(
+    float* const* dst, const double* weights, std::size_t channels,
+    const float* src, std::size_t n) noexcept;
+
+//! dst[i] = src[i]
+OSSIA_EXPORT
+void convert(double* dst, const float* src, std::size_t n) noexcept;
+
+//! dst[i] = src[i]
+OSSIA_EXPORT
+void convert(float* dst, const double* src, std::size_t n) noexcept;
+
+//! dst[i] += src[i]
+OSSIA_EXPORT
+void add_converted(double* dst, const float* src, std::size_t n) noexcept;
+
+//! dst[i] += gain * src[i]
+OSSIA_EXPORT
+void add_converted(float* dst, const double* src, double gain, std::size_t n) noexcept;
+
+// When the audio ports use float (OSSIA_AUDIO_FLOAT), the conversions
+// between the ports and the float buffers of the audio APIs have nothing
+// to convert anymore.
+
+//! dst[i] = src[i]
+inline void convert(float* dst, const float* src, std::size_t n) noexcept
+{
+  std::copy_n(src, n, dst);
+}
+
+//! dst[i] += src[i]
+inline void add_converted(float* dst, const float* src, std::size_t n) noexcept
+{
+  add(dst, src, n);
+}
+
+//! dst[i] += gain * src[i]
+inline void add_converted(float* dst, const float* src, double gain, std::size_t n) noexcept
+{
+  add_scaled(dst, src, gain, n);
+}
+
+//! dst[i * channels + c] = src[c][i]
+OSSIA_EXPORT
+void interleave(
+    float* dst, const float* const* src, std::size_t channels,
+    std::size_t n) noexcept;
+
+//! dst[c][i] = src[i * channels + c]
+OSSIA_EXPORT
+void deinterleave(
+    float* const* dst, const float* src, std::size_t channels,
+    std::size_t n) noexcept;
+}
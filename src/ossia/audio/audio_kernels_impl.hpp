@@ -0,0 +1,204 @@
+// Kernels, written once for every instruction set.
+//
+// This file is included several times by audio_kernels.cpp, each time
+// inside a different namespace which defines a `vec` type
+// wrapping the registers of an instruction set:
+//
+// - reg: a register of doubles, and width: the number of doubles in it
+// - load, store, set1, add, mul
+// - load_float / store_float: load or store width floats
+// - frames: number of stereo frames handled by interleave2 / deinterleave2,
+//   0 if there are none.
+//
+// and a `fvec` type with the same operations on a register of floats,
+// for the float overloads.
+//
+// Hence no include guard.
+
+inline void add(double* dst, const double* src, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(dst + i, vec::add(vec::load(dst + i), vec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] += src[i];
+}
+
+inline void add_scaled(double* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  const auto g = vec::set1(gain);
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(
+        dst + i, vec::add(vec::load(dst + i), vec::mul(g, vec::load(src + i))));
+  for (; i < n; i++)
+    dst[i] += gain * src[i];
+}
+
+inline void scale(double* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  const auto g = vec::set1(gain);
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(dst + i, vec::mul(g, vec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] = gain * src[i];
+}
+
+inline void multiply(double* dst, const double* src, const float* gains, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(dst + i, vec::mul(vec::load_float(gains + i), vec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] = double(gains[i]) * src[i];
+}
+
+inline void add_spread(
+    double* const* dst, const double* weights, std::size_t channels,
+    const double* src, std::size_t n) noexcept
+{
+  // A tick of a channel fits in L1: src stays there from a channel to the next.
+  for (std::size_t c = 0; c < channels; c++)
+    add_scaled(dst[c], src, weights[c], n);
+}
+
+inline void add(float* dst, const float* src, std::size_t n) noexcept
+{
+  constexpr std::size_t W = fvec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    fvec::store(dst + i, fvec::add(fvec::load(dst + i), fvec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] += src[i];
+}
+
+inline void add_scaled(float* dst, const float* src, double gain, std::size_t n) noexcept
+{
+  constexpr std::size_t W = fvec::width;
+  const float gf = float(gain);
+  const auto g = fvec::set1(gf);
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    fvec::store(
+        dst + i, fvec::add(fvec::load(dst + i), fvec::mul(g, fvec::load(src + i))));
+  for (; i < n; i++)
+    dst[i] += gf * src[i];
+}
+
+inline void scale(float* dst, const float* src, double gain, std::size_t n) noexcept
+{
+  constexpr std::size_t W = fvec::width;
+  const float gf = float(gain);
+  const auto g = fvec::set1(gf);
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    fvec::store(dst + i, fvec::mul(g, fvec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] = gf * src[i];
+}
+
+inline void multiply(float* dst, const float* src, const float* gains, std::size_t n) noexcept
+{
+  constexpr std::size_t W = fvec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    fvec::store(dst + i, fvec::mul(fvec::load(gains + i), fvec::load(src + i)));
+  for (; i < n; i++)
+    dst[i] = gains[i] * src[i];
+}
+
+inline void add_spread(
+    float* const* dst, const double* weights, std::size_t channels,
+    const float* src, std::size_t n) noexcept
+{
+  for (std::size_t c = 0; c < channels; c++)
+    add_scaled(dst[c], src, weights[c], n);
+}
+
+inline void convert(double* dst, const float* src, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(dst + i, vec::load_float(src + i));
+  for (; i < n; i++)
+    dst[i] = src[i];
+}
+
+inline void convert(float* dst, const double* src, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store_float(dst + i, vec::load(src + i));
+  for (; i < n; i++)
+    dst[i] = float(src[i]);
+}
+
+inline void add_converted(double* dst, const float* src, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store(dst + i, vec::add(vec::load(dst + i), vec::load_float(src + i)));
+  for (; i < n; i++)
+    dst[i] += src[i];
+}
+
+inline void add_converted(float* dst, const double* src, double gain, std::size_t n) noexcept
+{
+  constexpr std::size_t W = vec::width;
+  const auto g = vec::set1(gain);
+  std::size_t i = 0;
+  for (; i + W <= n; i += W)
+    vec::store_float(
+        dst + i,
+        vec::add(vec::load_float(dst + i), vec::mul(g, vec::load(src + i))));
+  for (; i < n; i++)
+    dst[i] = float(dst[i] + gain * src[i]);
+}
+
+inline void interleave(
+    float* dst, const float* const* src, std::size_t channels,
+    std::size_t n) noexcept
+{
+  std::size_t i = 0;
+  if constexpr (vec::frames > 0)
+  {
+    if (channels == 2)
+    {
+      constexpr std::size_t F = vec::frames;
+      for (; i + F <= n; i += F)
+        vec::interleave2(dst + 2 * i, src[0] + i, src[1] + i);
+    }
+  }
+
+  for (; i < n; i++)
+    for (std::size_t c = 0; c < channels; c++)
+      dst[i * channels + c] = src[c][i];
+}
+
+inline void deinterleave(
+    float* const* dst, const float* src, std::size_t channels,
+    std::size_t n) noexcept
+{
+  std::size_t i = 0;
+  if constexpr (vec::frames > 0)
+  {
+    if (channels == 2)
+    {
+      constexpr std::size_t F = vec::frames;
+      for (; i + F <= n; i += F)
+        vec::deinterleave2(dst[0] + i, dst[1] + i, src + 2 * i);
+    }
+  }
+
+  for (; i < n; i++)
+    for (std::size_t c = 0; c < channels; c++)
+      dst[c][i] = src[i * channels + c];
+}
@@ -2,6 +2,7 @@
 
 #include "audio_protocol.hpp"
 
+#include <ossia/audio/audio_kernels.hpp>
 #include <ossia/dataflow/nodes/sound.hpp>
 #include <ossia/dataflow/execution_state.hpp>
 
@@ -29,8 +30,7 @@ void audio_parameter::clone_value(audio_vector& res_vec) const
     if (res.size() < N)
       res.resize(N);
 
-    for (std::size_t i = 0; i < N; i++)
-      res[i] += double(src[i]);
+    audio_kernels::add_converted(res.data(), src.data(), N);
   }
 }
 
@@ -42,10 +42,7 @@ void audio_parameter::push_value(const audio_port& port)
     auto& src = port.samples[chan];
     auto& dst = audio[chan];
     const auto N = std::min(src.size(), (std::size_t)dst.size());
-    for (std::size_t i = 0; i < N; i++)
-    {
-      dst[i] += float(src[i] * m_gain);
-    }
+    audio_kernels::add_converted(dst.data(), src.data(), m_gain, N);
   }
 }
 
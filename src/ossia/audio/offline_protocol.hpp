@@ -0,0 +1,268 @@
+#pragma once
+#include <ossia/audio/audio_engine.hpp>
+#include <ossia/audio/audio_kernels.hpp>
+#include <ossia/audio/drwav_handle.hpp>
+#include <ossia/detail/logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ossia
+{
+struct offline_render_stats
+{
+  //! Frames actually rendered
+  uint64_t frames{};
+
+  //! Duration of the rendered audio
+  double rendered_seconds{};
+
+  //! Time taken to render it
+  double wall_seconds{};
+
+  //! How many times faster than realtime the rendering was
+  double realtime_factor() const noexcept
+  {
+    return wall_seconds > 0. ? rendered_seconds / wall_seconds : 0.;
+  }
+};
+
+/**
+ * @brief Audio engine without a clock, for batch rendering and tests
+ *
+ * Instead of being driven by a soundcard, render() calls the audio tick
+ * back-to-back in the calling thread, as fast as the CPU allows.
+ * The transport position is computed from the rendered frames only, so that
+ * two renderings of the same score give the same result. For this, the
+ * network devices used by the score can be replaced by the copies given by
+ * ossia::net::make_local_copy.
+ *
+ * The inputs can be read from a WAV file, and the outputs written to one,
+ * as 32-bit float.
+ *
+ * Which graph is used, e.g. the parallel one, only depends on the tick
+ * given with set_tick, as with the other engines.
+ */
+class offline_engine final : public audio_engine
+{
+public:
+  offline_engine(int rate, int bs, int inputs, int outputs)
+  {
+    effective_sample_rate = rate;
+    effective_buffer_size = bs;
+    effective_inputs = inputs;
+    effective_outputs = outputs;
+
+    m_inputs.resize(inputs, std::vector<float>(bs));
+    m_outputs.resize(outputs, std::vector<float>(bs));
+    for (auto& chan : m_inputs)
+      m_inputPtrs.push_back(chan.data());
+    for (auto& chan : m_outputs)
+      m_outputPtrs.push_back(chan.data());
+  }
+
+  ~offline_engine() override
+  {
+    close_output();
+  }
+
+  bool running() const override
+  {
+    return m_rendering;
+  }
+
+  //! Feeds the inputs from a WAV file: its channels go to the inputs in
+  //! order, and the inputs are silent past its end. The file is not
+  //! resampled.
+  bool open_input(const std::string& path)
+  {
+    std::ifstream f{path, std::ios::binary};
+    if (!f)
+    {
+      ossia::logger().error("offline_engine: cannot open {}", path);
+      return false;
+    }
+
+    m_inputFile.assign(std::istreambuf_iterator<char>{f}, {});
+    m_inputWav.open_memory(m_inputFile.data(), m_inputFile.size());
+    if (!m_inputWav.wav() || m_inputWav.channels() == 0)
+    {
+      ossia::logger().error("offline_engine: {} is not a WAV file", path);
+      m_inputWav = drwav_handle{};
+      return false;
+    }
+
+    if (int(m_inputWav.sampleRate()) != effective_sample_rate)
+      ossia::logger().warn(
+          "offline_engine: {} is at {} Hz instead of {} Hz", path,
+          m_inputWav.sampleRate(), effective_sample_rate);
+
+    // The channels of the file past the inputs are read into m_discarded
+    const std::size_t file_chans = m_inputWav.channels();
+    m_interleaved.resize(std::size_t(effective_buffer_size) * file_chans);
+    m_discarded.resize(file_chans > m_inputs.size() ? effective_buffer_size : 0);
+    m_inputFilePtrs.clear();
+    for (std::size_t c = 0; c < file_chans; c++)
+      m_inputFilePtrs.push_back(
+          c < m_inputs.size() ? m_inputs[c].data() : m_discarded.data());
+    return true;
+  }
+
+  //! Writes the outputs to a WAV file, closed when the engine is destroyed
+  bool open_output(const std::string& path)
+  {
+    close_output();
+
+    m_outputFile = std::fopen(path.c_str(), "wb");
+    if (!m_outputFile)
+    {
+      ossia::logger().error("offline_engine: cannot write {}", path);
+      return false;
+    }
+
+    drwav_data_format fmt{};
+    fmt.container = drwav_container_riff;
+    fmt.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+    fmt.channels = effective_outputs;
+    fmt.sampleRate = effective_sample_rate;
+    fmt.bitsPerSample = 32;
+
+    if (!drwav_init_write(
+            &m_outputWav, &fmt, on_write, on_seek, m_outputFile,
+            &drwav_handle::drwav_allocs))
+    {
+      ossia::logger().error("offline_engine: cannot write WAV to {}", path);
+      std::fclose(m_outputFile);
+      m_outputFile = nullptr;
+      return false;
+    }
+
+    m_interleavedOut.resize(std::size_t(effective_buffer_size) * effective_outputs);
+    return true;
+  }
+
+  //! Finishes writing the output file
+  void close_output()
+  {
+    if (m_outputFile)
+    {
+      drwav_uninit(&m_outputWav);
+      std::fclose(m_outputFile);
+      m_outputFile = nullptr;
+    }
+  }
+
+  //! Renders the given number of frames, or less if the engine is stopped
+  //! from another thread in the meantime.
+  offline_render_stats render(uint64_t frames)
+  {
+    using clk = std::chrono::steady_clock;
+    const auto t0 = clk::now();
+    const uint64_t start = m_position;
+
+    m_rendering = true;
+    while (m_position - start < frames)
+    {
+      tick_start();
+      if (stop_processing)
+      {
+        tick_clear();
+        break;
+      }
+
+      const auto n = std::min(uint64_t(effective_buffer_size), frames - (m_position - start));
+
+      read_inputs(n);
+
+      ossia::audio_tick_state ts{
+          m_inputPtrs.data(),
+          m_outputPtrs.data(),
+          effective_inputs,
+          effective_outputs,
+          n,
+          double(m_position) / effective_sample_rate,
+          m_position,
+          transport_status::playing};
+      audio_tick(ts);
+
+      write_outputs(n);
+      m_position += n;
+
+      tick_end();
+    }
+    m_rendering = false;
+
+    offline_render_stats res;
+    res.frames = m_position - start;
+    res.rendered_seconds = double(res.frames) / effective_sample_rate;
+    res.wall_seconds = std::chrono::duration<double>(clk::now() - t0).count();
+    return res;
+  }
+
+  //! Frames rendered since the creation of the engine
+  uint64_t position() const noexcept
+  {
+    return m_position;
+  }
+
+private:
+  void read_inputs(uint64_t n)
+  {
+    for (auto& chan : m_inputs)
+      std::fill_n(chan.begin(), n, 0.f);
+
+    if (!m_inputWav)
+      return;
+
+    const auto read = m_inputWav.read_pcm_frames_f32(n, m_interleaved.data());
+    ossia::audio_kernels::deinterleave(
+        m_inputFilePtrs.data(), m_interleaved.data(), m_inputFilePtrs.size(),
+        read);
+  }
+
+  void write_outputs(uint64_t n)
+  {
+    if (!m_outputFile)
+      return;
+
+    ossia::audio_kernels::interleave(
+        m_interleavedOut.data(), m_outputPtrs.data(), m_outputPtrs.size(), n);
+
+    drwav_write_pcm_frames(&m_outputWav, n, m_interleavedOut.data());
+  }
+
+  static size_t on_write(void* file, const void* data, size_t bytes) noexcept
+  {
+    return std::fwrite(data, 1, bytes, (std::FILE*)file);
+  }
+
+  static drwav_bool32
+  on_seek(void* file, int offset, drwav_seek_origin origin) noexcept
+  {
+    return std::fseek(
+               (std::FILE*)file, offset,
+               origin == drwav_seek_origin_current ? SEEK_CUR : SEEK_SET)
+           == 0;
+  }
+
+  std::vector<std::vector<float>> m_inputs, m_outputs;
+  std::vector<float*> m_inputPtrs, m_outputPtrs;
+
+  std::vector<char> m_inputFile;
+  drwav_handle m_inputWav;
+  std::vector<float> m_interleaved;
+  std::vector<float*> m_inputFilePtrs;
+  std::vector<float> m_discarded;
+
+  std::FILE* m_outputFile{};
+  ::drwav m_outputWav{};
+  std::vector<float> m_interleavedOut;
+
+  uint64_t m_position{};
+  std::atomic_bool m_rendering{};
+};
+}
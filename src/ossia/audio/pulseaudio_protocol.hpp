@@ -1,6 +1,7 @@
 #pragma once
 #if __has_include(<pulse/pulseaudio.h>)
 #include <ossia/audio/audio_engine.hpp>
+#include <ossia/audio/audio_kernels.hpp>
 #include <pulse/pulseaudio.h>
 #include <sstream>
 #include <dlfcn.h>
@@ -477,12 +478,7 @@ private:
             ossia::audio_tick_state ts{float_input, float_outputs, (int)self.effective_inputs, (int)self.effective_outputs, size, usec / 1e6};
             self.audio_tick(ts);
 
-            int k = 0;
-            for(std::size_t i = 0; i < size; i ++)
-            {
-              float_output[k++] = float_outputs[0][i];
-              float_output[k++] = float_outputs[1][i];
-            }
+            ossia::audio_kernels::interleave(float_output, float_outputs, 2, size);
           }
         }
         else
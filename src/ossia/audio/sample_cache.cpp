@@ -0,0 +1,301 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/audio/sample_cache.hpp>
+#include <ossia/detail/logger.hpp>
+
+#include <algorithm>
+
+namespace ossia
+{
+sample_data::sample_data(const audio_array& data, int rate, sample_format fmt)
+    : m_channels{data.size()}
+    , m_rate{rate}
+    , m_format{fmt}
+{
+  for (const auto& chan : data)
+    m_frames = std::max(m_frames, int64_t(chan.size()));
+
+  // Channels shorter than the longest one are padded with silence
+  switch (m_format)
+  {
+    case sample_format::float32:
+      m_f32.resize(m_channels * m_frames);
+      for (std::size_t c = 0; c < m_channels; c++)
+        std::copy(data[c].begin(), data[c].end(), m_f32.begin() + c * m_frames);
+      break;
+    case sample_format::int16:
+      m_s16.resize(m_channels * m_frames);
+      for (std::size_t c = 0; c < m_channels; c++)
+        std::transform(
+            data[c].begin(), data[c].end(), m_s16.begin() + c * m_frames,
+            sample_to_s16);
+      break;
+  }
+}
+
+std::size_t sample_data::bytes() const noexcept
+{
+  return m_f32.size() * sizeof(float) + m_s16.size() * sizeof(int16_t);
+}
+
+void sample_data::read(
+    std::size_t channel, int64_t start, int64_t n, float* dst) const noexcept
+{
+  const int64_t begin = std::clamp(start, int64_t(0), m_frames);
+  const int64_t end = std::clamp(start + n, begin, m_frames);
+
+  const int64_t lead = std::clamp(-start, int64_t(0), n);
+
+  dst = std::fill_n(dst, lead, 0.f);
+
+  if (m_format == sample_format::float32)
+  {
+    const float* src = m_f32.data() + channel * m_frames;
+    dst = std::copy(src + begin, src + end, dst);
+  }
+  else
+  {
+    const int16_t* src = m_s16.data() + channel * m_frames;
+    dst = std::transform(src + begin, src + end, dst, sample_from_s16);
+  }
+
+  std::fill_n(dst, n - lead - (end - begin), 0.f);
+}
+
+sample_cache::sample_cache() = default;
+
+sample_cache::~sample_cache()
+{
+  {
+    std::lock_guard l{m_mutex};
+    m_running = false;
+  }
+  m_cv.notify_all();
+  if (m_thread.joinable())
+    m_thread.join();
+
+  for (auto& j : m_jobs)
+    j.promise.set_value(nullptr);
+}
+
+sample_cache& sample_cache::instance()
+{
+  static sample_cache c;
+  return c;
+}
+
+void sample_cache::set_decoder(decoder d)
+{
+  std::lock_guard l{m_mutex};
+  m_decoder = std::move(d);
+}
+
+void sample_cache::set_format(sample_format fmt)
+{
+  std::lock_guard l{m_mutex};
+  m_format = fmt;
+}
+
+sample_format sample_cache::format() const noexcept
+{
+  std::lock_guard l{m_mutex};
+  return m_format;
+}
+
+void sample_cache::set_budget(std::size_t bytes)
+{
+  std::lock_guard l{m_mutex};
+  m_budget = bytes;
+  trim();
+}
+
+std::size_t sample_cache::budget() const noexcept
+{
+  std::lock_guard l{m_mutex};
+  return m_budget;
+}
+
+std::size_t sample_cache::memory() const noexcept
+{
+  std::lock_guard l{m_mutex};
+  return m_memory;
+}
+
+std::size_t sample_cache::size() const noexcept
+{
+  std::lock_guard l{m_mutex};
+  return m_entries.size();
+}
+
+sample_handle sample_cache::find(const std::string& path, int rate)
+{
+  std::lock_guard l{m_mutex};
+  auto it = m_entries.find(sample_key{path, rate});
+  if (it == m_entries.end() || !it->second.data)
+    return nullptr;
+
+  touch(it->second);
+  return it->second.data;
+}
+
+sample_handle sample_cache::load(const std::string& path, int rate)
+{
+  auto [future, j] = acquire(path, rate);
+  if (j)
+    decode(*j);
+  return future.get();
+}
+
+std::shared_future<sample_handle>
+sample_cache::load_async(const std::string& path, int rate)
+{
+  auto [future, j] = acquire(path, rate);
+  if (j)
+  {
+    {
+      std::lock_guard l{m_mutex};
+      m_jobs.push_back(std::move(*j));
+      if (!m_thread.joinable())
+      {
+        m_running = true;
+        m_thread = std::thread{[this] { run(); }};
+      }
+    }
+    m_cv.notify_one();
+  }
+  return future;
+}
+
+void sample_cache::clear()
+{
+  std::lock_guard l{m_mutex};
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->second.data)
+    {
+      m_lru.erase(it->second.lru);
+      it = m_entries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  m_memory = 0;
+}
+
+std::pair<std::shared_future<sample_handle>, std::optional<sample_cache::job>>
+sample_cache::acquire(const std::string& path, int rate)
+{
+  std::lock_guard l{m_mutex};
+  sample_key key{path, rate};
+  auto it = m_entries.find(key);
+  if (it != m_entries.end())
+  {
+    auto& e = it->second;
+    if (e.data)
+    {
+      touch(e);
+      std::promise<sample_handle> p;
+      p.set_value(e.data);
+      return {p.get_future().share(), std::nullopt};
+    }
+    return {e.pending, std::nullopt};
+  }
+
+  job j{key, {}};
+  auto future = j.promise.get_future().share();
+  m_entries.emplace(std::move(key), entry{nullptr, future, m_lru.end(), 0});
+  return {std::move(future), std::move(j)};
+}
+
+void sample_cache::decode(job& j)
+{
+  decoder dec;
+  sample_format fmt;
+  {
+    std::lock_guard l{m_mutex};
+    dec = m_decoder;
+    fmt = m_format;
+  }
+
+  sample_handle res;
+  try
+  {
+    audio_array data;
+    if (dec && dec(j.key.path, j.key.rate, data))
+      res = std::make_shared<const sample_data>(data, j.key.rate, fmt);
+  }
+  catch (const std::exception& e)
+  {
+    ossia::logger().error("sample_cache: could not decode {}: {}", j.key.path, e.what());
+  }
+
+  {
+    std::lock_guard l{m_mutex};
+    auto it = m_entries.find(j.key);
+    if (it != m_entries.end())
+    {
+      if (res)
+      {
+        auto& e = it->second;
+        e.data = res;
+        e.pending = {};
+        e.bytes = res->bytes();
+        m_lru.push_front(j.key);
+        e.lru = m_lru.begin();
+        m_memory += e.bytes;
+      }
+      else
+      {
+        // Not cached, so that it can be retried later
+        m_entries.erase(it);
+      }
+    }
+
+    // res is still referenced here: the new sound is not evicted
+    j.promise.set_value(res);
+    trim();
+  }
+}
+
+void sample_cache::touch(entry& e)
+{
+  m_lru.splice(m_lru.begin(), m_lru, e.lru);
+}
+
+void sample_cache::trim()
+{
+  auto it = m_lru.end();
+  while (m_memory > m_budget && it != m_lru.begin())
+  {
+    --it;
+    auto e = m_entries.find(*it);
+    // Only the cache uses the sound: evicting it frees its memory
+    if (e != m_entries.end() && e->second.data.use_count() == 1)
+    {
+      m_memory -= e->second.bytes;
+      m_entries.erase(e);
+      it = m_lru.erase(it);
+    }
+  }
+}
+
+void sample_cache::run()
+{
+  std::unique_lock l{m_mutex};
+  while (m_running)
+  {
+    m_cv.wait(l, [this] { return !m_running || !m_jobs.empty(); });
+    if (!m_running)
+      break;
+
+    auto j = std::move(m_jobs.front());
+    m_jobs.erase(m_jobs.begin());
+
+    l.unlock();
+    decode(j);
+    l.lock();
+  }
+}
+}
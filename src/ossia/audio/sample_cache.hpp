@@ -0,0 +1,210 @@
+#pragma once
+#include <ossia/dataflow/nodes/media.hpp>
+#include <ossia/detail/config.hpp>
+#include <ossia/detail/hash.hpp>
+#include <ossia/detail/hash_map.hpp>
+
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ossia
+{
+//! How the samples of a sample_data are stored
+enum class sample_format : int8_t
+{
+  float32, //! Full precision
+  int16    //! Half the memory, converted back to float when read
+};
+
+constexpr float sample_from_s16(int16_t i) noexcept
+{
+  return i * (1.f / 32768.f);
+}
+
+inline int16_t sample_to_s16(float f) noexcept
+{
+  const float s = std::nearbyint(f * 32768.f);
+  return s >= 32767.f ? 32767 : s <= -32768.f ? -32768 : int16_t(s);
+}
+
+/**
+ * @brief A decoded sound file, shared by all the nodes playing it
+ *
+ * Planar, and immutable once created.
+ */
+class OSSIA_EXPORT sample_data
+{
+public:
+  sample_data(const audio_array& data, int rate, sample_format fmt);
+
+  sample_format format() const noexcept { return m_format; }
+  int rate() const noexcept { return m_rate; }
+  std::size_t channels() const noexcept { return m_channels; }
+  int64_t frames() const noexcept { return m_frames; }
+
+  //! Memory used by the samples
+  std::size_t bytes() const noexcept;
+
+  //! Only valid with sample_format::float32
+  gsl::span<const float> f32(std::size_t channel) const noexcept
+  {
+    return {m_f32.data() + channel * m_frames, std::size_t(m_frames)};
+  }
+
+  //! Only valid with sample_format::int16
+  gsl::span<const int16_t> s16(std::size_t channel) const noexcept
+  {
+    return {m_s16.data() + channel * m_frames, std::size_t(m_frames)};
+  }
+
+  //! Copies frames [start; start + n[ of a channel, whatever the format.
+  //! The frames past the end of the sound are silent.
+  void read(std::size_t channel, int64_t start, int64_t n, float* dst) const noexcept;
+
+private:
+  std::vector<float> m_f32;
+  std::vector<int16_t> m_s16;
+  int64_t m_frames{};
+  std::size_t m_channels{};
+  int m_rate{};
+  sample_format m_format{};
+};
+
+using sample_handle = std::shared_ptr<const sample_data>;
+
+struct sample_key
+{
+  std::string path;
+  int rate{};
+
+  bool operator==(const sample_key& other) const noexcept
+  {
+    return rate == other.rate && path == other.path;
+  }
+};
+}
+
+namespace std
+{
+template <>
+struct hash<ossia::sample_key>
+{
+  std::size_t operator()(const ossia::sample_key& k) const noexcept
+  {
+    std::size_t seed = 0;
+    ossia::hash_combine(seed, k.path);
+    ossia::hash_combine(seed, k.rate);
+    return seed;
+  }
+};
+}
+
+namespace ossia
+{
+/**
+ * @brief Process-wide cache of decoded sound files
+ *
+ * Sounds are identified by their path and the sample rate they are
+ * decoded to, so that every node playing the same file at the same rate
+ * shares the same sample_data.
+ *
+ * Decoding is done by a decoder provided by the application, either
+ * synchronously by load(), or in the cache thread by load_async().
+ * Concurrent requests for the same sound share a single decoding.
+ *
+ * The cache keeps the sounds it has decoded until their total size
+ * exceeds the budget; the least recently requested ones are then evicted.
+ * A sound still held by a node is never evicted, as this would not free
+ * anything: the budget may thus be exceeded while they are all in use.
+ *
+ * The format only applies to the sounds decoded afterwards.
+ *
+ * None of this is meant to be called from the audio thread.
+ */
+class OSSIA_EXPORT sample_cache
+{
+public:
+  //! Decodes the file at path, resampled to rate, in out.
+  //! Returns false if the file cannot be read.
+  using decoder = std::function<bool(const std::string& path, int rate, audio_array& out)>;
+
+  sample_cache();
+  ~sample_cache();
+  sample_cache(const sample_cache&) = delete;
+  sample_cache& operator=(const sample_cache&) = delete;
+
+  static sample_cache& instance();
+
+  void set_decoder(decoder d);
+
+  void set_format(sample_format fmt);
+  sample_format format() const noexcept;
+
+  void set_budget(std::size_t bytes);
+  std::size_t budget() const noexcept;
+
+  //! Size of the sounds currently in the cache
+  std::size_t memory() const noexcept;
+
+  //! Number of sounds currently in the cache, decoded or being decoded
+  std::size_t size() const noexcept;
+
+  //! Returns the sound if it is already decoded, nullptr otherwise
+  sample_handle find(const std::string& path, int rate);
+
+  //! Returns the sound, decoding it in the calling thread if needed.
+  //! Returns nullptr if it could not be decoded.
+  sample_handle load(const std::string& path, int rate);
+
+  //! Returns the sound, decoding it in the cache thread if needed
+  std::shared_future<sample_handle> load_async(const std::string& path, int rate);
+
+  //! Forgets all the decoded sounds; the ones in use stay valid
+  void clear();
+
+private:
+  struct entry
+  {
+    sample_handle data;
+    std::shared_future<sample_handle> pending;
+    std::list<sample_key>::iterator lru;
+    std::size_t bytes{};
+  };
+
+  struct job
+  {
+    sample_key key;
+    std::promise<sample_handle> promise;
+  };
+
+  // Returns the future of the sound, and if it has to be decoded,
+  // the promise that the caller must fulfill
+  std::pair<std::shared_future<sample_handle>, std::optional<job>>
+  acquire(const std::string& path, int rate);
+  void decode(job& j);
+  void touch(entry& e);
+  void trim();
+  void run();
+
+  mutable std::mutex m_mutex;
+  ossia::fast_hash_map<sample_key, entry> m_entries;
+  std::list<sample_key> m_lru; // most recently used first
+  decoder m_decoder;
+  std::size_t m_budget{std::size_t(-1)};
+  std::size_t m_memory{};
+  sample_format m_format{sample_format::float32};
+
+  std::condition_variable m_cv;
+  std::vector<job> m_jobs;
+  std::thread m_thread;
+  bool m_running{};
+};
+}
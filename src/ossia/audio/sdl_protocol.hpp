@@ -2,6 +2,7 @@
 #include <ossia/detail/config.hpp>
 #if __has_include(<SDL2/SDL_audio.h>)
 #include <ossia/audio/audio_engine.hpp>
+#include <ossia/audio/audio_kernels.hpp>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
@@ -98,9 +99,7 @@ private:
       ossia::audio_tick_state ts{nullptr, float_output, 0, out_chan, (uint64_t)frames, 0};
       self.audio_tick(ts);
 
-      for (int j = 0; j < frames; j++)
-        for (int c = 0; c < out_chan; c++)
-          *audio_out++ = float_output[c][j];
+      ossia::audio_kernels::interleave(audio_out, float_output, out_chan, frames);
 
       self.tick_end();
     }
@@ -0,0 +1,666 @@
+#pragma once
+#include <ossia/audio/drwav_handle.hpp>
+#include <ossia/detail/algorithms.hpp>
+
+#include <concurrentqueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <sys/mman.h>
+#include <unistd.h>
+#define OSSIA_SOUND_STREAM_MADVISE 1
+#endif
+
+namespace ossia
+{
+//! How a playback position maps to a position in the sound file
+struct sound_stream_loop
+{
+  int64_t start_offset{};
+  int64_t loop_duration{};
+  bool loops{};
+
+  //! Position in the file of a playback frame, and how many of the next
+  //! frames follow it in the file before the loop wraps around.
+  std::pair<int64_t, int64_t> map(int64_t frame, int64_t frames) const noexcept
+  {
+    if (loops && loop_duration > 0)
+    {
+      const int64_t k = ((frame % loop_duration) + loop_duration) % loop_duration;
+      return {start_offset + k, std::min(frames, loop_duration - k)};
+    }
+    return {start_offset + frame, frames};
+  }
+
+  //! The loop duration does not matter when the sound does not loop
+  bool operator==(const sound_stream_loop& other) const noexcept
+  {
+    return start_offset == other.start_offset && loops == other.loops
+           && (!loops || loop_duration == other.loop_duration);
+  }
+  bool operator!=(const sound_stream_loop& other) const noexcept
+  {
+    return !(*this == other);
+  }
+};
+
+namespace detail
+{
+struct sound_stream_voice
+{
+  static constexpr int64_t chunk_frames = 8192;
+
+  // Set by create
+  int channels{};
+  int64_t frames{};
+  int64_t capacity{};
+  bool resident{};
+  uint64_t request{};
+
+  // Planar: capacity frames per channel. When the whole file fits in the
+  // look-ahead window it is decoded once and read in place.
+  std::vector<float> buffer;
+
+  // Only used by the streaming thread
+  drwav_handle handle;
+  std::vector<float> interleaved;
+  sound_stream_loop loop;
+  int64_t write{};
+  int64_t file_pos{-1};
+  uint32_t generation{};
+
+  // Seek requests from the audio thread
+  std::atomic<uint32_t> request_generation{};
+  std::atomic<int64_t> request_frame{};
+  std::atomic<int64_t> request_offset{};
+  std::atomic<int64_t> request_duration{};
+  std::atomic<bool> request_loops{};
+  std::atomic<int64_t> consumed{};
+
+  // Replies from the streaming thread
+  std::atomic<uint32_t> ack_generation{};
+  std::atomic<int64_t> written{};
+
+  std::atomic<uint64_t> underruns{};
+
+  //! Set by the reader once it stops using the voice: the streaming thread
+  //! then frees it.
+  std::atomic_bool retired{};
+
+  //! Creates a voice and decodes the beginning of the playback with
+  //! the given loop. Allocates and reads the file: not for the audio thread.
+  static std::shared_ptr<sound_stream_voice> create(
+      const drwav_handle& hdl, int64_t lookahead, const sound_stream_loop& l)
+  {
+    if (!hdl || hdl.channels() == 0 || hdl.totalPCMFrameCount() == 0)
+      return {};
+
+    auto v = std::make_shared<sound_stream_voice>();
+    v->handle = hdl;
+    if (!v->handle)
+      return {};
+
+    v->channels = hdl.channels();
+    v->frames = hdl.totalPCMFrameCount();
+    v->loop = l;
+    v->resident = v->frames <= lookahead;
+    v->capacity = v->resident ? v->frames : std::max<int64_t>(lookahead, 1);
+    v->buffer.resize(v->channels * v->capacity);
+    v->interleaved.resize(
+        v->channels * std::min(v->capacity, chunk_frames));
+
+    // The beginning of the sound is ready before playback starts
+    v->decode_playback(0, v->capacity);
+    v->write = v->capacity;
+    v->written = v->capacity;
+
+    if (v->resident)
+      v->handle = {};
+    return v;
+  }
+
+  //! Asks the kernel to start reading a range of the mapped file
+  void advise(int64_t file_frame, int64_t count) const noexcept
+  {
+#if defined(OSSIA_SOUND_STREAM_MADVISE)
+    auto wav = handle.wav();
+    if (!wav || !wav->memoryStream.data || count <= 0)
+      return;
+    if (wav->translatedFormatTag != DR_WAVE_FORMAT_PCM
+        && wav->translatedFormatTag != DR_WAVE_FORMAT_IEEE_FLOAT)
+      return;
+
+    const int64_t frame_bytes = wav->channels * wav->bitsPerSample / 8;
+    const int64_t size = wav->memoryStream.dataSize;
+    const int64_t begin = std::clamp<int64_t>(
+        int64_t(wav->dataChunkDataPos)
+            + std::max<int64_t>(file_frame, 0) * frame_bytes,
+        0, size);
+    const int64_t end
+        = std::clamp<int64_t>(begin + count * frame_bytes, begin, size);
+    if (begin == end)
+      return;
+
+    static const auto page = uintptr_t(::sysconf(_SC_PAGESIZE));
+    const auto data = uintptr_t(wav->memoryStream.data);
+    const auto first = (data + begin) & ~(page - 1);
+    ::madvise((void*)first, data + end - first, MADV_WILLNEED);
+#endif
+  }
+
+  //! Index in the buffer of a playback position
+  int64_t slot(int64_t p) const noexcept
+  {
+    return ((p % capacity) + capacity) % capacity;
+  }
+
+  void write_silence(int64_t p, int64_t count) noexcept
+  {
+    for (int64_t k = 0; k < count; k++)
+    {
+      const auto slot = this->slot(p + k);
+      for (int c = 0; c < channels; c++)
+        buffer[c * capacity + slot] = 0.f;
+    }
+  }
+
+  void write_interleaved(int64_t p, const float* data, int64_t count) noexcept
+  {
+    for (int64_t k = 0; k < count; k++)
+    {
+      const auto slot = this->slot(p + k);
+      for (int c = 0; c < channels; c++)
+        buffer[c * capacity + slot] = data[k * channels + c];
+    }
+  }
+
+  //! Decodes count frames of the file, from file_frame,
+  //! at the playback position p of the buffer
+  void decode(int64_t file_frame, int64_t count, int64_t p) noexcept
+  {
+    int64_t k = 0;
+    if (file_frame < 0)
+    {
+      k = std::min(count, -file_frame);
+      write_silence(p, k);
+    }
+
+    int64_t readable = std::clamp<int64_t>(frames - (file_frame + k), 0, count - k);
+    if (readable > 0 && file_pos != file_frame + k)
+    {
+      if (handle.seek_to_pcm_frame(file_frame + k))
+        file_pos = file_frame + k;
+      else
+        readable = 0;
+    }
+
+    while (readable > 0)
+    {
+      const auto n = std::min(readable, chunk_frames);
+      const auto got = int64_t(handle.read_pcm_frames_f32(n, interleaved.data()));
+      write_interleaved(p + k, interleaved.data(), got);
+      k += got;
+      file_pos += got;
+      readable -= got;
+      if (got < n)
+      {
+        file_pos = -1;
+        break;
+      }
+    }
+
+    write_silence(p + k, count - k);
+  }
+
+  //! Decodes count frames from the playback position p
+  void decode_playback(int64_t p, int64_t count) noexcept
+  {
+    while (count > 0)
+    {
+      const auto [file_frame, run] = loop.map(p, count);
+      advise(file_frame, run + chunk_frames);
+      decode(file_frame, run, p);
+      p += run;
+      count -= run;
+    }
+  }
+
+  //! Called by the streaming thread. Returns true if there was work to do.
+  bool service() noexcept
+  {
+    const auto gen = request_generation.load(std::memory_order_acquire);
+    if (gen != generation)
+    {
+      const sound_stream_loop l{
+          request_offset.load(std::memory_order_relaxed),
+          request_duration.load(std::memory_order_relaxed),
+          request_loops.load(std::memory_order_relaxed)};
+      const auto target = request_frame.load(std::memory_order_relaxed);
+
+      // Another request came while reading this one
+      if (request_generation.load(std::memory_order_acquire) != gen)
+        return true;
+
+      generation = gen;
+      loop = l;
+      write = target;
+
+      const auto [file_frame, run] = loop.map(target, capacity);
+      advise(file_frame, run);
+
+      written.store(target, std::memory_order_release);
+      ack_generation.store(gen, std::memory_order_release);
+    }
+
+    const auto cons = consumed.load(std::memory_order_acquire);
+    if (cons > write)
+      write = cons;
+
+    const auto count = std::min(cons + capacity - write, chunk_frames);
+    if (count <= 0)
+      return false;
+
+    decode_playback(write, count);
+    write += count;
+    written.store(write, std::memory_order_release);
+    return true;
+  }
+};
+
+//! Where the streaming thread hands the voices it opened to a sound_stream
+struct sound_stream_handoff
+{
+  //! Last opened sound. Only used by the streaming thread.
+  drwav_handle source;
+
+  std::atomic<sound_stream_voice*> ready{};
+
+  ~sound_stream_handoff()
+  {
+    if (auto v = ready.exchange(nullptr, std::memory_order_acquire))
+      v->retired.store(true, std::memory_order_release);
+  }
+};
+
+struct sound_stream_request
+{
+  std::shared_ptr<sound_stream_handoff> target;
+
+  //! Empty to reopen the previous sound, e.g. with another look-ahead
+  drwav_handle handle;
+  int64_t lookahead{};
+  sound_stream_loop loop;
+  uint64_t id{};
+};
+}
+
+/**
+ * @brief Background thread decoding the streamed sounds ahead of playback
+ *
+ * It owns the voices: they are freed there once their reader retires
+ * them, so that the audio thread never frees nor waits for it.
+ */
+class sound_streamer
+{
+public:
+  static sound_streamer& instance()
+  {
+    static sound_streamer s;
+    return s;
+  }
+
+  ~sound_streamer()
+  {
+    m_running = false;
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  //! Starts streaming a voice. Locks: not for the audio thread.
+  void add(std::shared_ptr<detail::sound_stream_voice> v)
+  {
+    std::lock_guard l{m_mutex};
+    m_voices.push_back(std::move(v));
+  }
+
+  //! Asks for a voice to be created in the streaming thread, then handed
+  //! to the target. Does not lock.
+  void request(detail::sound_stream_request&& req)
+  {
+    m_requests.enqueue(std::move(req));
+  }
+
+private:
+  sound_streamer()
+  {
+    m_thread = std::thread{[this] { run(); }};
+  }
+
+  void prepare(detail::sound_stream_request& req)
+  {
+    auto& target = *req.target;
+    if (req.handle)
+      target.source = std::move(req.handle);
+
+    auto v = detail::sound_stream_voice::create(
+        target.source, req.lookahead, req.loop);
+    if (!v)
+      return;
+
+    v->request = req.id;
+    auto ptr = v.get();
+    add(std::move(v));
+
+    // A voice that was not picked up in time is replaced
+    if (auto old = target.ready.exchange(ptr, std::memory_order_acq_rel))
+      old->retired.store(true, std::memory_order_release);
+  }
+
+  void run()
+  {
+    while (m_running)
+    {
+      detail::sound_stream_request req;
+      while (m_requests.try_dequeue(req))
+      {
+        prepare(req);
+        req = {};
+      }
+
+      bool busy = false;
+      {
+        std::lock_guard l{m_mutex};
+        ossia::remove_erase_if(m_voices, [](const auto& v) {
+          return v->retired.load(std::memory_order_acquire);
+        });
+        for (auto& v : m_voices)
+          if (!v->resident)
+            busy |= v->service();
+      }
+
+      if (!busy)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+
+  std::mutex m_mutex;
+  std::vector<std::shared_ptr<detail::sound_stream_voice>> m_voices;
+  moodycamel::ConcurrentQueue<detail::sound_stream_request> m_requests;
+  std::atomic_bool m_running{true};
+  std::thread m_thread;
+};
+
+/**
+ * @brief Reads a memory-mapped sound through a look-ahead buffer
+ *
+ * The sound is decoded ahead of the playback position by the
+ * sound_streamer thread, into a buffer of `lookahead` frames:
+ * the audio thread only copies from this buffer and never touches the
+ * mapped file, which may not be in memory.
+ *
+ * Reading a frame outside of the buffer, or changing the loop, starts
+ * decoding from there; the frames that are not decoded yet are silent
+ * and counted as underruns. seek() should be called as soon as the
+ * playback position is known to jump, e.g. on transport.
+ *
+ * Sounds shorter than the look-ahead window are decoded once when opened.
+ * Otherwise, the beginning of the playback is decoded when opening with
+ * the given loop: reading from frame 0 with it does not underrun.
+ *
+ * open() decodes in the calling thread and must not be called from the
+ * audio thread; open_async() and reopen() only post a request to the
+ * sound_streamer thread, and the sound starts playing once update() picks
+ * it up. These, close(), read() and seek() must always be called from the
+ * same thread.
+ */
+class sound_stream
+{
+public:
+  static constexpr int64_t default_lookahead = 1 << 16;
+
+  sound_stream()
+      : m_handoff{std::make_shared<detail::sound_stream_handoff>()}
+  {
+    // Starts the streaming thread now rather than from the audio thread
+    sound_streamer::instance();
+  }
+  sound_stream(const sound_stream&) = delete;
+  sound_stream(sound_stream&&) = delete;
+  sound_stream& operator=(const sound_stream&) = delete;
+  sound_stream& operator=(sound_stream&&) = delete;
+
+  ~sound_stream()
+  {
+    close();
+  }
+
+  void open(
+      const drwav_handle& hdl, const sound_stream_loop& loop = {},
+      int64_t lookahead = default_lookahead)
+  {
+    close();
+    auto v = detail::sound_stream_voice::create(hdl, lookahead, loop);
+    if (!v)
+      return;
+
+    v->request = m_request;
+    install(v.get());
+    sound_streamer::instance().add(std::move(v));
+  }
+
+  //! Opens the sound in the streaming thread. Until it is ready, the
+  //! stream is closed.
+  void open_async(
+      drwav_handle hdl, const sound_stream_loop& loop = {},
+      int64_t lookahead = default_lookahead)
+  {
+    close();
+    if (!hdl || hdl.channels() == 0 || hdl.totalPCMFrameCount() == 0)
+      return;
+
+    sound_streamer::instance().request(
+        {m_handoff, std::move(hdl), lookahead, loop, ++m_request});
+  }
+
+  //! Opens again the last sound given to open_async, e.g. with another
+  //! look-ahead. The current voice plays until the new one is ready.
+  void reopen(const sound_stream_loop& loop, int64_t lookahead)
+  {
+    sound_streamer::instance().request(
+        {m_handoff, {}, lookahead, loop, ++m_request});
+  }
+
+  //! Picks up the sound opened in the streaming thread, if any.
+  //! Returns true if a sound is open.
+  bool update() noexcept
+  {
+    if (auto v = m_handoff->ready.exchange(nullptr, std::memory_order_acq_rel))
+    {
+      if (v->request == m_request)
+      {
+        retire();
+        install(v);
+      }
+      else
+      {
+        // Superseded by a later request or by close()
+        v->retired.store(true, std::memory_order_release);
+      }
+    }
+    return m_voice != nullptr;
+  }
+
+  void close() noexcept
+  {
+    // Pending requests are ignored once they complete
+    ++m_request;
+    retire();
+  }
+
+  std::size_t channels() const noexcept
+  {
+    return m_voice ? m_voice->channels : 0;
+  }
+
+  //! True if the whole sound is in memory
+  bool resident() const noexcept
+  {
+    return m_voice && m_voice->resident;
+  }
+
+  //! Number of reads that could not be fully served from the buffer
+  uint64_t underruns() const noexcept
+  {
+    return m_voice ? m_voice->underruns.load(std::memory_order_relaxed) : 0;
+  }
+
+  //! Starts decoding from a playback position
+  void seek(int64_t frame, const sound_stream_loop& loop) noexcept
+  {
+    if (!m_voice || m_voice->resident)
+      return;
+
+    auto& v = *m_voice;
+    m_loop = loop;
+    m_consumed = frame;
+    m_target = frame;
+    m_generation++;
+
+    v.request_frame.store(frame, std::memory_order_relaxed);
+    v.request_offset.store(loop.start_offset, std::memory_order_relaxed);
+    v.request_duration.store(loop.loop_duration, std::memory_order_relaxed);
+    v.request_loops.store(loop.loops, std::memory_order_relaxed);
+    v.consumed.store(frame, std::memory_order_relaxed);
+    v.request_generation.store(m_generation, std::memory_order_release);
+  }
+
+  /**
+   * @brief Copies the frames [frame, frame + frames) of the playback
+   *
+   * out must have channels() channels of at least `frames` samples.
+   * @return the number of frames available; the others are silent.
+   */
+  int64_t read(
+      int64_t frame, int64_t frames, float** out,
+      const sound_stream_loop& loop) noexcept
+  {
+    if (frames <= 0)
+      return 0;
+    if (!m_voice)
+    {
+      silence(out, 0, frames);
+      return 0;
+    }
+
+    auto& v = *m_voice;
+    if (v.resident)
+    {
+      read_resident(frame, frames, out, loop);
+      return frames;
+    }
+
+    const bool ready
+        = v.ack_generation.load(std::memory_order_acquire) == m_generation;
+    const int64_t written
+        = ready ? v.written.load(std::memory_order_acquire) : m_target;
+
+    if (loop != m_loop || frame < m_consumed || frame >= written + v.capacity)
+    {
+      seek(frame, loop);
+      return underrun(out, 0, frames);
+    }
+
+    if (!ready)
+      return underrun(out, 0, frames);
+
+    const int64_t available = std::clamp<int64_t>(written - frame, 0, frames);
+    for (int c = 0; c < v.channels; c++)
+    {
+      const float* chan = v.buffer.data() + c * v.capacity;
+      const auto slot = v.slot(frame);
+      const auto first = std::min(available, v.capacity - slot);
+      std::copy_n(chan + slot, first, out[c]);
+      std::copy_n(chan, available - first, out[c] + first);
+    }
+
+    m_consumed = frame + available;
+    v.consumed.store(m_consumed, std::memory_order_release);
+
+    if (available < frames)
+      return underrun(out, available, frames);
+    return frames;
+  }
+
+private:
+  void install(detail::sound_stream_voice* v) noexcept
+  {
+    m_voice = v;
+    m_loop = v->loop;
+    m_consumed = 0;
+    m_target = 0;
+    m_generation = 0;
+  }
+
+  //! The streaming thread frees the voice once it sees this
+  void retire() noexcept
+  {
+    if (m_voice)
+    {
+      m_voice->retired.store(true, std::memory_order_release);
+      m_voice = nullptr;
+    }
+  }
+
+  void silence(float** out, int64_t from, int64_t to) const noexcept
+  {
+    const auto chans = m_voice ? m_voice->channels : 0;
+    for (int c = 0; c < chans; c++)
+      std::fill(out[c] + from, out[c] + to, 0.f);
+  }
+
+  int64_t underrun(float** out, int64_t from, int64_t to) noexcept
+  {
+    silence(out, from, to);
+    m_voice->underruns.fetch_add(1, std::memory_order_relaxed);
+    return from;
+  }
+
+  void read_resident(
+      int64_t frame, int64_t frames, float** out,
+      const sound_stream_loop& loop) const noexcept
+  {
+    const auto& v = *m_voice;
+    int64_t k = 0;
+    while (k < frames)
+    {
+      const auto [file_frame, run] = loop.map(frame + k, frames - k);
+      for (int64_t i = 0; i < run; i++)
+      {
+        const auto pos = file_frame + i;
+        const bool valid = pos >= 0 && pos < v.frames;
+        for (int c = 0; c < v.channels; c++)
+          out[c][k + i] = valid ? v.buffer[c * v.capacity + pos] : 0.f;
+      }
+      k += run;
+    }
+  }
+
+  std::shared_ptr<detail::sound_stream_handoff> m_handoff;
+  detail::sound_stream_voice* m_voice{};
+  uint64_t m_request{};
+
+  // Audio thread state
+  sound_stream_loop m_loop{};
+  int64_t m_consumed{};
+  int64_t m_target{};
+  uint32_t m_generation{};
+};
+}
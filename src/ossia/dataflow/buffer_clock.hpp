@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cinttypes>
+
+namespace ossia
+{
+/**
+ * @brief Dates the samples of the execution on the system clock
+ *
+ * Updated at the beginning of each audio buffer.
+ * Audio callbacks come with some jitter: the date of a buffer is predicted
+ * from the previous one and only follows the measured date slowly, unless
+ * the callback comes earlier than predicted or much later (e.g. after a
+ * transport jump or an xrun), in which case the clock is reset.
+ *
+ * A sample is dated one buffer after the start of its buffer,
+ * which leaves the time to compute the buffer.
+ */
+class buffer_clock
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  void begin_buffer(
+      int64_t sample, int64_t frames, int rate, clock::time_point now) noexcept
+  {
+    if (rate <= 0)
+      return;
+
+    const auto buffer_duration = to_duration(frames, rate);
+    if (valid() && rate == m_rate && sample >= m_sample)
+    {
+      const auto predicted = m_date + to_duration(sample - m_sample, m_rate);
+      const auto error = now - predicted;
+      if (error < clock::duration::zero() || error > 4 * buffer_duration)
+        m_date = now;
+      else
+        m_date = predicted + error / 16;
+    }
+    else
+    {
+      m_date = now;
+    }
+
+    m_sample = sample;
+    m_rate = rate;
+    m_latency = buffer_duration;
+  }
+
+  //! False until the first buffer
+  bool valid() const noexcept { return m_rate > 0; }
+
+  //! Date at which a sample should be heard
+  clock::time_point date(int64_t sample) const noexcept
+  {
+    return m_date + m_latency + to_duration(sample - m_sample, m_rate);
+  }
+
+private:
+  static clock::duration to_duration(int64_t samples, int rate) noexcept
+  {
+    using namespace std::chrono;
+    return duration_cast<clock::duration>(
+        duration<double>(double(samples) / double(rate)));
+  }
+
+  clock::time_point m_date{};
+  clock::duration m_latency{};
+  int64_t m_sample{};
+  int m_rate{};
+};
+}
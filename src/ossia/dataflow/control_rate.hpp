@@ -0,0 +1,100 @@
+#pragma once
+#include <ossia/dataflow/timed_value.hpp>
+#include <ossia/dataflow/token_request.hpp>
+#include <ossia/dataflow/value_vector.hpp>
+#include <ossia/network/value/value_conversion.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+
+/**
+ * \file control_rate.hpp
+ *
+ * Helpers for nodes which output control values more than once per tick.
+ *
+ * The values are written with the timestamp, in samples relative to
+ * the start of the buffer, at which they apply.
+ */
+namespace ossia
+{
+/**
+ * @brief Splits a tick in sub-blocks of \p rate samples.
+ *
+ * \p f is called once per sub-block with the timestamp of its last sample
+ * and the position, in the parent, at its end: the last call thus gets
+ * t.position(), at the last sample of the tick.
+ * With \p rate <= 0, \p f is called once for the whole tick, at its first
+ * sample, as the nodes without control rate do.
+ *
+ * @param tick_start First sample of the tick in the buffer
+ * @param samples Number of samples of the tick
+ */
+template <typename F>
+void for_each_control_block(
+    const ossia::token_request& t, int64_t tick_start, int64_t samples,
+    int rate, F&& f)
+{
+  if (rate <= 0 || samples <= rate || t.parent_duration.impl <= 0)
+  {
+    f(tick_start, t.position());
+    return;
+  }
+
+  const double start = t.prev_date.impl;
+  const double span = (t.date - t.prev_date).impl;
+  const double parent = t.parent_duration.impl;
+  for (int64_t k = 0; k < samples; k += rate)
+  {
+    const int64_t end = std::min<int64_t>(k + rate, samples);
+    const double date = start + span * (double(end) / samples);
+    f(tick_start + end - 1, date / parent);
+  }
+}
+
+/**
+ * @brief Renders timestamped control values into a per-sample buffer.
+ *
+ * Each value is reached on the sample of its timestamp, where
+ * for_each_control_block stamps it, with a linear ramp from the previous
+ * one; the last value is held until the end of the buffer.
+ * This removes the steps that a value per tick or per sub-block would
+ * cause in an audio signal.
+ *
+ * @param data Values ordered by timestamp
+ * @param out Buffer of \p samples values: out[i] is the sample first + i
+ * @param current Value at the end of the previous tick; updated
+ * @param map Applied to each value once converted to float
+ */
+template <typename Map>
+void render_control_buffer(
+    const ossia::value_vector<ossia::timed_value>& data, float* out,
+    int64_t first, int64_t samples, float& current, Map&& map)
+{
+  const int64_t last = first + samples;
+  int64_t pos = first;
+  for (const auto& tv : data)
+  {
+    if (!tv.value.valid())
+      continue;
+
+    const float target = map(ossia::convert<float>(tv.value));
+    const int64_t ts = std::min(std::max(tv.timestamp, first), last - 1);
+    if (ts >= pos)
+    {
+      const float step = (target - current) / float(ts - pos + 1);
+      for (int64_t i = 0; pos <= ts; ++pos, ++i)
+        out[pos - first] = current + step * float(i + 1);
+    }
+    current = target;
+  }
+
+  std::fill(out + (pos - first), out + samples, current);
+}
+
+inline void render_control_buffer(
+    const ossia::value_vector<ossia::timed_value>& data, float* out,
+    int64_t first, int64_t samples, float& current)
+{
+  render_control_buffer(data, out, first, samples, current, [](float f) { return f; });
+}
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/audio/audio_kernels.hpp>
 #include <ossia/dataflow/data.hpp>
 #include <ossia/detail/algorithms.hpp>
 #include <ossia/network/base/parameter.hpp>
@@ -65,12 +66,7 @@ void mix(const audio_vector& src_vec, audio_vector& sink_vec)
   {
     auto& src = src_vec[chan];
     auto& sink = sink_vec[chan];
-    const std::size_t N = src.size();
-    auto src_p = src.data();
-    auto sink_p = sink.data();
-
-    for (std::size_t i = 0; i < N; i++)
-      sink_p[i] += src_p[i];
+    audio_kernels::add(sink.data(), src.data(), src.size());
   }
 }
 
@@ -144,11 +140,10 @@ struct copy_data
     operator()(out.messages, in);
   }
 
-  void operator()(const value_vector<libremidi::message>& out, midi_port& in)
+  void operator()(const value_vector<midi_message>& out, midi_port& in)
   {
     // Called in copy_data_pos, when copying from a delay line to a port
-    for (const auto& data : out)
-      in.messages.push_back(data);
+    in.messages.insert(in.messages.end(), out.begin(), out.end());
   }
 
   void operator()(const midi_port& out, midi_delay_line& in)
@@ -70,6 +70,7 @@ struct global_pull_visitor
 {
   ossia::execution_state& state;
   const net::parameter_base& out;
+  int32_t slot{-1};
   void operator()(value_port& val) const
   {
     if (!val.is_event)
@@ -78,11 +79,10 @@ struct global_pull_visitor
     }
     else
     {
-      auto it = state.m_receivedValues.find(
-          const_cast<net::parameter_base*>(&out));
-      if (it != state.m_receivedValues.end())
+      auto received = state.received_values(out, slot);
+      if (received && !received->empty())
       {
-        copy_data{}(*it->first, it->second, val);
+        copy_data{}(out, *received, val);
       }
     }
   }
@@ -116,10 +116,8 @@ struct global_pull_visitor
     auto it = state.m_receivedMidi.find(midi);
     if (it != state.m_receivedMidi.end())
     {
-      for (const libremidi::message& v : it->second.second)
-      {
-        val.messages.push_back(v);
-      }
+      const auto& received = it->second.second;
+      val.messages.insert(val.messages.end(), received.begin(), received.end());
     }
   }
 
@@ -167,16 +165,14 @@ struct global_pull_node_visitor
     auto it = state.m_receivedMidi.find(midi);
     if (it != state.m_receivedMidi.end())
     {
+      const auto& received = it->second.second;
       if(channel == -1)
       {
-        for (const libremidi::message& v : it->second.second)
-        {
-          val.messages.push_back(v);
-        }
+        val.messages.insert(val.messages.end(), received.begin(), received.end());
       }
       else
       {
-        for (const libremidi::message& v : it->second.second)
+        for (const ossia::midi_message& v : received)
         {
           if(v.get_channel() == channel)
             val.messages.push_back(v);
@@ -230,17 +226,44 @@ void execution_state::unregister_device(net::device_base* d)
   }
 }
 
-void execution_state::register_parameter(net::parameter_base& p)
+int32_t execution_state::register_parameter(net::parameter_base& p)
 {
+  int32_t slot = -1;
+  auto it = m_receivedSlotIndex.find(&p);
+  if (it != m_receivedSlotIndex.end())
+  {
+    slot = it->second;
+    m_receivedSlots[slot].refcount++;
+  }
+  else
+  {
+    if (!m_freeReceivedSlots.empty())
+    {
+      slot = m_freeReceivedSlots.back();
+      m_freeReceivedSlots.pop_back();
+    }
+    else
+    {
+      slot = m_receivedSlots.size();
+      m_receivedSlots.emplace_back();
+    }
+
+    auto& s = m_receivedSlots[slot];
+    s.address = &p;
+    s.refcount = 1;
+    m_receivedSlotIndex.insert({&p, slot});
+  }
+
   auto device = &p.get_node().get_device();
   for (auto& q : m_valueQueues)
   {
     if (&q.device == device)
     {
-      q.reg(p);
+      q.reg(p, slot);
       break;
     }
   }
+  return slot;
 }
 
 void execution_state::unregister_parameter(net::parameter_base& p)
@@ -254,6 +277,36 @@ void execution_state::unregister_parameter(net::parameter_base& p)
       break;
     }
   }
+
+  auto it = m_receivedSlotIndex.find(&p);
+  if (it != m_receivedSlotIndex.end())
+  {
+    const int32_t slot = it->second;
+    auto& s = m_receivedSlots[slot];
+    if (--s.refcount <= 0)
+    {
+      // Values still in the queue for this parameter are dropped
+      // in get_new_values since the address does not match anymore.
+      s.address = nullptr;
+      s.values.clear();
+      m_freeReceivedSlots.push_back(slot);
+      m_receivedSlotIndex.erase(it);
+    }
+  }
+}
+
+const value_vector<ossia::value>* execution_state::received_values(
+    const net::parameter_base& p, int32_t slot) const noexcept
+{
+  if (slot >= 0 && slot < int32_t(m_receivedSlots.size())
+      && m_receivedSlots[slot].address == &p)
+    return &m_receivedSlots[slot].values;
+
+  // Inlets addressed by a path have one slot per matching parameter
+  auto it = m_receivedSlotIndex.find(const_cast<net::parameter_base*>(&p));
+  if (it != m_receivedSlotIndex.end())
+    return &m_receivedSlots[it->second].values;
+  return nullptr;
 }
 
 void execution_state::register_midi_parameter(net::midi::midi_protocol& p)
@@ -286,15 +339,27 @@ void execution_state::unregister_midi_parameter(net::midi::midi_protocol& p)
 
 void execution_state::get_new_values()
 {
-  for (auto it = m_receivedValues.begin(), end = m_receivedValues.end();
-       it != end; ++it)
-    it.value().clear();
+  for (int32_t slot : m_touchedReceivedSlots)
+    m_receivedSlots[slot].values.clear();
+  m_touchedReceivedSlots.clear();
 
+  const int32_t num_slots = m_receivedSlots.size();
   for (auto& mq : m_valueQueues)
   {
     ossia::received_value recv;
     while (mq.try_dequeue(recv))
-      m_receivedValues[recv.address].push_back(recv.value);
+    {
+      if (recv.slot < 0 || recv.slot >= num_slots)
+        continue;
+
+      auto& s = m_receivedSlots[recv.slot];
+      if (s.address != recv.address)
+        continue;
+
+      if (s.values.empty())
+        m_touchedReceivedSlots.push_back(recv.slot);
+      s.values.push_back(std::move(recv.value));
+    }
   }
 
   for (auto it = m_receivedMidi.begin(), end = m_receivedMidi.end(); it != end;
@@ -313,7 +378,7 @@ void execution_state::register_port(const inlet& port)
     {
       if (auto addr = port.address.target<ossia::net::parameter_base*>())
       {
-        register_parameter(**addr);
+        port.received_slot = register_parameter(**addr);
       }
       else if (auto p = port.address.target<ossia::traversal::path>())
       {
@@ -365,6 +430,7 @@ void execution_state::unregister_port(const inlet& port)
       if (auto addr = port.address.target<ossia::net::parameter_base*>())
       {
         unregister_parameter(**addr);
+        port.received_slot = -1;
       }
       else if (auto p = port.address.target<ossia::traversal::path>())
       {
@@ -439,6 +505,13 @@ void execution_state::begin_tick()
   apply_device_changes();
 }
 
+void execution_state::begin_buffer(std::size_t frames)
+{
+  m_bufferClock.begin_buffer(
+      samples_since_start, frames, sampleRate,
+      ossia::buffer_clock::clock::now());
+}
+
 void execution_state::clear_local_state()
 {
   m_msgIndex = 0;
@@ -458,7 +531,10 @@ void execution_state::reset()
   clear_local_state();
   clear_devices();
   m_valueQueues.clear();
-  m_receivedValues.clear();
+  m_receivedSlots.clear();
+  m_receivedSlotIndex.clear();
+  m_freeReceivedSlots.clear();
+  m_touchedReceivedSlots.clear();
   m_receivedMidi.clear();
 }
 
@@ -503,9 +579,21 @@ void execution_state::commit_common()
           &elt.first->get_node().get_device().get_protocol());
       if (proto)
       {
-        for (const auto& v : elt.second)
+        if (m_bufferClock.valid())
+        {
+          // Message timestamps are relative to the start of the tick
+          const int64_t tick_start = samples_since_start - bufferSize;
+          for (const auto& v : elt.second)
+          {
+            proto->push_value(v, m_bufferClock.date(tick_start + v.timestamp));
+          }
+        }
+        else
         {
-          proto->push_value(v);
+          for (const auto& v : elt.second)
+          {
+            proto->push_value(v);
+          }
         }
       }
       elt.second.clear();
@@ -708,7 +796,7 @@ void execution_state::copy_from_global(net::parameter_base& addr, inlet& in)
 {
   if (in.scope & port::scope_t::global)
   {
-    in.visit(global_pull_visitor{*this, addr});
+    in.visit(global_pull_visitor{*this, addr, in.received_slot});
   }
 }
 
@@ -917,7 +1005,7 @@ static bool is_in(
 static bool is_in(
     net::parameter_base& other,
     const ossia::fast_hash_map<
-        ossia::net::parameter_base*, value_vector<libremidi::message>>& container)
+        ossia::net::parameter_base*, value_vector<ossia::midi_message>>& container)
 {
   auto it = container.find(&other);
   if (it == container.end())
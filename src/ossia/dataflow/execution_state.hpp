@@ -1,5 +1,7 @@
 #pragma once
+#include <ossia/dataflow/buffer_clock.hpp>
 #include <ossia/dataflow/dataflow_fwd.hpp>
+#include <ossia/dataflow/midi_message.hpp>
 #include <ossia/dataflow/value_vector.hpp>
 #include <ossia/detail/flat_map.hpp>
 #include <ossia/detail/hash_map.hpp>
@@ -12,10 +14,6 @@
 
 #include <ossia/detail/lockfree_queue.hpp>
 
-#if defined(OSSIA_SMALL_VECTOR)
-#include <libremidi/message.hpp>
-#endif
-
 #include <cstdint>
 #if SIZE_MAX == 0xFFFFFFFF // 32-bit
 #include <ossia/dataflow/audio_port.hpp>
@@ -98,6 +96,11 @@ struct OSSIA_EXPORT execution_state : public Nano::Observer
 
   void begin_tick();
 
+  //! Called at the start of each audio buffer, before samples_since_start
+  //! is increased: MIDI output is then sent at the sample offset of each
+  //! message instead of all at once when committing.
+  void begin_buffer(std::size_t frames);
+
   void clear_devices();
   void reset();
   void commit();
@@ -149,7 +152,7 @@ struct OSSIA_EXPORT execution_state : public Nano::Observer
       m_valueState;
   ossia::fast_hash_map<ossia::audio_parameter*, audio_port> m_audioState;
   ossia::fast_hash_map<
-      ossia::net::parameter_base*, value_vector<libremidi::message>>
+      ossia::net::parameter_base*, value_vector<ossia::midi_message>>
       m_midiState;
 
   mutable shared_mutex_t mutex;
@@ -158,8 +161,10 @@ private:
   void get_new_values();
   void clear_local_state();
 
-  void register_parameter(ossia::net::parameter_base& p);
+  int32_t register_parameter(ossia::net::parameter_base& p);
   void unregister_parameter(ossia::net::parameter_base& p);
+  const value_vector<ossia::value>*
+  received_values(const ossia::net::parameter_base& p, int32_t slot) const noexcept;
   void register_midi_parameter(net::midi::midi_protocol& p);
   void unregister_midi_parameter(net::midi::midi_protocol& p);
   ossia::small_vector<ossia::net::device_base*, 4> m_devices_edit;
@@ -177,12 +182,27 @@ private:
 
   std::list<message_queue> m_valueQueues;
 
-  ossia::ptr_map<ossia::net::parameter_base*, value_vector<ossia::value>>
-      m_receivedValues;
+  // Values received for the parameters of event inlets.
+  // Each registered parameter gets a slot whose index does not change
+  // until it is unregistered, so that queued values and inlets do not
+  // have to look it up.
+  struct received_slot
+  {
+    ossia::net::parameter_base* address{};
+    value_vector<ossia::value> values;
+    int refcount{};
+  };
+  std::vector<received_slot> m_receivedSlots;
+  ossia::ptr_map<ossia::net::parameter_base*, int32_t> m_receivedSlotIndex;
+  std::vector<int32_t> m_freeReceivedSlots;
+  // Slots which received values during the current tick
+  std::vector<int32_t> m_touchedReceivedSlots;
   ossia::ptr_map<
-      ossia::net::midi::midi_protocol*, std::pair<int, value_vector<libremidi::message>>>
+      ossia::net::midi::midi_protocol*, std::pair<int, value_vector<ossia::midi_message>>>
       m_receivedMidi;
 
+  ossia::buffer_clock m_bufferClock;
+
   ossia::mono_state m_monoState;
   ossia::flat_vec_state m_commitOrderedState;
   ossia::flat_map<std::pair<int64_t, int>, std::vector<ossia::state_element>>
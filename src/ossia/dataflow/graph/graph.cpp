@@ -98,6 +98,8 @@ make_graph_par_impl(const ossia::graph_setup_options& opt)
 
     g->update_fun.logger = opt.log;
     g->update_fun.perf_map = opt.bench;
+    g->update_fun.set_executor_threads(
+        opt.parallel_threads, opt.pin_parallel_threads);
 
     return g;
   }
@@ -110,6 +112,8 @@ make_graph_par_impl(const ossia::graph_setup_options& opt)
 
     g->update_fun.logger = opt.log;
     g->update_fun.perf_map = opt.bench;
+    g->update_fun.set_executor_threads(
+        opt.parallel_threads, opt.pin_parallel_threads);
 
     return g;
   }
@@ -122,6 +126,8 @@ make_graph_par_impl(const ossia::graph_setup_options& opt)
 
     g->update_fun.logger = opt.log;
     g->update_fun.perf_map = opt.bench;
+    g->update_fun.set_executor_threads(
+        opt.parallel_threads, opt.pin_parallel_threads);
 
     return g;
   }
@@ -231,9 +237,9 @@ void graph_util::log_inputs(const graph_node& n, spdlog::logger& logger)
     }
     void operator()(const ossia::midi_port& p) const noexcept
     {
-      for (const libremidi::message& val : p.messages)
+      for (const ossia::midi_message& val : p.messages)
       {
-        switch (val.bytes.size())
+        switch (val.size())
         {
           case 1:
             logger.log(
@@ -285,9 +291,9 @@ void graph_util::log_outputs(const graph_node& n, spdlog::logger& logger)
     }
     void operator()(const ossia::midi_port& p) const noexcept
     {
-      for (const libremidi::message& val : p.messages)
+      for (const ossia::midi_message& val : p.messages)
       {
-        switch (val.bytes.size())
+        switch (val.size())
         {
           case 1:
             logger.log(
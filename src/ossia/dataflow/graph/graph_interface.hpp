@@ -59,6 +59,10 @@ struct graph_setup_options
   } merge{};
 
   bool parallel{};
+  //! Worker threads of the parallel graph, 0 for one per core
+  int parallel_threads{};
+  //! Pin each worker thread of the parallel graph to its own CPU
+  bool pin_parallel_threads{};
   std::shared_ptr<spdlog::logger> log{};
   std::shared_ptr<bench_map> bench{};
 };
@@ -1,14 +1,15 @@
 #pragma once
 #include <ossia/dataflow/graph_node.hpp>
-#include <ossia/detail/lockfree_queue.hpp>
 #include <ossia/detail/thread.hpp>
 #include <ossia/detail/fmt.hpp>
+#include <ossia/detail/work_stealing_deque.hpp>
 
-#include <boost/container/static_vector.hpp>
-
-#include <blockingconcurrentqueue.h>
-#include <concurrentqueue.h>
 #include <smallfun.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <vector>
 #define DISABLE_DONE_TASKS
@@ -33,6 +34,8 @@ public:
       : m_taskId {other.m_taskId}
       , m_dependencies {other.m_dependencies}
       , m_remaining_dependencies {other.m_remaining_dependencies.load()}
+      , m_cost {other.m_cost}
+      , m_priority {other.m_priority}
       , m_node {other.m_node}
       , m_precedes {std::move(other.m_precedes)}
 #if defined(CHECK_FOLLOWS)
@@ -50,6 +53,8 @@ public:
     m_taskId = other.m_taskId;
     m_dependencies = other.m_dependencies;
     m_remaining_dependencies = other.m_remaining_dependencies.load();
+    m_cost = other.m_cost;
+    m_priority = other.m_priority;
     m_node = other.m_node;
     m_precedes = std::move(other.m_precedes);
     other.m_precedes.clear();
@@ -73,6 +78,18 @@ public:
     other.m_dependencies++;
   }
 
+  //! Smoothed duration of the task, in nanoseconds; 0 if never measured
+  int64_t cost() const noexcept
+  {
+    return m_cost;
+  }
+
+  //! Length of the longest path from the start of this task to a sink
+  int64_t priority() const noexcept
+  {
+    return m_priority;
+  }
+
 private:
   friend class taskflow;
   friend class executor;
@@ -82,6 +99,9 @@ private:
   std::atomic_int m_remaining_dependencies {};
   std::atomic_bool m_executed {};
 
+  int64_t m_cost {};
+  int64_t m_priority {};
+
   ossia::graph_node* m_node {};
   ossia::small_pod_vector<int, 4> m_precedes;
 #if defined(CHECK_FOLLOWS)
@@ -95,11 +115,14 @@ public:
   void clear()
   {
     m_tasks.clear();
+    m_order.clear();
+    m_roots.clear();
   }
 
   void reserve(std::size_t sz)
   {
     m_tasks.reserve(sz);
+    m_order.reserve(sz);
   }
 
   task* emplace(ossia::graph_node& node)
@@ -110,40 +133,170 @@ public:
     return &last;
   }
 
+  //! Records a measured duration of a task, in nanoseconds
+  void set_cost(task& t, int64_t ns) noexcept
+  {
+    // Exponential moving average, so that a single late tick
+    // does not reorder the whole graph
+    t.m_cost = t.m_cost == 0 ? ns : (3 * t.m_cost + ns) / 4;
+  }
+
+  /**
+   * @brief Computes the priority of every task from their costs.
+   *
+   * The priority of a task is its cost plus the highest priority of
+   * its successors, that is the remaining critical path once it starts.
+   * Tasks which were never measured count as one nanosecond, so that
+   * the longest chains still go first.
+   *
+   * Must be called after the edges are added, and not during
+   * executor::run. Only the first call after a change of the graph
+   * allocates.
+   */
+  void update_priorities()
+  {
+    if (m_order.size() != m_tasks.size())
+      sort_topologically();
+
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it)
+    {
+      auto& t = m_tasks[*it];
+      int64_t next = 0;
+      for (int succ : t.m_precedes)
+        next = std::max(next, m_tasks[succ].m_priority);
+      t.m_priority = std::max<int64_t>(t.m_cost, 1) + next;
+    }
+
+    std::sort(m_roots.begin(), m_roots.end(), [this](int lhs, int rhs) {
+      const auto pl = m_tasks[lhs].m_priority;
+      const auto pr = m_tasks[rhs].m_priority;
+      return pl > pr || (pl == pr && lhs < rhs);
+    });
+  }
+
 private:
   friend class executor;
 
+  //! Kahn's algorithm; also collects the tasks without dependencies
+  void sort_topologically()
+  {
+    m_order.clear();
+    m_roots.clear();
+
+    std::vector<int> remaining;
+    remaining.reserve(m_tasks.size());
+    for (auto& t : m_tasks)
+    {
+      remaining.push_back(t.m_dependencies);
+      if (t.m_dependencies == 0)
+      {
+        m_order.push_back(t.m_taskId);
+        m_roots.push_back(t.m_taskId);
+      }
+    }
+
+    for (std::size_t i = 0; i < m_order.size(); i++)
+    {
+      for (int succ : m_tasks[m_order[i]].m_precedes)
+      {
+        if (--remaining[succ] == 0)
+          m_order.push_back(succ);
+      }
+    }
+  }
+
   std::vector<task> m_tasks;
+
+  //! Topological order of m_tasks
+  std::vector<int> m_order;
+
+  //! Tasks without dependencies, by decreasing priority
+  std::vector<int> m_roots;
 };
 
+/**
+ * @brief Work-stealing executor for a taskflow
+ *
+ * Every worker thread, and the thread calling run(), owns a deque
+ * of ready tasks. Tasks which become ready are pushed on the deque of the
+ * thread which finished their last dependency, and idle threads steal
+ * from the other deques.
+ *
+ * During a tick, idle workers spin for a short time before sleeping,
+ * so that they are available when more tasks become ready without paying
+ * for a wake-up; between ticks they sleep.
+ */
 class executor
 {
 public:
-  executor()
+  //! Time an idle worker keeps looking for tasks before sleeping
+  static constexpr std::chrono::microseconds default_spin_time{100};
+
+  //! The workers are started by start(), or by the first run() with
+  //! the default settings.
+  executor() = default;
+
+  executor(int threads, bool pin)
   {
+    start(threads, pin);
+  }
+
+  ~executor()
+  {
+    stop();
+  }
+
+  /**
+   * @brief Starts the worker threads
+   *
+   * @param threads Number of workers; 0 for one per core besides the
+   * one of the thread calling run().
+   * @param pin Whether each worker is pinned to its own CPU.
+   */
+  void start(int threads, bool pin)
+  {
+    if (threads <= 0)
+      threads = std::max(0, int(std::thread::hardware_concurrency()) - 1);
+
+    if (int(m_deques.size()) == threads + 1 && pin == m_pinned)
+      return;
+
+    stop();
+
+    m_deques.clear();
+    for (int i = 0; i <= threads; i++)
+      m_deques.push_back(std::make_unique<work_stealing_deque<task*>>());
+
     m_running = true;
-    for (auto& t : m_threads)
+    m_pinned = pin;
+    m_threads.reserve(threads);
+    for (int i = 1; i <= threads; i++)
     {
-      t = std::thread {[this] {
-        while (m_running)
-        {
-          task* t {};
-          if (m_tasks.wait_dequeue_timed(t, 100))
-          {
-            execute(*t);
-          }
-        }
-      }};
+      auto& t = m_threads.emplace_back([this, i] { worker_loop(i); });
+      if (pin)
+        ossia::set_thread_pinned(t, i);
     }
   }
 
-  ~executor()
+  void stop()
   {
     m_running = false;
+    wake_all();
     for (auto& t : m_threads)
     {
       t.join();
     }
+    m_threads.clear();
+  }
+
+  std::size_t thread_count() const noexcept
+  {
+    return m_threads.size();
+  }
+
+  void set_spin_time(std::chrono::microseconds t) noexcept
+  {
+    m_spinTime = t;
   }
 
   void set_task_executor(task_function f)
@@ -159,9 +312,16 @@ public:
       return;
     }
 
-    m_toDoTasks = tf.m_tasks.size();
+    if (m_deques.empty())
+      start(0, false);
+
+    m_toDoTasks.store(tf.m_tasks.size(), std::memory_order_relaxed);
     m_doneTasks.store(0, std::memory_order_relaxed);
 
+    // All the deques are empty at this point: the previous tick is over.
+    for (auto& deque : m_deques)
+      deque->reserve(tf.m_tasks.size());
+
     for (auto& task : tf.m_tasks)
     {
       task.m_remaining_dependencies.store(
@@ -172,60 +332,146 @@ public:
 #endif
     }
 
+    if (tf.m_order.size() != tf.m_tasks.size())
+      tf.update_priorities();
+
     std::atomic_thread_fence(std::memory_order_seq_cst);
 #if defined(DISABLE_DONE_TASKS)
     ossia::small_pod_vector<ossia::task*, 8> toCleanup;
 #endif
-    for (auto& task : tf.m_tasks)
+    // The roots are sorted by decreasing priority: thieves take them from
+    // the top of the deque, the most critical first.
+    auto& deque = *m_deques[0];
+    for (int taskId : tf.m_roots)
     {
-      if (task.m_dependencies == 0)
-      {
+      auto& task = tf.m_tasks[taskId];
 #if defined(DISABLE_DONE_TASKS)
-        if(task.m_node->enabled())
+      if(task.m_node->enabled())
 #endif
-        {
+      {
 #if defined(CHECK_EXEC_COUNTS)
-          m_checkVec[task.m_taskId]++;
-          if(m_checkVec[task.m_taskId] != 1)
-          {
-            fmt::print(stderr, "!!! task {} enqueued {}\n", task.m_taskId, m_checkVec[task.m_taskId]);
-            std::abort();
-          }
-          assert(task.m_dependencies == 0);
-#endif
-          std::atomic_thread_fence(std::memory_order_release);
-          m_tasks.enqueue(&task);
-        }
-#if defined(DISABLE_DONE_TASKS)
-        else
+        m_checkVec[task.m_taskId]++;
+        if(m_checkVec[task.m_taskId] != 1)
         {
-          toCleanup.push_back(&task);
+          fmt::print(stderr, "!!! task {} enqueued {}\n", task.m_taskId, m_checkVec[task.m_taskId]);
+          std::abort();
         }
+        assert(task.m_dependencies == 0);
 #endif
+        deque.push(&task);
       }
+#if defined(DISABLE_DONE_TASKS)
+      else
+      {
+        toCleanup.push_back(&task);
+      }
+#endif
     }
 
+    wake_all();
+
 #if defined(DISABLE_DONE_TASKS)
     for(auto& task : toCleanup)
     {
-      process_done(*task);
+      process_done(*task, 0);
     }
 #endif
 
-    while (m_doneTasks.load(std::memory_order_relaxed) != m_toDoTasks)
+    // This thread starts with the most critical root, too
+    if (task* t = deque.steal())
+      execute(*t, 0);
+
+    while (m_doneTasks.load(std::memory_order_acquire) != m_toDoTasks.load(std::memory_order_relaxed))
     {
-      task* t {};
-      if (m_tasks.wait_dequeue_timed(t, 1))
-      {
-        execute(*t);
-      }
+      if (task* t = find_task(0))
+        execute(*t, 0);
+      else
+        ossia::cpu_pause();
     }
 
     std::atomic_thread_fence(std::memory_order_seq_cst);
   }
 
 private:
-  void process_done(ossia::task& task)
+  void worker_loop(int idx)
+  {
+    uint64_t seen = m_generation.load();
+    while (m_running.load(std::memory_order_acquire))
+    {
+      work(idx);
+
+      std::unique_lock<std::mutex> lock{m_parkMutex};
+      m_parked.fetch_add(1);
+      m_parkCondition.wait(lock, [&] {
+        return m_generation.load() != seen || !m_running.load();
+      });
+      m_parked.fetch_sub(1);
+      seen = m_generation.load();
+    }
+  }
+
+  //! Runs tasks until the tick is over or nothing was found for m_spinTime
+  void work(int idx)
+  {
+    auto idle_start = std::chrono::steady_clock::now();
+    int spins = 0;
+    while (m_running.load(std::memory_order_relaxed))
+    {
+      if (task* t = find_task(idx))
+      {
+        execute(*t, idx);
+        idle_start = std::chrono::steady_clock::now();
+        spins = 0;
+        continue;
+      }
+
+      if (m_doneTasks.load(std::memory_order_relaxed) == m_toDoTasks.load(std::memory_order_relaxed))
+        return;
+
+      ossia::cpu_pause();
+      if ((++spins % 64) == 0 && std::chrono::steady_clock::now() - idle_start > m_spinTime)
+        return;
+    }
+  }
+
+  task* find_task(int idx) noexcept
+  {
+    if (task* t = m_deques[idx]->pop())
+      return t;
+
+    const int n = m_deques.size();
+    for (int k = 1; k < n; k++)
+    {
+      if (task* t = m_deques[(idx + k) % n]->steal())
+        return t;
+    }
+    return nullptr;
+  }
+
+  //! Wakes every sleeping worker, e.g. at the beginning of a tick
+  void wake_all()
+  {
+    m_generation.fetch_add(1);
+    if (m_parked.load() > 0)
+    {
+      { std::lock_guard<std::mutex> lock{m_parkMutex}; }
+      m_parkCondition.notify_all();
+    }
+  }
+
+  //! Wakes up to n sleeping workers, when tasks are made ready during a tick
+  void wake_some(int n)
+  {
+    m_generation.fetch_add(1);
+    if (const int parked = m_parked.load(); parked > 0)
+    {
+      { std::lock_guard<std::mutex> lock{m_parkMutex}; }
+      for (int i = 0, k = std::min(n, parked); i < k; i++)
+        m_parkCondition.notify_one();
+    }
+  }
+
+  void process_done(ossia::task& task, int idx)
   {
     if (task.m_executed.exchange(true))
       return;
@@ -234,6 +480,7 @@ private:
 #if defined(DISABLE_DONE_TASKS)
     ossia::small_pod_vector<ossia::task*, 8> toCleanup;
 #endif
+    ossia::small_pod_vector<ossia::task*, 8> ready;
     for (int taskId : task.m_precedes)
     {
       auto& nextTask = m_tf->m_tasks[taskId];
@@ -241,7 +488,7 @@ private:
 
       std::atomic_int& remaining = nextTask.m_remaining_dependencies;
       assert(remaining > 0);
-      const int rem = remaining.fetch_sub(1, std::memory_order_relaxed) - 1;
+      const int rem = remaining.fetch_sub(1, std::memory_order_acq_rel) - 1;
       assert(rem >= 0);
       if (rem == 0)
       {
@@ -257,8 +504,7 @@ private:
             std::abort();
           }
 #endif
-          std::atomic_thread_fence(std::memory_order_release);
-          m_tasks.enqueue(&nextTask);
+          ready.push_back(&nextTask);
         }
 #if defined(DISABLE_DONE_TASKS)
         else
@@ -269,17 +515,33 @@ private:
       }
     }
 
+    // The most critical task is pushed last: this thread pops it next,
+    // the others are for the sleepers
+    if (ready.size() > 1)
+    {
+      std::sort(ready.begin(), ready.end(), [](ossia::task* lhs, ossia::task* rhs) {
+        return lhs->m_priority < rhs->m_priority;
+      });
+    }
+
+    auto& deque = *m_deques[idx];
+    for (ossia::task* t : ready)
+      deque.push(t);
+
+    if (ready.size() > 1)
+      wake_some(ready.size() - 1);
+
 #if defined(DISABLE_DONE_TASKS)
     for(auto& clean : toCleanup)
     {
-      process_done(*clean);
+      process_done(*clean, idx);
     }
 #endif
 
-    this->m_doneTasks.fetch_add(1, std::memory_order_relaxed);
+    this->m_doneTasks.fetch_add(1, std::memory_order_release);
   }
 
-  void execute(task& task)
+  void execute(task& task, int idx)
   {
     std::atomic_thread_fence(std::memory_order_acquire);
     try
@@ -308,7 +570,7 @@ private:
     }
     std::atomic_thread_fence(std::memory_order_release);
 
-    process_done(task);
+    process_done(task, idx);
 #if defined(CHECK_EXEC_COUNTS)
     assert(m_checkVec[task.m_taskId] == 1);
 #endif
@@ -319,13 +581,21 @@ private:
   task_function m_func;
 
   std::atomic_bool m_running {};
+  bool m_pinned {};
+  std::chrono::microseconds m_spinTime {default_spin_time};
+
+  std::vector<std::thread> m_threads;
+  //! m_deques[0] is owned by the thread calling run(), m_deques[i] by m_threads[i-1]
+  std::vector<std::unique_ptr<work_stealing_deque<task*>>> m_deques;
 
-  std::array<std::thread, 8> m_threads;
   taskflow* m_tf {};
   std::atomic_size_t m_doneTasks = 0;
-  std::size_t m_toDoTasks = 0;
+  std::atomic_size_t m_toDoTasks = 0;
 
-  moodycamel::BlockingConcurrentQueue<task*> m_tasks;
+  std::mutex m_parkMutex;
+  std::condition_variable m_parkCondition;
+  std::atomic_int m_parked {};
+  std::atomic<uint64_t> m_generation {};
 
 #if defined(CHECK_EXEC_COUNTS)
   std::array<std::atomic_int, 5000> m_checkVec;
@@ -350,6 +620,12 @@ public:
   {
   }
 
+  //! \see executor::start
+  void set_executor_threads(int threads, bool pin)
+  {
+    executor.start(threads, pin);
+  }
+
   void update_graph(ossia::node_map& nodes, const std::vector<graph_node*>& topo_order, ossia::graph_t& graph)
   {
     flow_nodes.clear();
@@ -357,34 +633,23 @@ public:
 
     flow_graph.reserve(nodes.size());
 
-    if (logger)
+    // The durations of the nodes are always measured, as they give
+    // the priorities of the tasks.
+    // They go in the user's bench map if there is one.
+    costs.clear();
+    costs.measure = true;
+    bench_map& perf = perf_map ? *perf_map : costs;
+    for (auto node : topo_order)
     {
-      if (perf_map)
-      {
-        executor.set_task_executor(node_exec_logger_bench{cur_state, *perf_map, *logger});
-        for (auto node : topo_order)
-        {
-          (*perf_map)[node] = std::nullopt;
-          flow_nodes[node] = flow_graph.emplace(*node);
-        }
-      }
-      else
-      {
-        executor.set_task_executor(node_exec_logger{cur_state, *logger});
-        for (auto node : topo_order)
-        {
-          flow_nodes[node] = flow_graph.emplace(*node);
-        }
-      }
+      perf[node] = std::nullopt;
+      flow_nodes[node] = flow_graph.emplace(*node);
     }
+
+    if (logger)
+      executor.set_task_executor(node_exec_logger_bench{cur_state, perf, *logger});
     else
-    {
-      executor.set_task_executor(node_exec{cur_state});
-      for (auto node : topo_order)
-      {
-        flow_nodes[node] = flow_graph.emplace(*node);
-      }
-    }
+      executor.set_task_executor(node_exec_bench{cur_state, perf});
+    ticks = 0;
 
     for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei)
     {
@@ -396,6 +661,20 @@ public:
       auto& receiver = flow_nodes[n1.get()];
       sender->precede(*receiver);
     }
+
+    flow_graph.update_priorities();
+  }
+
+  //! Feeds the last measured durations to the task priorities
+  void update_priorities()
+  {
+    const bench_map& perf = perf_map ? *perf_map : costs;
+    for (auto& [node, task] : flow_nodes)
+    {
+      if (auto it = perf.find(node); it != perf.end() && it->second)
+        flow_graph.set_cost(*task, *it->second);
+    }
+    flow_graph.update_priorities();
   }
 
   template <typename Graph_T, typename DevicesT>
@@ -414,10 +693,17 @@ private:
   ossia::taskflow flow_graph;
   ossia::executor executor;
   ossia::fast_hash_map<graph_node*, ossia::task*> flow_nodes;
+
+  //! Durations of the nodes when there is no user bench map
+  bench_map costs;
+  int ticks{};
 };
 
 struct custom_parallel_exec
 {
+  //! Number of ticks between two updates of the task priorities
+  static constexpr int priority_update_period = 16;
+
   template <typename Graph_T>
   custom_parallel_exec(Graph_T&)
   {
@@ -429,6 +715,12 @@ struct custom_parallel_exec
       const std::vector<ossia::graph_node*>&)
   {
     self.cur_state = &e;
+
+    // Priorities do not need to follow every tick:
+    // node durations only change when their parameters do.
+    if ((++self.ticks % priority_update_period) == 0)
+      self.update_priorities();
+
     self.executor.run(self.flow_graph);
   }
 };
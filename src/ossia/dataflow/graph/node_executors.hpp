@@ -47,6 +47,11 @@ struct node_exec_bench
         perf[&node] = 0;
       }
     }
+    else if (node.enabled())
+    {
+      assert(graph_util::can_execute(node, *g));
+      graph_util::exec_node(node, *g);
+    }
   }
   catch(...)
   {
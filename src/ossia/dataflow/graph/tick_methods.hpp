@@ -95,9 +95,11 @@ struct tick_all_nodes
   void operator()(unsigned long samples, double) const
   {
     std::atomic_thread_fence(std::memory_order_seq_cst);
+    e.begin_buffer(samples);
     e.begin_tick();
     const time_value old_date{e.samples_since_start};
     e.samples_since_start += samples;
+    e.bufferSize = (int)samples;
     const time_value new_date{e.samples_since_start};
 
     // TODO tempo / sig ?
@@ -131,6 +133,7 @@ struct buffer_tick
 #endif
 
     std::atomic_thread_fence(std::memory_order_seq_cst);
+    st.begin_buffer(frameCount);
     st.begin_tick();
     st.samples_since_start += frameCount;
     st.bufferSize = (int)frameCount;
@@ -194,6 +197,7 @@ struct precise_score_tick
   void operator()(unsigned long frameCount, double seconds)
   {
     std::atomic_thread_fence(std::memory_order_seq_cst);
+    st.begin_buffer(frameCount);
     st.bufferSize = 1;
     st.cur_date = seconds * 1e9;
     for (std::size_t i = 0; i < frameCount; i++)
@@ -0,0 +1,145 @@
+#pragma once
+#include <libremidi/message.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+
+namespace ossia
+{
+/**
+ * @brief A MIDI message of at most three bytes, stored inline
+ *
+ * This is the message type of the MIDI ports and of the execution state:
+ * unlike libremidi::message, creating or copying one never allocates.
+ * System exclusive messages do not fit and are not carried.
+ */
+struct midi_message
+{
+  using message_type = libremidi::message_type;
+  static constexpr std::size_t max_size = 3;
+
+  std::array<uint8_t, max_size> bytes{};
+  uint8_t count{};
+
+  // Sample offset in the current tick
+  int64_t timestamp{};
+
+  constexpr midi_message() noexcept = default;
+  constexpr midi_message(uint8_t b0) noexcept
+      : bytes{b0, 0, 0}, count{1}
+  {
+  }
+  constexpr midi_message(uint8_t b0, uint8_t b1) noexcept
+      : bytes{b0, b1, 0}, count{2}
+  {
+  }
+  constexpr midi_message(uint8_t b0, uint8_t b1, uint8_t b2) noexcept
+      : bytes{b0, b1, b2}, count{3}
+  {
+  }
+
+  //! Returns false and leaves the message unchanged if it does not fit.
+  bool assign(const uint8_t* data, std::size_t n) noexcept
+  {
+    if (n == 0 || n > max_size)
+      return false;
+    bytes = {};
+    std::copy_n(data, n, bytes.begin());
+    count = uint8_t(n);
+    return true;
+  }
+
+  constexpr std::size_t size() const noexcept { return count; }
+  constexpr bool empty() const noexcept { return count == 0; }
+
+  constexpr uint8_t& operator[](std::size_t i) noexcept { return bytes[i]; }
+  constexpr uint8_t operator[](std::size_t i) const noexcept { return bytes[i]; }
+
+  constexpr const uint8_t* begin() const noexcept { return bytes.data(); }
+  constexpr const uint8_t* end() const noexcept { return bytes.data() + count; }
+
+  //! Same semantics as libremidi::message::get_channel: 1 to 16, 0 if empty.
+  constexpr int get_channel() const noexcept
+  {
+    return count > 0 ? (bytes[0] & 0x0F) + 1 : 0;
+  }
+
+  constexpr message_type get_message_type() const noexcept
+  {
+    if (bytes[0] >= uint8_t(message_type::SYSTEM_EXCLUSIVE))
+      return message_type(bytes[0]);
+    return message_type(bytes[0] & 0xF0);
+  }
+
+  friend constexpr bool
+  operator==(const midi_message& lhs, const midi_message& rhs) noexcept
+  {
+    return lhs.count == rhs.count && lhs.bytes == rhs.bytes
+           && lhs.timestamp == rhs.timestamp;
+  }
+  friend constexpr bool
+  operator!=(const midi_message& lhs, const midi_message& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  static constexpr midi_message
+  note_on(uint8_t channel, uint8_t note, uint8_t velocity) noexcept
+  {
+    return {make_command(message_type::NOTE_ON, channel), note, velocity};
+  }
+
+  static constexpr midi_message
+  note_off(uint8_t channel, uint8_t note, uint8_t velocity) noexcept
+  {
+    return {make_command(message_type::NOTE_OFF, channel), note, velocity};
+  }
+
+  static constexpr midi_message
+  control_change(uint8_t channel, uint8_t control, uint8_t value) noexcept
+  {
+    return {make_command(message_type::CONTROL_CHANGE, channel), control, value};
+  }
+
+  static constexpr midi_message
+  program_change(uint8_t channel, uint8_t value) noexcept
+  {
+    return {make_command(message_type::PROGRAM_CHANGE, channel), value};
+  }
+
+  static constexpr midi_message pitch_bend(uint8_t channel, int value) noexcept
+  {
+    return {
+        make_command(message_type::PITCH_BEND, channel), uint8_t(value & 0x7F),
+        uint8_t((value >> 7) & 0x7F)};
+  }
+
+  static constexpr midi_message
+  pitch_bend(uint8_t channel, uint8_t lsb, uint8_t msb) noexcept
+  {
+    return {make_command(message_type::PITCH_BEND, channel), lsb, msb};
+  }
+
+  static constexpr midi_message
+  poly_pressure(uint8_t channel, uint8_t note, uint8_t value) noexcept
+  {
+    return {make_command(message_type::POLY_PRESSURE, channel), note, value};
+  }
+
+  static constexpr midi_message
+  aftertouch(uint8_t channel, uint8_t value) noexcept
+  {
+    return {make_command(message_type::AFTERTOUCH, channel), value};
+  }
+
+private:
+  // Channels go from 1 to 16
+  static constexpr uint8_t
+  make_command(const message_type type, const int channel) noexcept
+  {
+    return uint8_t(uint8_t(type) | (std::clamp(channel, 1, 16) - 1));
+  }
+};
+}
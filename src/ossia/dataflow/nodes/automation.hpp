@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/dataflow/control_rate.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 #include <ossia/dataflow/node_process.hpp>
 #include <ossia/dataflow/port.hpp>
@@ -34,6 +35,8 @@ namespace ossia::nodes
  * happens. The target domain is taken from the driven parameter_base.
  * The unit is stored in m_lastMessage.unit.
  *
+ * By default a single value is written per tick. With \ref set_control_rate,
+ * one value is written every N samples, timestamped within the tick.
  *
  * \see \ref behavior \ref curve \ref curve_segment
  */
@@ -64,6 +67,12 @@ public:
     m_drive.reset();
   }
 
+  //! Samples between two output values; 0 for one value per tick
+  void set_control_rate(int samples) noexcept
+  {
+    m_controlRate = samples;
+  }
+
 private:
   void
   run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override
@@ -71,18 +80,24 @@ private:
     if (!m_drive)
       return;
     const auto tick_start = e.physical_start(t);
+    const auto samples = t.physical_write_duration(e.modelToSamples());
 
     ossia::value_port& vp = *value_out;
-    vp.write_value(
-        ossia::apply(
-            ossia::detail::compute_value_visitor{t.position(),
-                                                 ossia::val_type::FLOAT},
-            m_drive),
-        tick_start);
+    ossia::for_each_control_block(
+        t, tick_start, samples, m_controlRate,
+        [&](int64_t timestamp, double position) {
+          vp.write_value(
+              ossia::apply(
+                  ossia::detail::compute_value_visitor{position,
+                                                       ossia::val_type::FLOAT},
+                  m_drive),
+              timestamp);
+        });
   }
 
   ossia::behavior m_drive;
   ossia::value_outlet value_out;
+  int m_controlRate{};
 };
 
 class float_automation final : public ossia::nonowning_graph_node
@@ -112,18 +127,30 @@ public:
     m_drive.reset();
   }
 
+  //! \see automation::set_control_rate
+  void set_control_rate(int samples) noexcept
+  {
+    m_controlRate = samples;
+  }
+
 private:
   void
   run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override
   {
     const auto tick_start = e.physical_start(t);
+    const auto samples = t.physical_write_duration(e.modelToSamples());
 
     ossia::value_port& vp = *value_out;
-    vp.write_value(m_drive.value_at(t.position()), tick_start);
+    ossia::for_each_control_block(
+        t, tick_start, samples, m_controlRate,
+        [&](int64_t timestamp, double position) {
+          vp.write_value(m_drive.value_at(position), timestamp);
+        });
   }
 
   ossia::curve<double, float> m_drive;
   ossia::minmax_float_outlet value_out;
+  int m_controlRate{};
 };
 class automation_process final : public ossia::node_process
 {
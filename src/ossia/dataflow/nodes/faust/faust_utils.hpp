@@ -248,6 +248,11 @@ struct faust_node_utils
       }
     }
 
+    duplicate_mono(n_out, audio_out);
+  }
+
+  static void duplicate_mono(int64_t n_out, ossia::audio_port& audio_out)
+  {
     // TODO handle multichannel cleanly
     if (n_out == 1)
     {
@@ -256,12 +261,54 @@ struct faust_node_utils
     }
   }
 
+  // When the ports and the dsp use the same sample type (OSSIA_AUDIO_FLOAT),
+  // the dsp reads and writes the ports directly instead of copies of them.
+  static constexpr bool in_place = std::is_same_v<FAUSTFLOAT, ossia::audio_port_sample>;
+
+  template <typename Node, typename Sample>
+  static void prepare_in_place(
+      Node& self, int64_t d, int64_t n_in, int64_t n_out, Sample* inputs_,
+      Sample** input_n, Sample** output_n, const ossia::audio_port& audio_in,
+      ossia::audio_port& audio_out)
+  {
+    // TODO offset !!!
+    for (int64_t i = 0; i < n_in; i++)
+    {
+      const int64_t n
+          = int64_t(audio_in.samples.size()) > i ? audio_in.samples[i].size() : 0;
+      if (n >= d)
+      {
+        // The dsp does not write to its inputs
+        const Sample* chan = audio_in.samples[i].data();
+        input_n[i] = const_cast<Sample*>(chan);
+      }
+      else
+      {
+        // Missing or incomplete channel: completed with silence in a copy
+        input_n[i] = inputs_ + i * d;
+        if (n > 0)
+          std::copy_n(audio_in.samples[i].data(), n, input_n[i]);
+        std::fill(input_n[i] + n, input_n[i] + d, Sample{});
+      }
+    }
+
+    audio_out.samples.resize(n_out);
+    for (int64_t i = 0; i < n_out; i++)
+    {
+      auto& chan = audio_out.samples[i];
+      chan.resize(d);
+      std::fill(chan.begin(), chan.end(), Sample{});
+      Sample* out = chan.data();
+      output_n[i] = out;
+    }
+  }
+
   template <typename Node, typename Dsp>
   static void copy_midi(Node& self, Dsp& dsp, const ossia::midi_port& midi_in)
   {
     // TODO offset !!!
 
-    for(const libremidi::message& mess : midi_in.messages)
+    for(const ossia::midi_message& mess : midi_in.messages)
     {
       switch(mess.get_message_type())
       {
@@ -307,17 +354,26 @@ struct faust_node_utils
       const int64_t n_out = dsp.getNumOutputs();
 
       float* inputs_ = (float*)alloca(n_in * d * sizeof(float));
-      float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
 
       float** input_n = (float**)alloca(sizeof(float*) * n_in);
       float** output_n = (float**)alloca(sizeof(float*) * n_out);
 
       copy_controls(self);
 
-      copy_input(self, d, n_in, inputs_, input_n, audio_in);
-      init_output(self, d, n_out, outputs_, output_n);
-      dsp.compute(d, input_n, output_n);
-      copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      if constexpr (in_place)
+      {
+        prepare_in_place(self, d, n_in, n_out, inputs_, input_n, output_n, audio_in, audio_out);
+        dsp.compute(d, input_n, output_n);
+        duplicate_mono(n_out, audio_out);
+      }
+      else
+      {
+        float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
+        copy_input(self, d, n_in, inputs_, input_n, audio_in);
+        init_output(self, d, n_out, outputs_, output_n);
+        dsp.compute(d, input_n, output_n);
+        copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      }
 
       copy_displays(self, st);
     }
@@ -340,7 +396,6 @@ struct faust_node_utils
       const int64_t n_out = dsp.getNumOutputs();
 
       float* inputs_ = (float*)alloca(n_in * d * sizeof(float));
-      float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
 
       float** input_n = (float**)alloca(sizeof(float*) * n_in);
       float** output_n = (float**)alloca(sizeof(float*) * n_out);
@@ -350,10 +405,20 @@ struct faust_node_utils
 
       copy_midi(self, dsp, midi_in);
 
-      copy_input(self, d, n_in, inputs_, input_n, audio_in);
-      init_output(self, d, n_out, outputs_, output_n);
-      dsp.compute(d, input_n, output_n);
-      copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      if constexpr (in_place)
+      {
+        prepare_in_place(self, d, n_in, n_out, inputs_, input_n, output_n, audio_in, audio_out);
+        dsp.compute(d, input_n, output_n);
+        duplicate_mono(n_out, audio_out);
+      }
+      else
+      {
+        float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
+        copy_input(self, d, n_in, inputs_, input_n, audio_in);
+        init_output(self, d, n_out, outputs_, output_n);
+        dsp.compute(d, input_n, output_n);
+        copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      }
 
       copy_displays(self, st);
     }
@@ -1,7 +1,11 @@
 #pragma once
+#include <ossia/audio/audio_kernels.hpp>
+#include <ossia/dataflow/control_rate.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 #include <ossia/dataflow/port.hpp>
 
+#include <array>
+
 namespace ossia::nodes
 {
 
@@ -21,14 +25,6 @@ public:
   void
   run(const ossia::token_request& t, ossia::exec_state_facade st) noexcept override
   {
-    auto& vals = gain_in.target<ossia::value_port>()->get_data();
-    if (!vals.empty())
-      gain = ossia::clamp(
-          ossia::linear{
-              ossia::decibel{ossia::convert<float>(vals.back().value)}}
-              .dataspace_value,
-          0.f, 1.f);
-
     auto& in = audio_in->samples;
     auto& out = audio_out->samples;
 
@@ -37,6 +33,31 @@ public:
     const int64_t first_pos = t.physical_start(st.modelToSamples());
     const int64_t last_pos = first_pos + N;
 
+    // Several values in a tick come from a sample-accurate source:
+    // follow them sample by sample instead of jumping to the last one.
+    // The gains are rendered relative to the tick start, in a buffer
+    // preallocated with the node; longer ticks jump to the last value.
+    auto& vals = gain_in.target<ossia::value_port>()->get_data();
+    const bool dense = vals.size() > 1 && N <= int64_t(m_gains.size());
+    if (dense)
+    {
+      float cur = gain;
+      ossia::render_control_buffer(
+          vals, m_gains.data(), first_pos, N, cur, [](float db) {
+            return ossia::clamp(
+                ossia::linear{ossia::decibel{db}}.dataspace_value, 0.f, 1.f);
+          });
+      gain = cur;
+    }
+    else if (!vals.empty())
+    {
+      gain = ossia::clamp(
+          ossia::linear{
+              ossia::decibel{ossia::convert<float>(vals.back().value)}}
+              .dataspace_value,
+          0.f, 1.f);
+    }
+
     const auto channels = in.size();
     out.resize(channels);
 
@@ -48,23 +69,25 @@ public:
 
       const auto* input = in[i].data();
       auto* output = out[i].data();
-      if (cur_chan_size < last_pos)
+      const int64_t end = std::min(cur_chan_size, last_pos);
+      if (end > first_pos)
       {
-        for (int64_t j = first_pos; j < cur_chan_size; j++)
-          output[j] = gain * input[j];
-
-        for (int64_t j = cur_chan_size; j < last_pos; j++)
-          output[j] = 0.;
-      }
-      else
-      {
-        for (int64_t j = first_pos; j < last_pos; j++)
-          out[i][j] = gain * input[j];
+        if (dense)
+          audio_kernels::multiply(
+              output + first_pos, input + first_pos, m_gains.data(),
+              end - first_pos);
+        else
+          audio_kernels::scale(
+              output + first_pos, input + first_pos, gain, end - first_pos);
       }
+
+      for (int64_t j = std::max(end, first_pos); j < last_pos; j++)
+        output[j] = 0.;
     }
   }
 
 private:
+  std::array<float, 4096> m_gains;
   ossia::audio_inlet audio_in;
   ossia::value_inlet gain_in;
   ossia::audio_outlet audio_out;
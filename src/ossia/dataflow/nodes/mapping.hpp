@@ -43,6 +43,17 @@ public:
     m_drive = b;
   }
 
+  /**
+   * @brief Samples between two output values.
+   *
+   * When the input has several values in the same sub-block of this size,
+   * only the last one is mapped. 0 maps every input value.
+   */
+  void set_control_rate(int samples) noexcept
+  {
+    m_controlRate = samples;
+  }
+
 private:
   void
   run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override
@@ -53,21 +64,30 @@ private:
     const ossia::value_port& ip = *value_in;
     ossia::value_port& op = *value_out;
 
+    const auto& data = ip.get_data();
+    const std::size_t n = data.size();
+
     // TODO use correct unit / whatever ?
-    for (auto& tv : ip.get_data())
+    for (std::size_t i = 0; i < n; i++)
     {
-      if (tv.value.valid())
-      {
-        auto v = ossia::apply(
-            ossia::detail::mapper_compute_visitor{}, tv.value, m_drive.v);
+      auto& tv = data[i];
+      if (!tv.value.valid())
+        continue;
+
+      if (m_controlRate > 0 && i + 1 < n && data[i + 1].value.valid()
+          && data[i + 1].timestamp / m_controlRate == tv.timestamp / m_controlRate)
+        continue;
+
+      auto v = ossia::apply(
+          ossia::detail::mapper_compute_visitor{}, tv.value, m_drive.v);
 
-        op.write_value(std::move(v), tv.timestamp);
-      }
+      op.write_value(std::move(v), tv.timestamp);
     }
   }
 
   ossia::behavior m_drive;
   ossia::value_inlet value_in;
   ossia::value_outlet value_out;
+  int m_controlRate{};
 };
 }
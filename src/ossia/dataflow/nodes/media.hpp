@@ -1,13 +1,21 @@
 #pragma once
 
 #include <memory>
+#include <ossia/detail/config.hpp>
 #include <ossia/detail/small_vector.hpp>
 #include <ossia/detail/span.hpp>
 
 namespace ossia
 {
-// Used in nodes
-using audio_channel = ossia::small_pod_vector<double, 256>;
+// Used in nodes.
+// With OSSIA_AUDIO_FLOAT the ports use the sample type of the audio APIs
+// and of the sound files, which removes the conversions at each end.
+#if defined(OSSIA_AUDIO_FLOAT)
+using audio_port_sample = float;
+#else
+using audio_port_sample = double;
+#endif
+using audio_channel = ossia::small_pod_vector<audio_port_sample, 256>;
 using audio_vector = ossia::small_vector<audio_channel, 2>;
 
 
@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <ossia/audio/audio_kernels.hpp>
 #include <ossia/dataflow/node_process.hpp>
 #include <ossia/dataflow/port.hpp>
 #include <ossia/detail/pod_vector.hpp>
@@ -135,13 +136,11 @@ inline void read_f32(ossia::mutable_audio_span<float>& ap, void* data, int64_t s
   const auto channels = ap.size();
   auto d = reinterpret_cast<float*>(data);
 
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j] = d[j * channels + i];
-    }
-  }
+  float** dst = (float**)alloca(sizeof(float*) * channels);
+  for (std::size_t i = 0; i < channels; i++)
+    dst[i] = ap[i].data();
+
+  audio_kernels::deinterleave(dst, d, channels, samples);
 }
 
 inline void read_f64(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
@@ -1,6 +1,7 @@
 #pragma once
 #include <ossia/audio/audio_parameter.hpp>
 #include <ossia/audio/drwav_handle.hpp>
+#include <ossia/audio/sound_stream.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 #include <ossia/dataflow/port.hpp>
 #include <ossia/dataflow/nodes/sound.hpp>
@@ -35,67 +36,56 @@ public:
     upmix = v;
   }
 
+  //! The sound is opened by the streaming thread: it plays once ready()
   void set_sound(drwav_handle hdl)
   {
-    using namespace snd;
-    m_handle = std::move(hdl);
-    if(m_handle)
+    if(hdl)
     {
-      switch(m_handle.translatedFormatTag())
-      {
-        case DR_WAVE_FORMAT_PCM:
-        {
-          switch(m_handle.bitsPerSample())
-          {
-            case 8:
-              m_converter = read_u8;
-              break;
-            case 16:
-              m_converter = read_s16;
-              break;
-            case 24:
-              m_converter = read_s24;
-              break;
-            case 32:
-              m_converter = read_s32;
-              break;
-          }
-          break;
-        }
-        case DR_WAVE_FORMAT_IEEE_FLOAT:
-        {
-          switch(m_handle.bitsPerSample())
-          {
-            case 32:
-              m_converter = read_f32;
-              break;
-            case 64:
-              m_converter = read_f64;
-              break;
-          }
-          break;
-        }
-        default:
-          m_converter = nullptr;
-          break;
-      }
+      m_channels = hdl.channels();
+      m_frames = hdl.totalPCMFrameCount();
+      m_rate = hdl.sampleRate();
+    }
+    else
+    {
+      m_channels = 0;
+      m_frames = 0;
+      m_rate = 0;
     }
+    m_stream.open_async(std::move(hdl), loop_info(), m_lookahead);
+  }
+
+  //! Number of frames decoded ahead of the playback
+  void set_lookahead(int64_t frames)
+  {
+    m_lookahead = frames;
+    if(m_channels)
+      m_stream.reopen(loop_info(), m_lookahead);
+  }
+
+  //! True once the sound given to set_sound can be played
+  bool ready() noexcept
+  {
+    return m_stream.update();
+  }
+
+  //! Buffers for which the sound was not decoded in time
+  uint64_t underruns() const noexcept
+  {
+    return m_stream.underruns();
   }
 
   void transport(time_value date) override
   {
-    m_resampler.transport(to_sample(date, m_handle.sampleRate()));
+    const auto sample = to_sample(date, m_rate);
+    m_resampler.transport(sample);
+    m_stream.seek(sample, loop_info());
   }
 
   void fetch_audio(int64_t start, int64_t samples_to_write, double** audio_array_base) noexcept
   {
     const int channels = this->channels();
-    const int file_duration = this->duration();
 
     m_resampleBuffer.resize(channels);
-    for(auto& buf : m_resampleBuffer)
-      buf.resize(samples_to_write);
-
     float** audio_array = (float**)alloca(sizeof(float*) * channels);
     for(int i = 0; i < channels; i++)
     {
@@ -103,83 +93,7 @@ public:
       audio_array[i] = m_resampleBuffer[i].data();
     }
 
-    ossia::mutable_audio_span<float> source(channels);
-
-    double* frame_data{};
-    if(samples_to_write * channels > 10000)
-    {
-      m_safetyBuffer.resize(samples_to_write * channels);
-      frame_data = m_safetyBuffer.data();
-      // TODO detect if we happen to be in this case often, and if so, garbage collect at some point
-    }
-    else
-    {
-      frame_data = (double*) alloca(sizeof(double) * samples_to_write * channels);
-    }
-
-    if(m_loops)
-    {
-      for(int k = 0; k < samples_to_write; k++)
-      {
-        // TODO add a special case if [0; samples_to_write] don't loop around
-        int pos =  this->m_start_offset_samples + ((start + k) % this->m_loop_duration_samples);
-        if(pos >= file_duration)
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-          continue;
-        }
-
-        const bool ok = this->m_handle.seek_to_pcm_frame(pos);
-        if(!ok)
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-          continue;
-        }
-
-        const int max = 1;
-        const auto count = this->m_handle.read_pcm_frames(max, frame_data);
-        if(count >= 0)
-        {
-          for(int i = 0; i < channels; i++)
-            source[i] = gsl::span(audio_array[i] + k, count);
-          m_converter(source, frame_data, count);
-        }
-        else
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-        }
-      }
-    }
-    else
-    {
-      for(int i = 0; i < channels; i++)
-      {
-        source[i] = gsl::span(audio_array[i], samples_to_write);
-      }
-
-      bool ok = start + m_start_offset_samples < file_duration;
-      if(ok)
-        ok &= this->m_handle.seek_to_pcm_frame(start + m_start_offset_samples);
-
-      if(ok)
-      {
-        const auto count = this->m_handle.read_pcm_frames(samples_to_write, frame_data);
-        m_converter(source, frame_data, count);
-        for(int i = 0; i < channels; i++)
-          for(int k = count; k < samples_to_write; k++)
-            audio_array[i][k] = 0;
-      }
-      else
-      {
-        for(int i = 0; i < channels; i++)
-          for(int k = 0; k < samples_to_write; k++)
-            audio_array[i][k] = 0;
-        return;
-      }
-    }
+    m_stream.read(start, samples_to_write, audio_array, loop_info());
 
     for(int i = 0; i < channels; i++)
       std::copy_n(audio_array[i], samples_to_write, audio_array_base[i]);
@@ -187,95 +101,21 @@ public:
 
   void fetch_audio(int64_t start, int64_t samples_to_write, float** audio_array) noexcept
   {
-    const int channels = this->channels();
-    const int file_duration = this->duration();
-
-    ossia::mutable_audio_span<float> source(channels);
-
-    double* frame_data{};
-    if(samples_to_write * channels > 10000)
-    {
-      m_safetyBuffer.resize(samples_to_write * channels);
-      frame_data = m_safetyBuffer.data();
-      // TODO detect if we happen to be in this case often, and if so, garbage collect at some point
-    }
-    else
-    {
-      frame_data = (double*) alloca(sizeof(double) * samples_to_write * channels);
-    }
-
-    if(m_loops)
-    {
-      for(int k = 0; k < samples_to_write; k++)
-      {
-        // TODO add a special case if [0; samples_to_write] don't loop around
-        int pos =  this->m_start_offset_samples + ((start + k) % this->m_loop_duration_samples);
-        if(pos >= file_duration)
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-          continue;
-        }
-
-        const bool ok = this->m_handle.seek_to_pcm_frame(pos);
-        if(!ok)
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-          continue;
-        }
-
-        const int max = 1;
-        const auto count = this->m_handle.read_pcm_frames(max, frame_data);
-        if(count >= 0)
-        {
-          for(int i = 0; i < channels; i++)
-            source[i] = gsl::span(audio_array[i] + k, count);
-          m_converter(source, frame_data, count);
-        }
-        else
-        {
-          for(int i = 0; i < channels; i++)
-            audio_array[i][k] = 0;
-        }
-      }
-    }
-    else
-    {
-      for(int i = 0; i < channels; i++)
-      {
-        source[i] = gsl::span(audio_array[i], samples_to_write);
-      }
-
-      const bool ok = this->m_handle.seek_to_pcm_frame(start + m_start_offset_samples);
-      if(!ok)
-      {
-        for(int i = 0; i < channels; i++)
-          for(int k = 0; k < samples_to_write; k++)
-            audio_array[i][k] = 0;
-        return;
-      }
-
-      const auto count = this->m_handle.read_pcm_frames(samples_to_write, frame_data);
-      m_converter(source, frame_data, count);
-      for(int i = 0; i < channels; i++)
-        for(int k = count; k < samples_to_write; k++)
-          audio_array[i][k] = 0;
-    }
+    m_stream.read(start, samples_to_write, audio_array, loop_info());
   }
 
   void
   run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override
   {
-    if(!m_handle || !m_converter)
+    if(!ready())
       return;
 
     // TODO do the backwards play head
     if(!t.forward())
       return;
 
-    const auto channels = m_handle.channels();
-    const auto len = m_handle.totalPCMFrameCount();
+    const auto channels = m_channels;
+    const auto len = m_frames;
 
     ossia::audio_port& ap = *audio_out;
     ap.samples.resize(channels);
@@ -328,24 +168,32 @@ public:
 
   std::size_t channels() const
   {
-    return m_handle ? m_handle.channels() : 0;
+    return m_channels;
   }
   std::size_t duration() const
   {
-    return m_handle ? m_handle.totalPCMFrameCount(): 0;
+    return m_frames;
   }
 
 private:
-  drwav_handle m_handle{};
+  ossia::sound_stream_loop loop_info() const noexcept
+  {
+    return {m_start_offset_samples, m_loop_duration_samples, m_loops};
+  }
+
+  // The handle itself is owned by the streaming thread
+  std::size_t m_channels{};
+  std::size_t m_frames{};
+  uint32_t m_rate{};
+
+  ossia::sound_stream m_stream;
+  int64_t m_lookahead{ossia::sound_stream::default_lookahead};
 
   ossia::audio_outlet audio_out;
 
   std::size_t start{};
   std::size_t upmix{};
 
-  using read_fn_t = void(*)(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples);
-  read_fn_t m_converter{};
-  std::vector<double> m_safetyBuffer;
   std::vector<std::vector<float>> m_resampleBuffer;
 };
 
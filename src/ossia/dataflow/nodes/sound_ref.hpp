@@ -1,4 +1,6 @@
 #pragma once
+#include <ossia/audio/audio_kernels.hpp>
+#include <ossia/audio/sample_cache.hpp>
 #include <ossia/dataflow/nodes/sound.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 
@@ -40,7 +42,9 @@ public:
   {
     m_handle = std::make_shared<audio_data>();
     m_handle->data = std::move(data);
+    m_sample.reset();
     m_data.clear();
+    m_data16.clear();
     {
       m_dataSampleRate = 44100;
       m_data.assign(m_handle->data.begin(), m_handle->data.end());
@@ -51,7 +55,9 @@ public:
   void set_sound(const audio_handle& hdl, int channels, int sampleRate)
   {
     m_handle = hdl;
+    m_sample.reset();
     m_data.clear();
+    m_data16.clear();
     if (hdl)
     {
       m_dataSampleRate = sampleRate;
@@ -59,16 +65,45 @@ public:
     }
   }
 
+  //! Plays a sound shared through the sample_cache
+  void set_sound(const sample_handle& hdl)
+  {
+    m_handle.reset();
+    m_sample = hdl;
+    m_data.clear();
+    m_data16.clear();
+    if (hdl)
+    {
+      m_dataSampleRate = hdl->rate();
+      for (std::size_t i = 0; i < hdl->channels(); i++)
+      {
+        if (hdl->format() == sample_format::int16)
+          m_data16.push_back(hdl->s16(i));
+        else
+          m_data.push_back(hdl->f32(i));
+      }
+    }
+  }
+
   template<typename T>
   void fetch_audio(int64_t start, int64_t samples_to_write, T** audio_array) const noexcept
   {
-    const int channels = this->channels();
-    const int file_duration = this->duration();
+    if (!m_data16.empty())
+      fetch_audio(m_data16, start, samples_to_write, audio_array);
+    else
+      fetch_audio(m_data, start, samples_to_write, audio_array);
+  }
+
+  template<typename S, typename T>
+  void fetch_audio(const audio_span<S>& data, int64_t start, int64_t samples_to_write, T** audio_array) const noexcept
+  {
+    const int channels = data.size();
+    const int file_duration = data.empty() ? 0 : data[0].size();
     if(m_loops)
     {
       for(int i = 0; i < channels; i++)
       {
-        auto& src = m_data[i];
+        auto& src = data[i];
         T* dst = audio_array[i];
 
         // TODO add a special case if [0; samples_to_write] don't loop around
@@ -76,7 +111,7 @@ public:
         {
           int pos =  m_start_offset_samples + ((start + k) % m_loop_duration_samples);
           if(pos < file_duration)
-            dst[k] = src[pos];
+            dst[k] = read_sample(src[pos]);
           else
             dst[k] = 0;
         }
@@ -86,16 +121,23 @@ public:
     {
       for(int i = 0; i < channels; i++)
       {
-        const auto& src = m_data[i];
+        const auto& src = data[i];
         T* dst = audio_array[i];
 
         if(file_duration >= start + samples_to_write + m_start_offset_samples)
         {
-          for(int k = 0, pos = start + m_start_offset_samples;
-              k < samples_to_write;
-              k++, pos++)
+          const S* src_p = src.data() + start + m_start_offset_samples;
+          if constexpr(std::is_same_v<S, int16_t>)
           {
-            dst[k] = src[pos];
+            std::transform(src_p, src_p + samples_to_write, dst, sample_from_s16);
+          }
+          else if constexpr(std::is_same_v<T, double>)
+          {
+            audio_kernels::convert(dst, src_p, samples_to_write);
+          }
+          else
+          {
+            std::copy_n(src_p, samples_to_write, dst);
           }
         }
         else
@@ -105,7 +147,7 @@ public:
               k < max;
               k++, pos++)
           {
-            dst[k] = src[pos];
+            dst[k] = read_sample(src[pos]);
           }
           for(int k = max; k < samples_to_write; k++)
           {
@@ -119,15 +161,15 @@ public:
   void
   run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override
   {
-    if (m_data.empty())
+    if (channels() == 0)
       return;
 
     // TODO do the backwards play head
     if(!t.forward())
       return;
 
-    const std::size_t chan = m_data.size();
-    const std::size_t len = m_data[0].size();
+    const std::size_t chan = channels();
+    const std::size_t len = duration();
     ossia::audio_port& ap = *audio_out;
     ap.samples.resize(chan);
 
@@ -177,15 +219,21 @@ public:
 
   std::size_t channels() const
   {
-    return m_data.size();
+    return m_data16.empty() ? m_data.size() : m_data16.size();
   }
   std::size_t duration() const
   {
+    if (!m_data16.empty())
+      return m_data16[0].size();
     return m_data.empty() ? 0 : m_data[0].size();
   }
 
 private:
+  static float read_sample(float f) noexcept { return f; }
+  static float read_sample(int16_t i) noexcept { return sample_from_s16(i); }
+
   audio_span<float> m_data;
+  audio_span<int16_t> m_data16;
   ossia::audio_outlet audio_out;
 
   std::size_t start{};
@@ -193,6 +241,7 @@ private:
 
   std::size_t m_dataSampleRate{};
   audio_handle m_handle{};
+  sample_handle m_sample{};
 };
 }
 
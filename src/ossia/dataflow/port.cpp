@@ -1,6 +1,7 @@
 // This is an open source non-commercial project. Dear PVS-Studio, please check
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
+#include <ossia/audio/audio_kernels.hpp>
 #include <ossia/audio/audio_parameter.hpp>
 #include <ossia/dataflow/dataflow.hpp>
 #include <ossia/dataflow/execution_state.hpp>
@@ -237,13 +238,7 @@ void process_audio_out_mono(ossia::audio_port& i, ossia::audio_outlet& audio_out
   ensure_vector_sizes(i.samples, audio_out.data.samples);
 
   const auto N = i.samples[0].size();
-  const auto i_ptr = i.samples[0].data();
-  const auto o_ptr  = o.samples[0].data();
-
-  for(std::size_t sample = 0; sample < N; sample++)
-  {
-    o_ptr[sample] = i_ptr[sample] * g;
-  }
+  audio_kernels::scale(o.samples[0].data(), i.samples[0].data(), g, N);
 }
 
 void process_audio_out_general(ossia::audio_port& i, ossia::audio_outlet& audio_out)
@@ -267,17 +262,11 @@ void process_audio_out_general(ossia::audio_port& i, ossia::audio_outlet& audio_
     const auto vol = audio_out.pan[chan] * g;
     if(vol == 1.)
     {
-      for(std::size_t sample = 0; sample < N; sample++)
-      {
-        o_ptr[sample] = i_ptr[sample];
-      }
+      std::copy_n(i_ptr, N, o_ptr);
     }
     else
     {
-      for(std::size_t sample = 0; sample < N; sample++)
-      {
-        o_ptr[sample] = i_ptr[sample] * vol;
-      }
+      audio_kernels::scale(o_ptr, i_ptr, vol, N);
     }
   }
 }
@@ -292,11 +281,7 @@ void process_audio_out_mono(ossia::audio_outlet& audio_out)
 
   const auto N = o.samples[0].size();
   const auto o_ptr  = o.samples[0].data();
-
-  for(std::size_t sample = 0; sample < N; sample++)
-  {
-    o_ptr[sample] *= g;
-  }
+  audio_kernels::scale(o_ptr, o_ptr, g, N);
 }
 
 void process_audio_out_general(ossia::audio_outlet& audio_out)
@@ -317,10 +302,7 @@ void process_audio_out_general(ossia::audio_outlet& audio_out)
     const auto vol = audio_out.pan[chan] * g;
     if(vol == 1.)
       continue;
-    for(std::size_t sample = 0; sample < N; sample++)
-    {
-      o_ptr[sample] *= vol;
-    }
+    audio_kernels::scale(o_ptr, o_ptr, vol, N);
   }
 }
 
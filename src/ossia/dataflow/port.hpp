@@ -89,6 +89,10 @@ public:
   ossia::small_vector<graph_edge*, 2> sources;
   ossia::small_vector<value_inlet*, 2> child_inlets;
 
+  //! Index of the values received for address in the execution_state,
+  //! set by execution_state::register_port for event inlets.
+  mutable int32_t received_slot{-1};
+
   friend struct audio_inlet;
   friend struct value_inlet;
   friend struct midi_inlet;
@@ -1,9 +1,14 @@
 #pragma once
 #include <ossia/detail/config.hpp>
+#include <ossia/detail/rcu.hpp>
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 /**
  * \file callback_container.hpp
@@ -39,43 +44,105 @@ template <typename T>
  *
  * This allows to cleanly stop listening when there are no callbacks.
  *
+ * The callbacks are stored in an immutable array which is copied and
+ * swapped when callbacks are added or removed: \ref send does not lock
+ * and can run concurrently with modifications.
+ * Once remove_callback returns, the removed callback is not being called
+ * by another thread anymore: the container counts its own running sends,
+ * so that removing only waits for the sends of this container.
  */
 class callback_container
 {
 public:
+  /**
+   * @brief impl How the callbacks are stored.
+   *
+   * The callbacks are contiguous; ids identify them independently of
+   * their position, so that removals do not invalidate other iterators.
+   */
+  struct impl
+  {
+    std::vector<T> callbacks;
+    std::vector<uint64_t> ids;
+  };
+
+  /**
+   * @brief Handle to a callback, to save in order to be able to remove it.
+   */
+  struct iterator
+  {
+    uint64_t id{};
+
+    friend bool operator==(iterator lhs, iterator rhs) noexcept
+    {
+      return lhs.id == rhs.id;
+    }
+    friend bool operator!=(iterator lhs, iterator rhs) noexcept
+    {
+      return lhs.id != rhs.id;
+    }
+  };
+
   callback_container() = default;
   callback_container(const callback_container& other)
   {
     std::lock_guard<std::mutex> lck{other.m_mutx};
-    m_callbacks = other.m_callbacks;
+    if (auto cbs = other.m_callbacks.load(std::memory_order_relaxed))
+      m_callbacks.store(new impl{*cbs}, std::memory_order_relaxed);
+    m_next_id = other.m_next_id;
   }
   callback_container(callback_container&& other) noexcept
   {
     std::lock_guard<std::mutex> lck{other.m_mutx};
-    m_callbacks = std::move(other.m_callbacks);
+    m_callbacks.store(
+        other.m_callbacks.exchange(nullptr, std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    m_next_id = other.m_next_id;
   }
   callback_container& operator=(const callback_container& other)
   {
-    std::lock_guard<std::mutex> lck{other.m_mutx};
-    m_callbacks = other.m_callbacks;
+    if (this != &other)
+    {
+      impl* cbs{};
+      {
+        std::lock_guard<std::mutex> lck{other.m_mutx};
+        if (auto other_cbs = other.m_callbacks.load(std::memory_order_relaxed))
+          cbs = new impl{*other_cbs};
+      }
+      impl* old{};
+      {
+        std::lock_guard<std::mutex> lck{m_mutx};
+        old = publish(cbs);
+        m_next_id = std::max(m_next_id, other.m_next_id);
+      }
+      ossia::rcu::retire(old);
+    }
     return *this;
   }
   callback_container& operator=(callback_container&& other) noexcept
   {
-    std::lock_guard<std::mutex> lck{other.m_mutx};
-    m_callbacks = std::move(other.m_callbacks);
+    if (this != &other)
+    {
+      impl* cbs{};
+      {
+        std::lock_guard<std::mutex> lck{other.m_mutx};
+        cbs = other.m_callbacks.exchange(nullptr, std::memory_order_relaxed);
+      }
+      impl* old{};
+      {
+        std::lock_guard<std::mutex> lck{m_mutx};
+        old = publish(cbs);
+        m_next_id = std::max(m_next_id, other.m_next_id);
+      }
+      ossia::rcu::retire(old);
+    }
     return *this;
   }
 
-  virtual ~callback_container() = default;
-
-  /**
-   * @brief impl How the callbackas are stored.
-   * A list is used since iterators to other callbacks
-   * must not be invalidated upon removal.
-   */
-  using impl = typename std::list<T>;
-  using iterator = typename impl::iterator;
+  virtual ~callback_container()
+  {
+    ossia::rcu::retire(m_callbacks.load(std::memory_order_relaxed));
+  }
 
   /**
    * @brief add_callback Add a new callback.
@@ -84,55 +151,108 @@ public:
    */
   iterator add_callback(T callback)
   {
-    T cb = callback;
-    if (cb)
+    if (!callback)
+      throw invalid_callback_error{};
+
+    std::unique_lock<std::mutex> lck{m_mutx};
+    const iterator it{++m_next_id};
+
+    auto cbs = new impl;
+    if (auto cur = m_callbacks.load(std::memory_order_relaxed))
     {
-      std::lock_guard<std::mutex> lck{m_mutx};
-      auto it = m_callbacks.insert(m_callbacks.begin(), std::move(cb));
-      if (m_callbacks.size() == 1)
-        on_first_callback_added();
-      return it;
+      const auto n = cur->callbacks.size() + 1;
+      cbs->callbacks.reserve(n);
+      cbs->ids.reserve(n);
+      cbs->callbacks.push_back(std::move(callback));
+      cbs->ids.push_back(it.id);
+      cbs->callbacks.insert(
+          cbs->callbacks.end(), cur->callbacks.begin(), cur->callbacks.end());
+      cbs->ids.insert(cbs->ids.end(), cur->ids.begin(), cur->ids.end());
     }
     else
     {
-      throw invalid_callback_error{};
+      cbs->callbacks.push_back(std::move(callback));
+      cbs->ids.push_back(it.id);
     }
+
+    auto old = publish(cbs);
+    if (cbs->callbacks.size() == 1)
+      on_first_callback_added();
+    lck.unlock();
+
+    ossia::rcu::retire(old);
+    return it;
   }
 
   /**
    * @brief remove_callback Removes a callback identified by an iterator.
    * @param it Iterator to remove.
+   *
+   * Waits for the sends of this container that may still be calling the
+   * callback in other threads, unless called from a callback: the removed
+   * callback may then still be running elsewhere until they return.
    */
   void remove_callback(iterator it)
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    if (m_callbacks.size() == 1)
-      on_removing_last_callback();
-    m_callbacks.erase(it);
-  }
+    impl* old{};
+    {
+      std::lock_guard<std::mutex> lck{m_mutx};
+      auto cur = m_callbacks.load(std::memory_order_relaxed);
+      if (!cur)
+        return;
+
+      if (cur->callbacks.size() == 1 && cur->ids.front() == it.id)
+        on_removing_last_callback();
 
+      old = m_callbacks.exchange(without(*cur, it), std::memory_order_seq_cst);
+    }
+
+    wait_for_senders();
+    ossia::rcu::retire(old);
+  }
 
   /**
    * @brief Replaces an existing callback with another function.
    */
   void replace_callback(iterator it, T&& cb)
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    *m_callbacks.erase(it, it) = std::move(cb);
+    impl* old{};
+    {
+      std::lock_guard<std::mutex> lck{m_mutx};
+      auto cur = m_callbacks.load(std::memory_order_relaxed);
+      if (!cur)
+        return;
+
+      auto cbs = new impl{*cur};
+      for (std::size_t i = 0, n = cbs->ids.size(); i < n; i++)
+      {
+        if (cbs->ids[i] == it.id)
+        {
+          cbs->callbacks[i] = std::move(cb);
+          break;
+        }
+      }
+      old = publish(cbs);
+    }
+    ossia::rcu::retire(old);
   }
+
   void replace_callbacks(impl&& cbs)
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    m_callbacks = std::move(cbs);
+    impl* old{};
+    {
+      std::lock_guard<std::mutex> lck{m_mutx};
+      old = publish(cbs.callbacks.empty() ? nullptr : new impl{std::move(cbs)});
+    }
+    ossia::rcu::retire(old);
   }
 
   class disabled_callback
   {
   public:
     explicit disabled_callback(callback_container& self)
-      : self{self}, old_callbacks{self.m_callbacks}
+        : self{self}, old_callbacks{self.copy_callbacks()}
     {
-
     }
 
     ~disabled_callback()
@@ -147,12 +267,17 @@ public:
 
   disabled_callback disable_callback(iterator it)
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
+    std::unique_lock<std::mutex> lck{m_mutx};
     disabled_callback dis{*this};
 
     // TODO should we also call on_removing_last_blah ?
     // I don't think so : it's supposed to be a short operation
-    m_callbacks.erase(it);
+    impl* old{};
+    if (auto cur = m_callbacks.load(std::memory_order_relaxed))
+      old = publish(without(*cur, it));
+    lck.unlock();
+
+    ossia::rcu::retire(old);
     return dis;
   }
 
@@ -162,8 +287,16 @@ public:
    */
   std::size_t callback_count() const
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    return m_callbacks.size();
+    ossia::rcu::read_guard guard;
+    if (!guard)
+    {
+      std::lock_guard<std::mutex> lck{m_mutx};
+      auto cbs = m_callbacks.load(std::memory_order_acquire);
+      return cbs ? cbs->callbacks.size() : 0;
+    }
+
+    auto cbs = m_callbacks.load(std::memory_order_acquire);
+    return cbs ? cbs->callbacks.size() : 0;
   }
 
   /**
@@ -172,8 +305,7 @@ public:
    */
   bool callbacks_empty() const
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    return m_callbacks.empty();
+    return m_callbacks.load(std::memory_order_acquire) == nullptr;
   }
 
   /**
@@ -183,12 +315,23 @@ public:
   template <typename... Args>
   void send(Args&&... args)
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    for (auto& callback : m_callbacks)
+    ossia::rcu::read_guard guard;
+    if (!guard)
     {
-      if (callback)
-        callback(std::forward<Args>(args)...);
+      // No reader slot left for this thread
+      std::lock_guard<std::mutex> lck{m_mutx};
+      if (auto cbs = m_callbacks.load(std::memory_order_acquire))
+        for (auto& callback : cbs->callbacks)
+          if (callback)
+            callback(args...);
+      return;
     }
+
+    sender_guard sending{*this};
+    if (auto cbs = m_callbacks.load(std::memory_order_seq_cst))
+      for (auto& callback : cbs->callbacks)
+        if (callback)
+          callback(args...);
   }
 
   /**
@@ -196,10 +339,19 @@ public:
    */
   void callbacks_clear()
   {
-    std::lock_guard<std::mutex> lck{m_mutx};
-    if (!m_callbacks.empty())
-      on_removing_last_callback();
-    m_callbacks.clear();
+    impl* old{};
+    {
+      std::lock_guard<std::mutex> lck{m_mutx};
+      if (m_callbacks.load(std::memory_order_relaxed))
+        on_removing_last_callback();
+      old = m_callbacks.exchange(nullptr, std::memory_order_seq_cst);
+    }
+
+    if (old)
+    {
+      wait_for_senders();
+      ossia::rcu::retire(old);
+    }
   }
 
 protected:
@@ -227,7 +379,90 @@ protected:
   }
 
 private:
-  impl m_callbacks;
+  //! Counts a running send in the current phase of the container.
+  struct sender_guard
+  {
+    explicit sender_guard(callback_container& self) noexcept
+        : counter{self.m_senders[self.m_phase.load(std::memory_order_seq_cst)]}
+    {
+      counter.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    ~sender_guard()
+    {
+      counter.fetch_sub(1, std::memory_order_release);
+    }
+
+    sender_guard(const sender_guard&) = delete;
+    sender_guard& operator=(const sender_guard&) = delete;
+
+    std::atomic<uint32_t>& counter;
+  };
+
+  /**
+   * Waits until the sends which may have loaded a replaced array are done.
+   *
+   * Sends which start after the phase is flipped count in the other
+   * counter, and see the new array: they cannot delay the removal.
+   * Inside a callback this thread would wait for itself, or for a thread
+   * waiting for it: the caller then only retires the array.
+   */
+  void wait_for_senders() noexcept
+  {
+    if (auto slot = ossia::rcu::this_thread_slot();
+        slot && slot->epoch.load(std::memory_order_relaxed) != 0)
+      return;
+
+    std::lock_guard<std::mutex> lck{m_sync};
+    const auto phase = m_phase.load(std::memory_order_relaxed);
+    m_phase.store(phase ^ 1, std::memory_order_seq_cst);
+    while (m_senders[phase].load(std::memory_order_acquire) != 0)
+      std::this_thread::yield();
+  }
+
+  //! Copy of cur without the callback it, nullptr if it would be empty.
+  static impl* without(const impl& cur, iterator it)
+  {
+    auto cbs = new impl;
+    const auto n = cur.ids.size();
+    cbs->callbacks.reserve(n);
+    cbs->ids.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+      if (cur.ids[i] != it.id)
+      {
+        cbs->callbacks.push_back(cur.callbacks[i]);
+        cbs->ids.push_back(cur.ids[i]);
+      }
+    }
+
+    if (cbs->callbacks.empty())
+    {
+      delete cbs;
+      return nullptr;
+    }
+    return cbs;
+  }
+
+  impl copy_callbacks() const
+  {
+    auto cur = m_callbacks.load(std::memory_order_acquire);
+    return cur ? *cur : impl{};
+  }
+
+  //! Swaps the callback array. Requires m_mutx to be locked.
+  //! The previous one is returned to be retired once it is unlocked, as
+  //! retiring may run the deleters of other containers.
+  [[nodiscard]] impl* publish(impl* cbs)
+  {
+    return m_callbacks.exchange(cbs, std::memory_order_seq_cst);
+  }
+
+  std::atomic<impl*> m_callbacks{};
+  std::atomic<uint32_t> m_senders[2]{};
+  std::atomic<uint32_t> m_phase{};
   mutable std::mutex m_mutx;
+  std::mutex m_sync;
+  uint64_t m_next_id{};
 };
 }
@@ -0,0 +1,138 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/detail/rcu.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ossia::rcu
+{
+namespace
+{
+struct retired_object
+{
+  void* ptr{};
+  void (*deleter)(void*){};
+  uint64_t epoch{};
+};
+
+struct domain
+{
+  std::array<reader_slot, max_readers> slots;
+  std::atomic<uint64_t> epoch{1};
+
+  std::mutex retired_mutex;
+  std::vector<retired_object> retired;
+};
+
+domain& get_domain() noexcept
+{
+  static domain d;
+  return d;
+}
+
+struct thread_registration
+{
+  reader_slot* slot{};
+
+  thread_registration() noexcept
+  {
+    for (auto& s : get_domain().slots)
+    {
+      bool expected = false;
+      if (s.used.compare_exchange_strong(expected, true))
+      {
+        slot = &s;
+        break;
+      }
+    }
+  }
+
+  ~thread_registration()
+  {
+    if (slot)
+    {
+      slot->epoch.store(0, std::memory_order_release);
+      slot->used.store(false, std::memory_order_release);
+    }
+  }
+};
+}
+
+reader_slot* this_thread_slot() noexcept
+{
+  static thread_local thread_registration reg;
+  return reg.slot;
+}
+
+uint64_t current_epoch() noexcept
+{
+  return get_domain().epoch.load(std::memory_order_acquire);
+}
+
+uint64_t advance_epoch() noexcept
+{
+  auto e = get_domain().epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return e;
+}
+
+uint64_t oldest_active_epoch() noexcept
+{
+  uint64_t oldest = std::numeric_limits<uint64_t>::max();
+  for (auto& s : get_domain().slots)
+  {
+    if (auto e = s.epoch.load(std::memory_order_acquire); e != 0 && e < oldest)
+      oldest = e;
+  }
+  return oldest;
+}
+
+void retire(void* ptr, void (*deleter)(void*)) noexcept
+{
+  auto& d = get_domain();
+  const auto e = advance_epoch();
+
+  std::vector<retired_object> to_free;
+  {
+    std::lock_guard<std::mutex> lock{d.retired_mutex};
+    d.retired.push_back({ptr, deleter, e});
+
+    const auto oldest = oldest_active_epoch();
+    auto it = std::partition(
+        d.retired.begin(), d.retired.end(),
+        [=](const retired_object& r) { return r.epoch > oldest; });
+    to_free.assign(it, d.retired.end());
+    d.retired.erase(it, d.retired.end());
+  }
+
+  // Deleters may themselves retire objects
+  for (auto& r : to_free)
+    r.deleter(r.ptr);
+}
+
+bool synchronize() noexcept
+{
+  const auto self = this_thread_slot();
+  if (self && self->epoch.load(std::memory_order_relaxed) != 0)
+    return false;
+
+  auto& d = get_domain();
+  const auto e = advance_epoch();
+  for (auto& s : d.slots)
+  {
+    for (;;)
+    {
+      const auto se = s.epoch.load(std::memory_order_acquire);
+      if (se == 0 || se >= e)
+        break;
+      std::this_thread::yield();
+    }
+  }
+  return true;
+}
+}
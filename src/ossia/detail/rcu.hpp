@@ -0,0 +1,117 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <atomic>
+#include <cinttypes>
+
+/**
+ * \file rcu.hpp
+ *
+ * Minimal epoch-based read-copy-update.
+ *
+ * Readers announce the epoch at which they started reading in a
+ * per-thread slot. Writers publish a new version of the data, advance the
+ * global epoch and only free the previous versions once every active reader
+ * has moved past the epoch at which they were retired.
+ *
+ * Reading only requires plain atomic loads and stores: no lock and
+ * no read-modify-write operation.
+ */
+namespace ossia::rcu
+{
+struct reader_slot
+{
+  //! 0 when the owning thread is not reading
+  alignas(64) std::atomic<uint64_t> epoch{0};
+  std::atomic_bool used{false};
+};
+
+//! Maximal number of threads which can read concurrently without locking
+static constexpr int max_readers = 128;
+
+//! Slot of the current thread, nullptr if all the slots are taken.
+OSSIA_EXPORT
+reader_slot* this_thread_slot() noexcept;
+
+OSSIA_EXPORT
+uint64_t current_epoch() noexcept;
+
+//! Advances the epoch and returns the new one. Called by writers.
+OSSIA_EXPORT
+uint64_t advance_epoch() noexcept;
+
+//! Oldest epoch that a reader is currently in, UINT64_MAX if none.
+OSSIA_EXPORT
+uint64_t oldest_active_epoch() noexcept;
+
+/**
+ * @brief Frees a retired object once no reader can still see it.
+ *
+ * Must be called after the pointer to the object was replaced:
+ * the deleter runs on a later call to retire() from any thread.
+ */
+OSSIA_EXPORT
+void retire(void* ptr, void (*deleter)(void*)) noexcept;
+
+template <typename T>
+void retire(T* ptr) noexcept
+{
+  if (ptr)
+    retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+}
+
+/**
+ * @brief Waits until every reader which may have seen a replaced pointer is done.
+ *
+ * Does not wait and returns false when called from inside a read section,
+ * as two threads waiting for each other would never finish:
+ * the replaced object has to be retired instead.
+ */
+OSSIA_EXPORT
+bool synchronize() noexcept;
+
+/**
+ * @brief Marks the current thread as reading.
+ *
+ * Can be nested: only the outermost guard announces and clears the epoch.
+ */
+class read_guard
+{
+public:
+  read_guard() noexcept : m_slot{this_thread_slot()}
+  {
+    if (m_slot)
+    {
+      if (m_slot->epoch.load(std::memory_order_relaxed) == 0)
+      {
+        m_slot->epoch.store(current_epoch(), std::memory_order_relaxed);
+        // Pairs with the fence in the writer:
+        // the epoch must be visible before we load the protected pointer.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_outer = true;
+      }
+    }
+  }
+
+  ~read_guard()
+  {
+    if (m_outer)
+      m_slot->epoch.store(0, std::memory_order_release);
+  }
+
+  read_guard(const read_guard&) = delete;
+  read_guard(read_guard&&) = delete;
+  read_guard& operator=(const read_guard&) = delete;
+  read_guard& operator=(read_guard&&) = delete;
+
+  //! False if no slot was available: the caller has to lock.
+  explicit operator bool() const noexcept
+  {
+    return m_slot;
+  }
+
+private:
+  reader_slot* m_slot{};
+  bool m_outer{};
+};
+}
@@ -18,6 +18,11 @@ void set_thread_realtime(std::thread& t)
   SetThreadPriority(hdl, THREAD_PRIORITY_TIME_CRITICAL);
 }
 
+void set_thread_pinned(std::thread& t, int cpu)
+{
+  SetThreadAffinityMask(t.native_handle(), DWORD_PTR(1) << (cpu % (8 * sizeof(DWORD_PTR))));
+}
+
 int get_pid()
 {
   return GetCurrentProcessId();
@@ -38,6 +43,16 @@ void set_thread_realtime(std::thread& t)
 #endif
 }
 
+void set_thread_pinned(std::thread& t, int cpu)
+{
+#if defined(__linux__) && !defined(__ANDROID__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % CPU_SETSIZE, &set);
+  pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &set);
+#endif
+}
+
 int get_pid()
 {
   return getpid();
@@ -9,6 +9,10 @@ namespace ossia
 OSSIA_EXPORT
 void set_thread_realtime(std::thread& t);
 
+//! Restricts a thread to run on a single CPU. No-op where unsupported.
+OSSIA_EXPORT
+void set_thread_pinned(std::thread& t, int cpu);
+
 OSSIA_EXPORT
 std::string get_exe_path();
 
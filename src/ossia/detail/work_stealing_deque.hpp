@@ -0,0 +1,160 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/**
+ * \file work_stealing_deque.hpp
+ */
+namespace ossia
+{
+//! Hint to the CPU that we are busy-waiting
+inline void cpu_pause() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  _mm_pause();
+#elif (defined(__aarch64__) || defined(__arm__)) && !defined(_MSC_VER)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Chase-Lev work-stealing deque of pointers
+ *
+ * The owning thread pushes and pops at the bottom, other threads steal
+ * from the top. None of the operations lock nor allocate.
+ *
+ * The capacity is fixed: it can only be changed with \ref reserve
+ * while the deque is empty and the owner is not using it.
+ * Buffers which are replaced are kept until destruction, as thieves may
+ * still be looking at them.
+ *
+ * See "Correct and Efficient Work-Stealing for Weak Memory Models",
+ * Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013.
+ */
+template <typename T>
+class work_stealing_deque
+{
+  static_assert(std::is_pointer_v<T>);
+
+public:
+  explicit work_stealing_deque(std::size_t capacity = 64)
+  {
+    reserve(capacity);
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque(work_stealing_deque&&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(work_stealing_deque&&) = delete;
+
+  std::size_t capacity() const noexcept
+  {
+    return m_ring.load(std::memory_order_relaxed)->mask + 1;
+  }
+
+  //! Makes room for at least n elements. The deque must be empty.
+  void reserve(std::size_t n)
+  {
+    std::size_t cap = 1;
+    while (cap < n)
+      cap *= 2;
+
+    if (auto r = m_ring.load(std::memory_order_relaxed); r && r->mask + 1 >= cap)
+      return;
+
+    auto& ring = m_rings.emplace_back(std::make_unique<ring_buffer>(cap));
+    m_ring.store(ring.get(), std::memory_order_release);
+  }
+
+  //! Owner only. There must be room for the element.
+  void push(T x) noexcept
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    auto r = m_ring.load(std::memory_order_relaxed);
+    r->data[b & r->mask].store(x, std::memory_order_relaxed);
+    m_bottom.store(b + 1, std::memory_order_release);
+  }
+
+  //! Owner only. Returns nullptr if the deque is empty.
+  T pop() noexcept
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto r = m_ring.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    T x{};
+    if (t <= b)
+    {
+      x = r->data[b & r->mask].load(std::memory_order_relaxed);
+      if (t == b)
+      {
+        // Last element: race against the thieves
+        if (!m_top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed))
+          x = nullptr;
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+    }
+    else
+    {
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  //! Any thread. Returns nullptr if the deque is empty or on contention.
+  T steal() noexcept
+  {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+    if (t < b)
+    {
+      auto r = m_ring.load(std::memory_order_acquire);
+      T x = r->data[t & r->mask].load(std::memory_order_relaxed);
+      if (!m_top.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+      return x;
+    }
+    return nullptr;
+  }
+
+  //! Approximate, for heuristics only.
+  bool empty() const noexcept
+  {
+    return m_bottom.load(std::memory_order_relaxed)
+           <= m_top.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct ring_buffer
+  {
+    explicit ring_buffer(std::size_t cap)
+        : mask{cap - 1}, data{std::make_unique<std::atomic<T>[]>(cap)}
+    {
+    }
+
+    std::size_t mask{};
+    std::unique_ptr<std::atomic<T>[]> data;
+  };
+
+  alignas(64) std::atomic<int64_t> m_top{0};
+  alignas(64) std::atomic<int64_t> m_bottom{0};
+  alignas(64) std::atomic<ring_buffer*> m_ring{};
+  std::vector<std::unique_ptr<ring_buffer>> m_rings;
+};
+}
@@ -3,6 +3,7 @@
 #include <ossia/detail/flat_map.hpp>
 #include <ossia/detail/optional.hpp>
 #include <ossia/detail/ptr_container.hpp>
+#include <ossia/detail/span.hpp>
 #include <ossia/editor/curve/curve_abstract.hpp>
 #include <ossia/editor/curve/curve_segment.hpp>
 #include <ossia/editor/curve/curve_segment/easing.hpp>
@@ -13,6 +14,9 @@
 
 #include <ossia/detail/config.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <functional>
 #include <map>
 #include <memory>
@@ -135,10 +139,22 @@ public:
   bool remove_point(X abscissa);
 
   /*! get value at an abscissa
+ \details the segment is found by binary search, except when the abscissa
+ is in the same or the next segment as on the previous call, e.g. for
+ a playhead moving forward.
  \param X abscissa.
  \return Y ordinate */
   Y value_at(X abscissa) const;
 
+  /*! get values at many abscissas
+ \details equivalent to calling value_at for each abscissa, but the
+ segment is only looked up when the abscissa leaves the current one:
+ evaluating an increasing sequence is linear in the number of
+ points and abscissas.
+ \param abscissas
+ \param values where the results are written; must be as large as abscissas */
+  void values_at(gsl::span<const X> abscissas, gsl::span<Y> values) const;
+
   ossia::curve_type get_type() const override;
 
   /*! get initial point abscissa
@@ -181,6 +197,10 @@ public:
       const ossia::value& value, ossia::destination_index::const_iterator idx);
 
 private:
+  //! Index of the first point at or after the abscissa; m_points.size() if none
+  std::size_t find_segment(X abscissa, std::size_t hint) const noexcept;
+  bool segment_contains(std::size_t idx, X abscissa) const noexcept;
+
   mutable X m_x0;
   mutable Y m_y0;
   mutable std::optional<ossia::destination> m_y0_destination;
@@ -190,6 +210,9 @@ private:
   mutable Y m_y0_cache;
 
   mutable bool m_y0_cacheUsed = false;
+
+  //! Segment found by the last call to value_at
+  mutable std::atomic<std::size_t> m_cursor{};
 };
 
 template <typename X, typename Y>
@@ -213,33 +236,121 @@ inline bool curve<X, Y>::remove_point(X abscissa)
   return m_points.erase(abscissa) > 0;
 }
 
+template <typename X, typename Y>
+inline bool
+curve<X, Y>::segment_contains(std::size_t idx, X abscissa) const noexcept
+{
+  const std::size_t n = m_points.size();
+  if (idx > n)
+    return false;
+
+  const auto it = m_points.begin() + idx;
+  return (idx == 0 || (it - 1)->first < abscissa)
+         && (idx == n || abscissa <= it->first);
+}
+
+template <typename X, typename Y>
+inline std::size_t
+curve<X, Y>::find_segment(X abscissa, std::size_t hint) const noexcept
+{
+  if (segment_contains(hint, abscissa))
+    return hint;
+  if (segment_contains(hint + 1, abscissa))
+    return hint + 1;
+
+  auto it = std::lower_bound(
+      m_points.begin(), m_points.end(), abscissa,
+      [](const auto& point, X x) { return point.first < x; });
+  return it - m_points.begin();
+}
+
 template <typename X, typename Y>
 inline Y curve<X, Y>::value_at(X abscissa) const
 {
-  X lastAbscissa = get_x0();
-  Y lastValue = get_y0();
+  // Always called first, so that a y0 destination is captured when the
+  // curve starts playing, even if it starts past the first segment
+  const Y y0 = get_y0();
+  if (m_points.empty())
+    return y0;
+
+  const std::size_t idx
+      = find_segment(abscissa, m_cursor.load(std::memory_order_relaxed));
+  m_cursor.store(idx, std::memory_order_relaxed);
+
+  if (idx == m_points.size())
+    return (m_points.end() - 1)->second.first;
+
+  const auto it = m_points.begin() + idx;
+  X lastAbscissa;
+  Y lastValue;
+  if (idx == 0)
+  {
+    lastAbscissa = get_x0();
+    lastValue = y0;
+    if (!(abscissa > lastAbscissa))
+      return lastValue;
+  }
+  else
+  {
+    lastAbscissa = (it - 1)->first;
+    lastValue = (it - 1)->second.first;
+  }
+
+  return it->second.second(
+      ((double)abscissa - (double)lastAbscissa)
+          / ((double)it->first - (double)lastAbscissa),
+      lastValue, it->second.first);
+}
+
+template <typename X, typename Y>
+inline void
+curve<X, Y>::values_at(gsl::span<const X> abscissas, gsl::span<Y> values) const
+{
+  assert(values.size() >= abscissas.size());
+  const auto count = abscissas.size();
+  const Y y0 = get_y0();
+  if (m_points.empty())
+  {
+    std::fill_n(values.begin(), count, y0);
+    return;
+  }
+
+  const X x0 = get_x0();
+  const std::size_t n = m_points.size();
+  const Y last = (m_points.end() - 1)->second.first;
+
+  // State of the current segment, only updated when changing segment
+  std::size_t idx = n + 1;
+  const ossia::curve_segment<Y>* segment{};
+  double start_x{}, width{};
+  Y start_y{}, end_y{};
 
-  auto end = m_points.end();
-  for (auto it = m_points.begin(); it != end; ++it)
+  for (std::size_t i = 0; i < count; i++)
   {
-    if (abscissa > lastAbscissa && abscissa <= it->first)
+    const X x = abscissas[i];
+    if (!segment_contains(idx, x))
     {
-      lastValue = it->second.second(
-          ((double)abscissa - (double)lastAbscissa)
-              / ((double)it->first - (double)lastAbscissa),
-          lastValue, it->second.first);
-      break;
-    }
-    else if (abscissa > it->first)
-    {
-      lastAbscissa = it->first;
-      lastValue = it->second.first;
+      idx = find_segment(x, idx);
+      if (idx < n)
+      {
+        const auto it = m_points.begin() + idx;
+        start_x = idx == 0 ? (double)x0 : (double)(it - 1)->first;
+        start_y = idx == 0 ? y0 : (it - 1)->second.first;
+        end_y = it->second.first;
+        width = (double)it->first - start_x;
+        segment = &it->second.second;
+      }
     }
+
+    if (idx == n)
+      values[i] = last;
+    else if (idx == 0 && !(x > x0))
+      values[i] = y0;
     else
-      break;
+      values[i] = (*segment)(((double)x - start_x) / width, start_y, end_y);
   }
 
-  return lastValue;
+  m_cursor.store(idx, std::memory_order_relaxed);
 }
 
 template <typename X, typename Y>
@@ -56,6 +56,25 @@ struct get_callback_count_visitor
   }
 };
 
+struct is_observable_visitor
+{
+  bool operator()(const expression_atom&) { return true; }
+  bool operator()(const expression_bool&) { return true; }
+  bool operator()(const expression_pulse&) { return true; }
+  bool operator()(const expression_generic&) { return false; }
+
+  bool operator()(const expression_composition& e)
+  {
+    return eggs::variants::apply(*this, e.get_first_operand())
+           && eggs::variants::apply(*this, e.get_second_operand());
+  }
+
+  bool operator()(const expression_not& e)
+  {
+    return eggs::variants::apply(*this, e.get_expression());
+  }
+};
+
 struct different_visitor
 {
   template <typename T, typename U>
@@ -172,6 +191,11 @@ void remove_callback(expression_base& e, expression_callback_iterator it)
   return eggs::variants::apply(remove_callback_visitor{it}, e);
 }
 
+bool is_observable(const expression_base& e)
+{
+  return eggs::variants::apply(is_observable_visitor{}, e);
+}
+
 std::size_t callback_count(expression_base& e)
 {
   return eggs::variants::apply(get_callback_count_visitor{}, e);
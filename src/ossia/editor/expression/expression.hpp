@@ -95,6 +95,16 @@ add_callback(expression_base&, expression_result_callback);
 OSSIA_EXPORT void
 remove_callback(expression_base&, expression_callback_iterator);
 
+/**
+ * @brief is_observable
+ * @return True if the callbacks of an expression are called every time its
+ * result may change, so that it does not need to be evaluated otherwise.
+ *
+ * This is not the case of expression_generic, whose notifications are up to
+ * their implementation.
+ */
+OSSIA_EXPORT bool is_observable(const expression_base&);
+
 /**
  * @brief callback_count
  * @return Number of callbacks in an expression.
@@ -216,7 +216,11 @@ void scenario::run_interval(
   }
   if (interval.get_date() >= interval.get_min_duration())
   {
-    m_endNodes.insert(end_node);
+    // A sync waiting for its expression to become true is only processed
+    // again once it gets a trigger request, or when its max is reached
+    if (!end_node->is_waiting_for_expression()
+        || interval.get_date() >= interval.get_max_duration())
+      m_endNodes.insert(end_node);
 
     // Graph intervals always enable what's after them by definition
     if(interval.graphal)
@@ -250,13 +254,6 @@ void scenario::state_impl(const ossia::token_request& tk)
     m_endNodes.container.reserve(m_nodes.size());
     m_overticks.container.reserve(m_nodes.size());
 
-    for (auto it = m_runningIntervals.begin(); it != m_runningIntervals.end();)
-    {
-      if ((*it)->get_end_event().get_status() == time_event::status::HAPPENED)
-        it = m_runningIntervals.erase(it);
-      else
-        ++it;
-    }
     // First we should find, for each running interval, the actual maximum
     // tick length
     // that they can be ticked. If it is < tick_us, then they won't execute.
@@ -270,42 +267,42 @@ void scenario::state_impl(const ossia::token_request& tk)
     m_pendingEvents.clear();
     m_maxReachedEvents.clear();
 
-    for (auto& n : m_rootNodes)
+    // Idle roots are only looked at when they get a trigger request,
+    // from their expression or from the user
+    time_sync* woken{};
+    while (m_wakeups.try_dequeue(woken))
     {
-      if (!n->is_observing_expression())
+      // e.g. not a root, or removed from the scenario since
+      if (m_rootNodes.find(woken) == m_rootNodes.end())
+        continue;
+
+      auto parked = m_parkedNodes.find(woken);
+      if (parked != m_parkedNodes.end())
       {
-        n->observe_expression(true, [n](bool b) {
-          if (b)
-            n->start_trigger_request();
-        });
+        // it will execute soon after
+        m_parkedNodes.erase(parked);
+        m_waitingNodes.insert(woken);
       }
-
-      if (n->trigger_request)
+      else if (
+          woken->trigger_request
+          && m_waitingNodes.find(woken) == m_waitingNodes.end())
       {
-        if (m_waitingNodes.find(n) != m_waitingNodes.end())
+        auto& evs = woken->get_time_events();
+        for (auto& e : evs)
         {
-          // it will execute soon after
-          continue;
-        }
-        else
-        {
-          auto& evs = n->get_time_events();
-          for (auto& e : evs)
+          const auto st = e->get_status();
+          if (st == ossia::time_event::status::HAPPENED
+              || st == ossia::time_event::status::DISPOSED)
           {
-            const auto st = e->get_status();
-            if (st == ossia::time_event::status::HAPPENED
-                || st == ossia::time_event::status::DISPOSED)
-            {
-              m_sg.reset_component(*n);
-              break;
-            }
+            m_sg.reset_component(*woken);
+            break;
           }
+        }
 
-          if(n->is_autotrigger())
-            n->m_evaluating = true;
+        if(woken->is_autotrigger())
+          woken->m_evaluating = true;
 
-          m_waitingNodes.insert(n);
-        }
+        m_waitingNodes.insert(woken);
       }
     }
 
@@ -321,13 +318,24 @@ void scenario::state_impl(const ossia::token_request& tk)
       switch (res)
       {
         case sync_status::NOT_READY:
-          ++it;
+          // Its expression will wake it up
+          if (n->is_waiting_for_expression())
+          {
+            m_parkedNodes.insert(n);
+            it = m_waitingNodes.erase(it);
+          }
+          else
+          {
+            ++it;
+          }
           break;
         case sync_status::RETRY:
           ++it;
           break;
         case sync_status::DONE:
           it = m_waitingNodes.erase(it);
+          // Back to idle, until the next trigger request
+          n->observe_expression(true);
           break;
       }
       m_pendingEvents.clear();
@@ -337,10 +345,20 @@ void scenario::state_impl(const ossia::token_request& tk)
 
 
     // First check timesyncs already past their min
-    // for any that may have a quantization setting
+    // for any that may have a quantization setting.
+    // The intervals which ended outside of this scenario's tick are removed
+    // in the same pass.
 
-    for (time_interval* interval : m_runningIntervals)
+    for (auto it = m_runningIntervals.begin(); it != m_runningIntervals.end();)
     {
+      time_interval* interval = *it;
+      if (interval->get_end_event().get_status() == time_event::status::HAPPENED)
+      {
+        it = m_runningIntervals.erase(it);
+        continue;
+      }
+      ++it;
+
       if (interval->get_date() >= interval->get_min_duration())
       {
         const auto end_node = &interval->get_end_event().get_time_sync();
@@ -413,6 +431,8 @@ void scenario::state_impl(const ossia::token_request& tk)
           {
             node->set_is_being_triggered(false);
             m_retry_syncs.erase(node);
+            if (m_rootNodes.find(node) != m_rootNodes.end())
+              node->observe_expression(true);
             break;
           }
           case sync_status::NOT_READY:
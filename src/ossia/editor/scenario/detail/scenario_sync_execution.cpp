@@ -86,6 +86,11 @@ sync_status scenario::trigger_sync(
     interval_set& started, interval_set& stopped,
     ossia::time_value tick_offset, const ossia::token_request& tk, bool maximalDurationReached)
 {
+  // Once observed, the expression sets trigger_request when it becomes
+  // true: after the first evaluation, it does not have to be evaluated
+  // at each tick
+  const bool waiting = sync.is_waiting_for_expression();
+
   if (!sync.m_evaluating)
   {
     sync.m_evaluating = true;
@@ -109,6 +114,8 @@ sync_status scenario::trigger_sync(
 
       if (sync.trigger_request)
         sync.end_trigger_request();
+      else if (waiting)
+        return sync_status::NOT_READY;
       else if (!expressions::evaluate(*sync.m_expression))
         return sync_status::NOT_READY;
     }
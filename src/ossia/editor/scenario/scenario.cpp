@@ -22,6 +22,7 @@ scenario::~scenario()
 {
   for (auto& timesync : m_nodes)
   {
+    timesync->m_scenario = nullptr;
     timesync->cleanup();
   }
 }
@@ -35,7 +36,7 @@ void scenario::start()
   m_itv_end_map.container.reserve(m_intervals.size());
   m_endNodes.container.reserve(m_nodes.size());
   m_retry_syncs.container.reserve(8);
-  m_rootNodes = get_roots();
+  update_roots();
 
   for (auto node : m_rootNodes)
   {
@@ -127,6 +128,7 @@ void scenario::stop()
 
   m_runningIntervals.clear();
   m_waitingNodes.clear();
+  m_parkedNodes.clear();
   m_pendingEvents.clear();
   m_maxReachedEvents.clear();
   m_overticks.clear();
@@ -175,7 +177,8 @@ void scenario::add_time_interval(std::shared_ptr<time_interval> itv)
     if(end_root)
     {
       m_waitingNodes.erase(end_root);
-      m_rootNodes = get_roots();
+      m_parkedNodes.erase(end_root);
+      update_roots();
     }
   }
 }
@@ -191,9 +194,10 @@ void scenario::remove_time_interval(const std::shared_ptr<time_interval>& itv)
       auto& t = itv->get_end_event().get_time_sync();
       if (t.is_start())
       {
+        m_parkedNodes.erase(&t);
         m_waitingNodes.insert(&t);
       }
-      m_rootNodes = get_roots();
+      update_roots();
     }
     auto it = ossia::find(m_runningIntervals, itv.get());
     if (it != m_runningIntervals.end())
@@ -209,6 +213,7 @@ void scenario::add_time_sync(std::shared_ptr<time_sync> timeSync)
   if (!contains(m_nodes, timeSync))
   {
     auto& t = *timeSync;
+    t.m_scenario = this;
     m_sg.add_vertice(&t);
     if(node->muted())
       t.mute(true);
@@ -219,7 +224,7 @@ void scenario::add_time_sync(std::shared_ptr<time_sync> timeSync)
       if (t.is_start())
       {
         m_waitingNodes.insert(&t);
-        m_rootNodes = get_roots();
+        update_roots();
       }
     }
   }
@@ -229,11 +234,11 @@ void scenario::remove_time_sync(const std::shared_ptr<time_sync>& timeSync)
 {
   if (timeSync)
   {
+    timeSync->m_scenario = nullptr;
     m_sg.remove_vertice(timeSync.get());
     m_waitingNodes.erase(timeSync.get());
-    auto it = ossia::find(m_rootNodes, timeSync.get());
-    if (it != m_rootNodes.end())
-      m_rootNodes.erase(it);
+    m_parkedNodes.erase(timeSync.get());
+    m_rootNodes.erase(timeSync.get());
     m_overticks.erase(timeSync.get());
     m_endNodes.erase(timeSync.get());
     m_retry_syncs.erase(timeSync.get());
@@ -271,6 +276,43 @@ void scenario::reset_subgraph(
     m_runningIntervals.erase(itv.get());
     m_itv_end_map.erase(itv.get());
   }
+
+  // The other roots of the component start over: they are evaluated again,
+  // or listen to their expression again
+  for (const std::shared_ptr<ossia::time_sync>& sync : syncs)
+  {
+    auto s = sync.get();
+    if (s == &root || m_rootNodes.find(s) == m_rootNodes.end())
+      continue;
+
+    auto parked = m_parkedNodes.find(s);
+    if (parked != m_parkedNodes.end())
+    {
+      m_parkedNodes.erase(parked);
+      m_waitingNodes.insert(s);
+    }
+    else if (m_waitingNodes.find(s) == m_waitingNodes.end())
+    {
+      s->observe_expression(true);
+    }
+  }
+}
+
+void scenario::update_roots()
+{
+  m_rootNodes.clear();
+  for (auto n : get_roots())
+  {
+    // Idle roots listen to their expression: they are only looked at
+    // once it sets their trigger request
+    n->observe_expression(true);
+    m_rootNodes.insert(n);
+  }
+}
+
+void scenario::wake(time_sync& sync)
+{
+  m_wakeups.enqueue(&sync);
 }
 
 void scenario::mute_impl(bool m)
@@ -10,6 +10,8 @@
 
 #include <boost/graph/adjacency_list.hpp>
 
+#include <concurrentqueue.h>
+
 #include <ossia/detail/config.hpp>
 namespace ossia
 {
@@ -98,6 +100,7 @@ public:
   const ptr_container<time_interval>& get_time_intervals() const;
 
   friend struct scenario_graph;
+  friend class time_sync;
   void offset_impl(ossia::time_value) override;
 
   void state_impl(const ossia::token_request& req);
@@ -123,7 +126,14 @@ private:
 
   interval_set m_runningIntervals;
   sync_set m_waitingNodes;
-  small_sync_vec m_rootNodes;
+  sync_set m_rootNodes;
+
+  // Root syncs waiting for their expression: they are only processed again
+  // once they get a trigger request, see time_sync::is_waiting_for_expression
+  sync_set m_parkedNodes;
+
+  // Syncs which got a trigger request, handled at the next tick
+  moodycamel::ConcurrentQueue<time_sync*> m_wakeups;
   small_event_vec m_pendingEvents;
   small_event_vec m_maxReachedEvents;
   overtick_map m_overticks; // used as cache
@@ -134,6 +144,11 @@ private:
 
   ossia::time_value m_lastDate{ossia::Infinite};
 
+  void update_roots();
+
+  // Called by the time_syncs of the scenario, from any thread
+  void wake(time_sync& sync);
+
   static void make_happen(
       time_event& event, interval_set& started, interval_set& stopped,
       ossia::time_value tick_offset, const ossia::token_request& tok);
@@ -1,5 +1,6 @@
 // This is an open source non-commercial project. Dear PVS-Studio, please check
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/editor/scenario/scenario.hpp>
 #include <ossia/editor/scenario/time_interval.hpp>
 #include <ossia/editor/scenario/time_sync.hpp>
 #include <ossia/detail/algorithms.hpp>
@@ -12,6 +13,7 @@ time_sync::time_sync()
   , m_status{status::NOT_DONE}
   , m_start{}
   , m_observe{}
+  , m_observable{}
   , m_evaluating{}
   , m_muted{}
   , m_autotrigger{}
@@ -54,7 +56,20 @@ const expression& time_sync::get_expression() const noexcept
 time_sync& time_sync::set_expression(expression_ptr exp) noexcept
 {
   assert(exp);
+  // The callback belongs to the previous expression
+  const bool observed = m_observe;
+  observe_expression(false);
   m_expression = std::move(exp);
+
+  // An idle root keeps listening, and a sync being evaluated looks at
+  // the new expression at least once
+  if (observed)
+  {
+    if (!m_evaluating)
+      observe_expression(true);
+    else if (auto s = m_scenario.load(std::memory_order_acquire))
+      s->wake(*this);
+  }
   return *this;
 }
 
@@ -83,11 +98,18 @@ bool time_sync::is_evaluating() const noexcept
   return m_evaluating;
 }
 
+bool time_sync::is_waiting_for_expression() const noexcept
+{
+  return m_observe && m_observable && m_evaluating && !trigger_request
+         && !m_is_being_triggered && !has_trigger_date() && !has_sync_rate();
+}
+
 void time_sync::start_trigger_request() noexcept
 {
-  if(!trigger_request)
+  if(!trigger_request.exchange(true))
   {
-    trigger_request = true;
+    if(auto s = m_scenario.load(std::memory_order_acquire))
+      s->wake(*this);
   }
 }
 
@@ -123,9 +145,11 @@ bool time_sync::is_observing_expression() const noexcept
 
 void time_sync::observe_expression(bool observe)
 {
-  // start expression observation; dummy callback used.
-  // Do not remove it : else the expressions will stop listening.
-  return observe_expression(observe, [](bool) {});
+  // Do not remove the callback : else the expressions will stop listening.
+  return observe_expression(observe, [this](bool b) {
+    if (b)
+      start_trigger_request();
+  });
 }
 
 void time_sync::observe_expression(
@@ -143,6 +167,7 @@ void time_sync::observe_expression(
     if (m_observe)
     {
       m_callback = expressions::add_callback(*m_expression, cb);
+      m_observable = expressions::is_observable(*m_expression);
     }
     else
     {
@@ -164,6 +189,7 @@ void time_sync::reset()
   }
 
   m_trigger_date = Infinite;
+  observe_expression(false);
   m_observe = false;
   m_evaluating = false;
 }
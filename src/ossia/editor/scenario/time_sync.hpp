@@ -88,6 +88,11 @@ public:
   bool is_observing_expression() const noexcept;
   bool is_evaluating() const noexcept;
 
+  /*! true while the time_sync is evaluating and its observed expression was
+ false: until trigger_request is set by a change of the expression, or by
+ the user, there is no need to evaluate it again */
+  bool is_waiting_for_expression() const noexcept;
+
   /*! evaluate all #time_event's to make them to happen or to dispose them
  \return boolean true if the operation succeeded */
   void start_trigger_request() noexcept;
@@ -107,7 +112,8 @@ public:
   void set_start(bool) noexcept;
 
 
-  //! enable observation of the ossia::expression
+  //! enable observation of the ossia::expression.
+  //! The time_sync gets a trigger request every time it becomes true.
   void observe_expression(bool);
   void observe_expression(bool, ossia::expressions::expression_result_callback cb);
 
@@ -197,10 +203,13 @@ private:
   double m_quarter_duration = ossia::quarter_duration<double>; // REMOVEME
 
   std::atomic_bool trigger_request{};
+  // Told about the trigger requests while the sync belongs to it
+  std::atomic<ossia::scenario*> m_scenario{};
   time_value m_trigger_date = Infinite;
   status m_status : 2;
   bool m_start : 1;
   bool m_observe : 1;
+  bool m_observable : 1;
   bool m_evaluating : 1;
   bool m_muted : 1;
   bool m_autotrigger : 1;
@@ -2,6 +2,7 @@
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include <ossia/network/base/device.hpp>
 #include <ossia/network/base/protocol.hpp>
+#include <ossia/network/common/address_index.hpp>
 
 namespace ossia
 {
@@ -11,6 +12,7 @@ device_base::~device_base() = default;
 
 device_base::device_base(std::unique_ptr<protocol_base> proto)
     : m_protocol{std::move(proto)}
+    , m_index{std::make_unique<address_index>(*this)}
 {
 }
 
@@ -11,6 +11,7 @@ namespace net
 {
 struct parameter_data;
 class protocol_base;
+class address_index;
 
 /**
  * @brief What a device is able to do
@@ -95,6 +96,13 @@ public:
     m_echo = echo;
   }
 
+  //! Dispatch index of the OSC addresses of this device, used by the
+  //! network protocols to route inbound messages.
+  ossia::net::address_index& get_address_index() const noexcept
+  {
+    return *m_index;
+  }
+
   void apply_incoming_message(
       const message_origin_identifier& id,
       ossia::net::parameter_base& param,
@@ -139,6 +147,9 @@ protected:
   std::unique_ptr<ossia::net::protocol_base> m_protocol;
   device_capabilities m_capabilities{};
   bool m_echo{false};
+
+private:
+  std::unique_ptr<ossia::net::address_index> m_index;
 };
 
 template <typename T>
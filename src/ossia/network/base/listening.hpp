@@ -1,8 +1,13 @@
 #pragma once
 #include <ossia/detail/mutex.hpp>
 #include <ossia/detail/optional.hpp>
+#include <ossia/detail/rcu.hpp>
 #include <ossia/detail/string_map.hpp>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 namespace ossia
 {
 // MOVEME
@@ -82,10 +87,196 @@ private:
   map_type m_map;
 };
 
+/**
+ * @brief Map optimized for concurrent lookups and rare modifications
+ *
+ * Same interface than \ref locked_map, but find() does not take any lock
+ * and does no atomic read-modify-write operation: the map is split in shards,
+ * each shard is an immutable snapshot which writers copy, modify and publish
+ * (read-copy-update). Old snapshots are freed once no reader can see them
+ * anymore, see \ref ossia::rcu.
+ *
+ * Writers are serialized with a mutex and only copy the shard they modify.
+ */
+template <typename T, std::size_t Shards = 64>
+struct rcu_map
+{
+public:
+  using map_type = T;
+  using key_type = typename map_type::key_type;
+  using mapped_type = typename map_type::mapped_type;
+  using value_type = typename map_type::value_type;
+  static_assert((Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+  rcu_map()
+  {
+    for (auto& shard : m_shards)
+      shard.store(new map_type, std::memory_order_relaxed);
+  }
+
+  ~rcu_map()
+  {
+    for (auto& shard : m_shards)
+      delete shard.load(std::memory_order_relaxed);
+    for (auto& r : m_retired)
+      delete r.first;
+  }
+
+  rcu_map(const rcu_map&) = delete;
+  rcu_map(rcu_map&&) = delete;
+  rcu_map& operator=(const rcu_map&) = delete;
+  rcu_map& operator=(rcu_map&&) = delete;
+
+  template <typename Key>
+  std::optional<mapped_type> find(const Key& path) const
+  {
+    auto& shard = m_shards[shard_index(path)];
+
+    ossia::rcu::read_guard guard;
+    if (guard)
+    {
+      return find_in(*shard.load(std::memory_order_acquire), path);
+    }
+    else
+    {
+      // No reader slot left for this thread
+      lock_t lock(m_mutex);
+      return find_in(*shard.load(std::memory_order_relaxed), path);
+    }
+  }
+
+  template <typename Key>
+  std::optional<mapped_type> find_and_take(const Key& path)
+  {
+    lock_t lock(m_mutex);
+    auto& shard = m_shards[shard_index(path)];
+    auto cur = shard.load(std::memory_order_relaxed);
+    auto it = cur->find(path);
+    if (it != cur->end())
+    {
+      auto copy = std::make_unique<map_type>(*cur);
+      auto copy_it = copy->find(path);
+      auto val = copy_it->second;
+      copy->erase(copy_it);
+      publish(shard, std::move(copy));
+      return std::move(val);
+    }
+    else
+    {
+      return std::nullopt;
+    }
+  }
+
+  void rename(const key_type& oldk, const key_type& newk)
+  {
+    lock_t lock(m_mutex);
+    auto& old_shard = m_shards[shard_index(oldk)];
+    auto cur = old_shard.load(std::memory_order_relaxed);
+    auto it = cur->find(oldk);
+    if (it != cur->end())
+    {
+      auto v = it->second;
+      erase_unsafe(oldk);
+      insert_unsafe(value_type{newk, std::move(v)});
+    }
+  }
+
+  void insert(const value_type& m)
+  {
+    lock_t lock(m_mutex);
+    insert_unsafe(m);
+  }
+
+  void insert(value_type&& m)
+  {
+    lock_t lock(m_mutex);
+    insert_unsafe(std::move(m));
+  }
+
+  void erase(const key_type& m)
+  {
+    lock_t lock(m_mutex);
+    erase_unsafe(m);
+  }
+
+private:
+  using shard_type = std::atomic<const map_type*>;
+
+  template <typename Key>
+  static std::size_t shard_index(const Key& k) noexcept
+  {
+    // Fibonacci hashing: the maps use the low bits of the hash for their
+    // buckets, so we take the high bits of the mixed hash for the shards.
+    constexpr int bits = [] {
+      int b = 0;
+      for (std::size_t s = Shards; s > 1; s >>= 1)
+        b++;
+      return b;
+    }();
+    if constexpr (bits == 0)
+      return 0;
+    else
+      return (uint64_t(typename map_type::hasher{}(k)) * 0x9E3779B97F4A7C15ull)
+             >> (64 - bits);
+  }
+
+  template <typename Key>
+  static std::optional<mapped_type> find_in(const map_type& map, const Key& k)
+  {
+    auto it = map.find(k);
+    if (it != map.end())
+      return it->second;
+    else
+      return std::nullopt;
+  }
+
+  template <typename V>
+  void insert_unsafe(V&& m)
+  {
+    auto& shard = m_shards[shard_index(m.first)];
+    auto copy = std::make_unique<map_type>(*shard.load(std::memory_order_relaxed));
+    copy->insert(std::forward<V>(m));
+    publish(shard, std::move(copy));
+  }
+
+  void erase_unsafe(const key_type& k)
+  {
+    auto& shard = m_shards[shard_index(k)];
+    auto cur = shard.load(std::memory_order_relaxed);
+    if (cur->find(k) == cur->end())
+      return;
+
+    auto copy = std::make_unique<map_type>(*cur);
+    copy->erase(k);
+    publish(shard, std::move(copy));
+  }
+
+  void publish(shard_type& shard, std::unique_ptr<map_type> copy)
+  {
+    auto old = shard.exchange(copy.release(), std::memory_order_seq_cst);
+    m_retired.emplace_back(old, ossia::rcu::advance_epoch());
+
+    // Free the snapshots that no reader can be looking at anymore
+    const auto oldest = ossia::rcu::oldest_active_epoch();
+    auto it = m_retired.begin();
+    for (; it != m_retired.end(); ++it)
+    {
+      if (it->second > oldest)
+        break;
+      delete it->first;
+    }
+    m_retired.erase(m_retired.begin(), it);
+  }
+
+  mutable mutex_t m_mutex;
+  std::array<shard_type, Shards> m_shards;
+  std::vector<std::pair<const map_type*, uint64_t>> m_retired;
+};
+
 namespace net
 {
 class parameter_base;
 using listened_parameters
-    = locked_map<string_map<ossia::net::parameter_base*>>;
+    = rcu_map<string_map<ossia::net::parameter_base*>>;
 }
 }
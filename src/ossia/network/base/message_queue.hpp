@@ -11,6 +11,9 @@ struct received_value
 {
   ossia::net::parameter_base* address{};
   ossia::value value;
+
+  //! Slot given when registering the parameter, -1 if none
+  int32_t slot{-1};
 };
 
 class message_queue final : public Nano::Observer
@@ -41,14 +44,14 @@ public:
     return m_queue.try_dequeue(v);
   }
 
-  void reg(ossia::net::parameter_base& p)
+  void reg(ossia::net::parameter_base& p, int32_t slot = -1)
   {
     auto ptr = &p;
     auto reg_it = m_reg.find(&p);
     if (reg_it == m_reg.end())
     {
-      auto it = p.add_callback([this, ptr](const ossia::value& val) {
-        m_queue.enqueue({ptr, val});
+      auto it = p.add_callback([this, ptr, slot](const ossia::value& val) {
+        m_queue.enqueue({ptr, val, slot});
       });
       m_reg.insert({&p, {0, it}});
     }
@@ -177,6 +177,11 @@ node_base* node_base::find_child(ossia::string_view name)
   }
 
   SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
+  return find_lazy_child(name);
+}
+
+node_base* node_base::find_lazy_child(ossia::string_view name)
+{
   return nullptr;
 }
 
@@ -198,7 +203,7 @@ node_base* node_base::find_child(const QString& name)
   }
 
   SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
-  return nullptr;
+  return find_lazy_child(name.toStdString());
 }
 #endif
 
@@ -149,6 +149,8 @@ public:
    *
    * If you need to find a child recursively, see ossia::net::find_node.
    *
+   * Nodes whose children are created on demand create it if needed,
+   * see find_lazy_child.
    */
   node_base* find_child(ossia::string_view name);
 #if defined(OSSIA_QT)
@@ -209,6 +211,10 @@ protected:
   //! Reimplement for a specific removal action.
   virtual void removing_child(node_base& node_base) = 0;
 
+  //! Called by find_child when no child has this name: nodes whose children
+  //! are only created when they are first looked up create it here.
+  virtual node_base* find_lazy_child(ossia::string_view name);
+
   std::string m_name;
   children_t m_children;
   mutable shared_mutex_t m_mutex;
@@ -0,0 +1,186 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/network/base/device.hpp>
+#include <ossia/network/base/node.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/common/address_index.hpp>
+#include <ossia/network/common/path.hpp>
+
+namespace ossia
+{
+namespace net
+{
+
+struct address_index::cached_pattern
+{
+  std::optional<ossia::traversal::path> path;
+  std::vector<ossia::net::node_base*> nodes;
+  uint64_t generation{};
+  bool resolved{};
+};
+
+address_index::address_index(device_base& dev) : m_device{dev}
+{
+  dev.on_node_created.connect<&address_index::on_node_created>(*this);
+  dev.on_node_removing.connect<&address_index::on_node_removing>(*this);
+  dev.on_node_renamed.connect<&address_index::on_node_renamed>(*this);
+}
+
+address_index::~address_index() = default;
+
+node_base* address_index::find_node(ossia::string_view address)
+{
+  {
+    lock_t lock{m_mutex};
+    if (!m_built)
+      build_unsafe();
+
+    auto it = m_nodes.find(address);
+    if (it != m_nodes.end())
+    {
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+
+  // The index only knows about canonical addresses: "/foo/bar".
+  // Handle "foo/bar" or "/foo/bar/" like ossia::net::find_node does.
+  if (!address.empty()
+      && (address.front() != '/'
+          || (address.size() > 1 && address.back() == '/')))
+  {
+    return ossia::net::find_node(m_device.get_root_node(), address);
+  }
+
+  return nullptr;
+}
+
+bool address_index::find_nodes(ossia::string_view pattern, node_list& out)
+{
+  out.clear();
+  if (!ossia::traversal::is_pattern(pattern))
+  {
+    if (auto node = find_node(pattern))
+      out.push_back(node);
+    return true;
+  }
+
+  lock_t lock{m_mutex};
+  if (!m_built)
+    build_unsafe();
+
+  auto it = m_patterns.find(pattern);
+  if (it == m_patterns.end())
+  {
+    if (m_patterns.size() >= max_cached_patterns)
+      m_patterns.clear();
+
+    auto p = std::make_unique<cached_pattern>();
+    p->path = ossia::traversal::make_path(pattern);
+    it = m_patterns.insert({std::string(pattern), std::move(p)}).first;
+  }
+
+  cached_pattern& p = *it->second;
+  if (!p.path)
+  {
+    m_pattern_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (!p.resolved || p.generation != m_generation)
+  {
+    p.nodes.clear();
+    p.nodes.push_back(&m_device.get_root_node());
+    ossia::traversal::apply(*p.path, p.nodes);
+    p.generation = m_generation;
+    p.resolved = true;
+    m_pattern_misses.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
+  {
+    m_pattern_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  out.assign(p.nodes.begin(), p.nodes.end());
+  return true;
+}
+
+address_index_stats address_index::stats() const noexcept
+{
+  return {
+      m_hits.load(std::memory_order_relaxed),
+      m_misses.load(std::memory_order_relaxed),
+      m_pattern_hits.load(std::memory_order_relaxed),
+      m_pattern_misses.load(std::memory_order_relaxed)};
+}
+
+void address_index::reset_stats() noexcept
+{
+  m_hits.store(0, std::memory_order_relaxed);
+  m_misses.store(0, std::memory_order_relaxed);
+  m_pattern_hits.store(0, std::memory_order_relaxed);
+  m_pattern_misses.store(0, std::memory_order_relaxed);
+}
+
+void address_index::invalidate()
+{
+  lock_t lock{m_mutex};
+  m_nodes.clear();
+  m_built = false;
+  m_generation++;
+}
+
+void address_index::on_node_created(node_base& node)
+{
+  lock_t lock{m_mutex};
+  if (m_built)
+    add_rec_unsafe(node);
+  m_generation++;
+}
+
+void address_index::on_node_removing(node_base& node)
+{
+  lock_t lock{m_mutex};
+  if (m_built)
+  {
+    auto it = m_nodes.find(node.osc_address());
+    if (it != m_nodes.end() && it->second == &node)
+      m_nodes.erase(it);
+
+    // Children are normally removed before their parent,
+    // but not when the tree cannot be changed.
+    if (!node.unsafe_children().empty())
+    {
+      m_nodes.clear();
+      m_built = false;
+    }
+  }
+  m_generation++;
+}
+
+void address_index::on_node_renamed(node_base&, std::string)
+{
+  // The address of every child changes: rebuild on the next lookup.
+  lock_t lock{m_mutex};
+  m_nodes.clear();
+  m_built = false;
+  m_generation++;
+}
+
+void address_index::build_unsafe()
+{
+  m_nodes.clear();
+  add_rec_unsafe(m_device.get_root_node());
+  m_built = true;
+}
+
+void address_index::add_rec_unsafe(node_base& node)
+{
+  m_nodes[node.osc_address()] = &node;
+  for (auto cld : node.children_copy())
+    add_rec_unsafe(*cld);
+}
+}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <ossia/detail/mutex.hpp>
+#include <ossia/detail/small_vector.hpp>
+#include <ossia/detail/string_map.hpp>
+#include <ossia/detail/string_view.hpp>
+
+#include <nano_signal_slot.hpp>
+
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <string>
+
+namespace ossia
+{
+namespace traversal
+{
+struct path;
+}
+namespace net
+{
+class device_base;
+class node_base;
+
+/**
+ * @brief Counters of an \ref address_index
+ */
+struct address_index_stats
+{
+  //! Exact addresses found in the index
+  uint64_t hits{};
+  //! Exact addresses not found in the index
+  uint64_t misses{};
+  //! Patterns resolved from the cache
+  uint64_t pattern_hits{};
+  //! Patterns which had to be compiled or re-applied to the tree
+  uint64_t pattern_misses{};
+};
+
+/**
+ * @brief Dispatch index for inbound OSC addresses of a device
+ *
+ * Maps the OSC address of every node of the device to the node,
+ * and caches the result of OSC pattern matching, so that incoming messages
+ * do not have to walk the device tree.
+ *
+ * The index is kept in sync with the tree through the node creation,
+ * removal and renaming signals of the \ref device_base.
+ * It is built lazily on the first lookup: the lookups are meant to be done
+ * from the network threads while the tree is modified from the main thread.
+ *
+ * \see on_input_message
+ */
+class OSSIA_EXPORT address_index final : public Nano::Observer
+{
+public:
+  using node_list = ossia::small_vector<ossia::net::node_base*, 16>;
+
+  //! Maximal number of patterns cached before the cache is flushed
+  static constexpr std::size_t max_cached_patterns = 1024;
+
+  explicit address_index(device_base& dev);
+  ~address_index();
+
+  address_index() = delete;
+  address_index(const address_index&) = delete;
+  address_index(address_index&&) = delete;
+  address_index& operator=(const address_index&) = delete;
+  address_index& operator=(address_index&&) = delete;
+
+  //! Node with exactly the given OSC address, e.g. "/foo/bar"
+  ossia::net::node_base* find_node(ossia::string_view address);
+
+  /**
+   * @brief Nodes matching an OSC address pattern, e.g. "/mixer/{1..8}/gain"
+   *
+   * The pattern is compiled once and the matched nodes are cached
+   * until the next change of the device tree.
+   *
+   * @return false if the address is not a valid pattern.
+   */
+  bool find_nodes(ossia::string_view pattern, node_list& out);
+
+  address_index_stats stats() const noexcept;
+  void reset_stats() noexcept;
+
+  //! Forget everything: the index will be rebuilt on the next lookup
+  void invalidate();
+
+private:
+  struct cached_pattern;
+
+  void on_node_created(ossia::net::node_base&);
+  void on_node_removing(ossia::net::node_base&);
+  void on_node_renamed(ossia::net::node_base&, std::string);
+
+  void build_unsafe();
+  void add_rec_unsafe(ossia::net::node_base& node);
+
+  device_base& m_device;
+
+  mutable mutex_t m_mutex;
+  string_map<ossia::net::node_base*> m_nodes;
+  string_map<std::unique_ptr<cached_pattern>> m_patterns;
+  uint64_t m_generation{};
+  bool m_built{};
+
+  std::atomic<uint64_t> m_hits{};
+  std::atomic<uint64_t> m_misses{};
+  std::atomic<uint64_t> m_pattern_hits{};
+  std::atomic<uint64_t> m_pattern_misses{};
+};
+}
+}
@@ -145,6 +145,14 @@ bool generic_node::remove_parameter()
   return false;
 }
 
+generic_node& generic_node::unsafe_create_child(std::string name)
+{
+  auto cld = std::make_unique<generic_node>(std::move(name), m_device, *this);
+  auto& res = *cld;
+  m_children.push_back(std::move(cld));
+  return res;
+}
+
 std::unique_ptr<ossia::net::node_base>
 generic_node::make_child(const std::string& name_base)
 {
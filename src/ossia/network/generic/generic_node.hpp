@@ -54,6 +54,15 @@ public:
       std::unique_ptr<ossia::net::parameter_base> addr) final override;
   bool remove_parameter() final override;
 
+  /**
+   * @brief Adds a child without locking nor notifying the device.
+   *
+   * Only for nodes that are not reachable from the device yet, e.g. when
+   * building a whole subtree before adding its root with add_child.
+   * The name is expected to be valid and not taken by a sibling.
+   */
+  generic_node& unsafe_create_child(std::string name);
+
 protected:
   std::unique_ptr<ossia::net::parameter_base> m_parameter;
 
@@ -21,8 +21,8 @@ generic_parameter::generic_parameter(ossia::net::node_base& node)
     , m_valueType(ossia::val_type::IMPULSE)
     , m_accessMode(ossia::access_mode::BI)
     , m_boundingMode(ossia::bounding_mode::FREE)
-    , m_value(ossia::impulse{})
 {
+  m_slot.store(ossia::impulse{});
 }
 
 generic_parameter::generic_parameter(
@@ -32,8 +32,8 @@ generic_parameter::generic_parameter(
     , m_valueType(ossia::val_type::IMPULSE)
     , m_accessMode(get_value_or(data.access, ossia::access_mode::BI))
     , m_boundingMode(get_value_or(data.bounding, ossia::bounding_mode::FREE))
-    , m_value(init_value(m_valueType))
 {
+  m_slot.store(init_value(m_valueType));
   m_repetitionFilter
       = get_value_or(data.rep_filter, ossia::repetition_filter::OFF);
   update_parameter_type(data.type, *this);
@@ -84,128 +84,105 @@ ossia::net::generic_parameter& generic_parameter::push_value()
   return *this;
 }
 
-const ossia::value& generic_parameter::getValue() const
+ossia::value generic_parameter::getValue() const
 {
-  return m_value;
+  return value();
 }
 
 ossia::value generic_parameter::value() const
 {
+  ossia::value v;
+  if (m_slot.load(v))
+    return v;
+
   lock_t lock(m_valueMutex);
+  return current_value_unsafe();
+}
 
+ossia::value generic_parameter::current_value_unsafe() const
+{
+  ossia::value v;
+  if (m_slot.load(v))
+    return v;
   return m_value;
 }
 
-ossia::value
-generic_parameter::set_value(const ossia::value& val)
+void generic_parameter::store_value_unsafe(ossia::value&& val)
 {
-  ossia::value copy;
-
-  if (val.valid())
+  if (value_slot::is_trivial(val))
   {
-    lock_t lock(m_valueMutex);
-    if (m_value.v.which() == val.v.which())
-    {
-      // TODO assess whether we would avoid an allocation on the return
-      // if doing copy = std::move(m_previousValue)
-      m_previousValue = std::move(m_value); // TODO also implement me for MIDI
-      m_value = val;
-      copy = val;
-    }
-    else
-    {
+    // The slot cannot hold the previous value if it was not trivial
+    if (m_slot.type() == value_slot::none)
       m_previousValue = std::move(m_value);
-      m_value = ossia::convert(val, m_previousValue);
-      copy = m_value;
-    }
+    m_slot.store(val);
+  }
+  else
+  {
+    if (m_slot.type() == value_slot::none)
+      m_previousValue = std::move(m_value); // TODO also implement me for MIDI
+    m_value = std::move(val);
+    m_slot.store_none();
   }
-  send(copy);
-
-  return copy;
 }
 
-ossia::value generic_parameter::set_value(ossia::value&& val)
+template <typename T>
+ossia::value generic_parameter::set_value_impl(T&& val)
 {
-  using namespace ossia;
-  ossia::value copy;
-  if (val.valid())
+  if (!val.valid())
+    return {};
+
+  // Same trivial type as the current value: no conversion, no lock.
+  // The type is checked again when storing, as it may have changed since.
+  const int which = val.v.which();
+  if (value_slot::is_trivial(which) && m_slot.type() == which
+      && m_slot.store_same_type(val))
   {
-    lock_t lock(m_valueMutex);
-    if (m_value.v.which() == val.v.which())
-    {
-      m_previousValue = std::move(m_value); // TODO also implement me for MIDI
-      m_value = std::move(val);
-      copy = m_value;
-    }
-    else
-    {
-      m_previousValue = std::move(m_value);
-      m_value = ossia::convert(std::move(val), m_previousValue);
-      copy = m_value;
-    }
+    return ossia::value{std::forward<T>(val)};
   }
 
-  send(copy);
+  lock_t lock(m_valueMutex);
+  ossia::value cur;
+  const ossia::value& cur_ref = m_slot.load(cur) ? cur : m_value;
+
+  ossia::value copy = (cur_ref.v.which() == which)
+                          ? ossia::value{std::forward<T>(val)}
+                          : ossia::convert(val, cur_ref);
+  store_value_unsafe(ossia::value{copy});
   return copy;
 }
 
-ossia::value generic_parameter::set_value_quiet(const ossia::value& val)
+ossia::value
+generic_parameter::set_value(const ossia::value& val)
 {
-  ossia::value copy;
-
-  if (val.valid())
-  {
-    lock_t lock(m_valueMutex);
-    if (m_value.v.which() == val.v.which())
-    {
-      // TODO assess whether we would avoid an allocation on the return
-      // if doing copy = std::move(m_previousValue)
-      m_previousValue = std::move(m_value); // TODO also implement me for MIDI
-      m_value = val;
-      copy = val;
-    }
-    else
-    {
-      m_previousValue = std::move(m_value);
-      m_value = ossia::convert(val, m_previousValue);
-      copy = m_value;
-    }
-  }
+  auto copy = set_value_impl(val);
+  send(copy);
+  return copy;
+}
 
+ossia::value generic_parameter::set_value(ossia::value&& val)
+{
+  auto copy = set_value_impl(std::move(val));
+  send(copy);
   return copy;
 }
 
-ossia::value generic_parameter::set_value_quiet(ossia::value&& val)
+ossia::value generic_parameter::set_value_quiet(const ossia::value& val)
 {
-  using namespace ossia;
-  ossia::value copy;
-  if (val.valid())
-  {
-    lock_t lock(m_valueMutex);
-    if (m_value.v.which() == val.v.which())
-    {
-      m_previousValue = std::move(m_value); // TODO also implement me for MIDI
-      m_value = std::move(val);
-      copy = m_value;
-    }
-    else
-    {
-      m_previousValue = std::move(m_value);
-      m_value = ossia::convert(std::move(val), m_previousValue);
-      copy = m_value;
-    }
-  }
+  return set_value_impl(val);
+}
 
-  return copy;
+ossia::value generic_parameter::set_value_quiet(ossia::value&& val)
+{
+  return set_value_impl(std::move(val));
 }
 
 void generic_parameter::set_value_quiet(const destination& destination)
 {
-  lock_t lock(m_valueMutex);
   if (destination.address().get_value_type() == m_valueType)
   {
-    m_previousValue = std::move(m_value); // TODO also implement me for MIDI
-    m_value = destination.address().fetch_value();
+    auto val = destination.address().fetch_value();
+    lock_t lock(m_valueMutex);
+    store_value_unsafe(std::move(val));
   }
   else
   {
@@ -231,7 +208,7 @@ generic_parameter::set_value_type(ossia::val_type type)
     // (int) mValueType << " <=== " << (int) type << std::endl;
     m_valueType = type;
 
-    m_value = init_value(type);
+    store_value_unsafe(init_value(type));
     if (m_domain)
     {
       convert_compatible_domain(m_domain, m_valueType);
@@ -293,9 +270,19 @@ generic_parameter::set_bounding(ossia::bounding_mode boundingMode)
 
 bool generic_parameter::filter_value(const ossia::value& val) const
 {
-  return m_disabled || m_muted
-         || (get_repetition_filter() == ossia::repetition_filter::ON
-             && val == m_previousValue);
+  if (m_disabled || m_muted)
+    return true;
+  if (get_repetition_filter() != ossia::repetition_filter::ON)
+    return false;
+
+  ossia::value prev;
+  if (m_slot.load_previous(prev))
+    return val == prev;
+
+  lock_t lock(m_valueMutex);
+  if (m_slot.load_previous(prev))
+    return val == prev;
+  return val == m_previousValue;
 }
 
 void generic_parameter::on_first_callback_added()
@@ -321,7 +308,8 @@ generic_parameter& generic_parameter::set_unit(const unit_t& v)
       if (vt != ossia::val_type::IMPULSE)
       {
         m_valueType = vt;
-        m_value = ossia::convert(m_value, m_valueType);
+        store_value_unsafe(
+            ossia::convert(current_value_unsafe(), m_valueType));
         if (m_domain)
         {
           convert_compatible_domain(m_domain, m_valueType);
@@ -7,6 +7,7 @@
 #include <ossia/network/domain/domain.hpp>
 #include <ossia/network/generic/generic_device.hpp>
 #include <ossia/network/value/value.hpp>
+#include <ossia/network/value/value_slot.hpp>
 
 #include <string>
 #include <thread>
@@ -31,6 +32,10 @@ protected:
   ossia::access_mode m_accessMode{};
   ossia::bounding_mode m_boundingMode{};
 
+  //! Current and previous values when they are trivially copyable.
+  ossia::value_slot m_slot;
+
+  //! Current and previous values when they are not in m_slot.
   mutable mutex_t m_valueMutex;
   ossia::value m_value;
 
@@ -52,7 +57,7 @@ public:
   ossia::net::generic_parameter& push_value(ossia::value&&) final override;
   ossia::net::generic_parameter& push_value() final override;
 
-  const ossia::value& getValue() const;
+  ossia::value getValue() const;
   ossia::value value() const final override;
   ossia::value set_value(const ossia::value&) override;
   ossia::value set_value(ossia::value&&) override;
@@ -86,6 +91,11 @@ public:
 
 private:
   friend struct update_parameter_visitor;
+
+  template <typename T>
+  ossia::value set_value_impl(T&& val);
+  ossia::value current_value_unsafe() const;
+  void store_value_unsafe(ossia::value&& val);
 };
 }
 }
@@ -6,6 +6,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/placeholders.hpp>
 
+#include <type_traits>
 #include <utility>
 
 namespace ossia
@@ -14,6 +15,19 @@ namespace net
 {
 using tcp = boost::asio::ip::tcp;
 
+//! Answers with an on_chunk(const char*, std::size_t) member receive the
+//! content as it arrives: only what remains is passed at the end.
+template <typename T, typename = void>
+struct has_http_chunk_callback : std::false_type
+{
+};
+template <typename T>
+struct has_http_chunk_callback<
+    T, std::void_t<decltype(std::declval<T&>().on_chunk(
+           std::declval<const char*>(), std::size_t{}))>> : std::true_type
+{
+};
+
 template <typename Fun, typename Err>
 class http_get_request
     : public std::enable_shared_from_this<http_get_request<Fun, Err>>
@@ -167,6 +181,7 @@ private:
       std::string header;
       while (std::getline(response_stream, header) && header != "\r")
         ;
+      read_chunk();
 
       // Start reading remaining data until EOF.
       boost::asio::async_read(
@@ -186,6 +201,8 @@ private:
   {
     if (!err)
     {
+      read_chunk();
+
       // Continue reading remaining data until EOF.
       boost::asio::async_read(
           m_socket, m_response, boost::asio::transfer_at_least(1),
@@ -213,6 +230,20 @@ private:
     }
   }
 
+  void read_chunk()
+  {
+    if constexpr (has_http_chunk_callback<Fun>::value)
+    {
+      const auto& dat = m_response.data();
+      const auto sz = dat.size();
+      if (sz > 0)
+      {
+        m_fun.on_chunk(static_cast<const char*>(dat.data()), sz);
+        m_response.consume(sz);
+      }
+    }
+  }
+
   tcp::resolver m_resolver;
   tcp::socket m_socket;
   boost::asio::streambuf m_response;
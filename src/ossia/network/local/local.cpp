@@ -136,4 +136,36 @@ void ossia::net::multiplex_protocol::clear()
 {
   m_protocols.clear();
 }
+
+static void copy_rec(const ossia::net::node_base& src, ossia::net::node_base& dst)
+{
+  dst.set_extended_attributes(src.get_extended_attributes());
+
+  if (auto param = src.get_parameter())
+  {
+    auto& p = *dst.create_parameter(param->get_value_type());
+    p.set_unit(param->get_unit());
+    p.set_domain(param->get_domain());
+    p.set_bounding(param->get_bounding());
+    p.set_access(param->get_access());
+    p.set_repetition_filter(param->get_repetition_filter());
+    p.set_critical(param->get_critical());
+    p.set_disabled(param->get_disabled());
+    p.set_muted(param->get_muted());
+    p.set_value_quiet(param->value());
+  }
+
+  for (auto& cld : src.children())
+  {
+    copy_rec(*cld, *dst.create_child(cld->get_name()));
+  }
+}
+
+std::unique_ptr<generic_device> make_local_copy(const device_base& dev)
+{
+  auto res = std::make_unique<generic_device>(
+      std::make_unique<multiplex_protocol>(), dev.get_name());
+  copy_rec(dev.get_root_node(), res->get_root_node());
+  return res;
+}
 }
@@ -3,6 +3,7 @@
 #include <ossia/detail/algorithms.hpp>
 #include <ossia/network/base/protocol.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace ossia
@@ -69,5 +70,16 @@ private:
 };
 
 using local_protocol = multiplex_protocol;
+
+/**
+ * @brief Copies the tree of a device in a new local device
+ *
+ * The copy has the same name, nodes, attributes, parameters and current
+ * values, but does not communicate with anything: it can stand in for a
+ * network device when the execution must not depend on the outside world,
+ * e.g. in tests or when rendering offline.
+ */
+OSSIA_EXPORT
+std::unique_ptr<generic_device> make_local_copy(const device_base& dev);
 }
 }
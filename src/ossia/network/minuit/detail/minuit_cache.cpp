@@ -0,0 +1,178 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/detail/json.hpp>
+#include <ossia/detail/logger.hpp>
+#include <ossia/network/base/node.hpp>
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/base/parameter.hpp>
+#include <ossia/network/dataspace/dataspace_visitors.hpp>
+#include <ossia/network/minuit/detail/minuit_cache.hpp>
+#include <ossia/network/minuit/detail/minuit_common.hpp>
+
+#include <rapidjson/stringbuffer.h>
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+namespace ossia
+{
+namespace minuit
+{
+// Increased when the format changes: older caches are then ignored
+static constexpr int namespace_cache_version = 1;
+
+static void write_node(ossia::json_writer& wr, const ossia::net::node_base& node)
+{
+  wr.StartObject();
+  wr.Key("address");
+  const auto addr = node.osc_address();
+  wr.String(addr.data(), addr.size());
+
+  if (auto param = node.get_parameter())
+  {
+    auto write_text = [&](const char* key, ossia::string_view text) {
+      wr.Key(key);
+      wr.String(text.data(), text.size());
+    };
+    write_text("type", to_minuit_type_text(param->get_value_type()));
+    write_text("service", to_minuit_service_text(param->get_access()));
+    write_text("rangeClipmode", to_minuit_bounding_text(param->get_bounding()));
+    write_text("dataspace", ossia::get_dataspace_text(param->get_unit()));
+    write_text("dataspaceUnit", ossia::get_unit_text(param->get_unit()));
+
+    wr.Key("repetitionsFilter");
+    wr.Int((int)param->get_repetition_filter());
+
+    if (auto prio = ossia::net::get_priority(node))
+    {
+      wr.Key("priority");
+      wr.Double(*prio);
+    }
+    if (auto desc = ossia::net::get_description(node))
+    {
+      write_text("description", *desc);
+    }
+  }
+  wr.EndObject();
+
+  for (const auto& child : node.children())
+    write_node(wr, *child);
+}
+
+bool write_namespace_cache(const ossia::net::node_base& root, const std::string& path)
+{
+  rapidjson::StringBuffer buffer;
+  ossia::json_writer wr{buffer};
+  wr.StartObject();
+  wr.Key("version");
+  wr.Int(namespace_cache_version);
+  wr.Key("nodes");
+  wr.StartArray();
+  for (const auto& child : root.children())
+    write_node(wr, *child);
+  wr.EndArray();
+  wr.EndObject();
+
+  std::ofstream f{path, std::ios::binary};
+  if (!f)
+    return false;
+  f.write(buffer.GetString(), buffer.GetSize());
+  return bool(f);
+}
+
+static void read_node(ossia::net::node_base& root, const rapidjson::Value& obj)
+{
+  auto addr_it = obj.FindMember("address");
+  if (addr_it == obj.MemberEnd() || !addr_it->value.IsString())
+    return;
+
+  auto& node = ossia::net::find_or_create_node(
+      root, get_string_view(addr_it->value));
+
+  auto type_it = obj.FindMember("type");
+  if (type_it == obj.MemberEnd() || !type_it->value.IsString())
+    return;
+
+  auto param = node.get_parameter();
+  if (!param)
+    param = node.create_parameter(
+        type_from_minuit_type_text(get_string_view(type_it->value)));
+  else
+    param->set_value_type(
+        type_from_minuit_type_text(get_string_view(type_it->value)));
+  if (!param)
+    return;
+
+  auto text = [&](const char* key) -> std::optional<ossia::string_view> {
+    auto it = obj.FindMember(key);
+    if (it != obj.MemberEnd() && it->value.IsString())
+      return get_string_view(it->value);
+    return std::nullopt;
+  };
+
+  if (auto t = text("service"))
+    param->set_access(from_minuit_service_text(*t));
+  if (auto t = text("rangeClipmode"))
+    param->set_bounding(from_minuit_bounding_text(*t));
+  if (auto t = text("dataspace"))
+    param->set_unit(ossia::parse_dataspace(*t));
+  if (auto t = text("dataspaceUnit"))
+    param->set_unit(ossia::parse_unit(*t, param->get_unit()));
+  if (auto t = text("description"))
+    ossia::net::set_description(node, std::string(*t));
+
+  auto rep_it = obj.FindMember("repetitionsFilter");
+  if (rep_it != obj.MemberEnd() && rep_it->value.IsInt())
+    param->set_repetition_filter(
+        static_cast<ossia::repetition_filter>(rep_it->value.GetInt()));
+
+  auto prio_it = obj.FindMember("priority");
+  if (prio_it != obj.MemberEnd() && prio_it->value.IsNumber())
+    ossia::net::set_priority(node, prio_it->value.GetDouble());
+}
+
+int read_namespace_cache(ossia::net::node_base& root, const std::string& path)
+try
+{
+  std::ifstream f{path, std::ios::binary};
+  if (!f)
+    return -1;
+
+  std::stringstream str;
+  str << f.rdbuf();
+  const auto content = str.str();
+
+  rapidjson::Document doc;
+  doc.Parse(content.data(), content.size());
+  if (doc.HasParseError() || !doc.IsObject())
+    return -1;
+
+  auto version = doc.FindMember("version");
+  if (version == doc.MemberEnd() || !version->value.IsInt()
+      || version->value.GetInt() != namespace_cache_version)
+    return -1;
+
+  auto nodes = doc.FindMember("nodes");
+  if (nodes == doc.MemberEnd() || !nodes->value.IsArray())
+    return -1;
+
+  int count = 0;
+  for (const auto& obj : nodes->value.GetArray())
+  {
+    if (obj.IsObject())
+    {
+      read_node(root, obj);
+      count++;
+    }
+  }
+  return count;
+}
+catch (const std::exception& e)
+{
+  ossia::logger().error("Minuit: could not read the namespace cache: {}", e.what());
+  return -1;
+}
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <string>
+
+namespace ossia
+{
+namespace net
+{
+class node_base;
+}
+namespace minuit
+{
+/**
+ * @brief Saves a mirrored Minuit namespace to a file
+ *
+ * The nodes are written with their parameter attributes,
+ * in the Minuit vocabulary (type, service, rangeClipmode...).
+ * Values and domains are not saved: they are queried again when
+ * connecting.
+ *
+ * @return false if the file could not be written
+ */
+OSSIA_EXPORT
+bool write_namespace_cache(const ossia::net::node_base& root, const std::string& path);
+
+/**
+ * @brief Recreates the nodes saved with write_namespace_cache.
+ *
+ * Existing nodes are kept and updated.
+ *
+ * @return the number of nodes read, or -1 if the file is missing or invalid.
+ */
+OSSIA_EXPORT
+int read_namespace_cache(ossia::net::node_base& root, const std::string& path);
+}
+}
@@ -613,7 +613,11 @@ struct minuit_behavior<minuit_command::Answer, minuit_operation::Namespace>
 
     // Find or create the node
     auto& n = ossia::net::find_or_create_node(dev.get_root_node(), address);
-    n.create_parameter(ossia::val_type::IMPULSE);
+
+    // Keep the parameter restored from the namespace cache, if any:
+    // its type is queried again below.
+    if (!n.get_parameter())
+      n.create_parameter(ossia::val_type::IMPULSE);
 
     // A data can also have child nodes :
     handle_container(proto, dev, address, beg_it, end_it);
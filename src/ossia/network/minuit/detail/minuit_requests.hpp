@@ -0,0 +1,139 @@
+#pragma once
+#include <ossia/detail/string_view.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <deque>
+#include <set>
+#include <string>
+
+namespace ossia
+{
+namespace minuit
+{
+enum class request_kind : uint8_t
+{
+  Namespace,
+  Get
+};
+
+/**
+ * @brief Namespace and get requests to send to a remote device
+ *
+ * At most `window` requests are in flight at once: the others wait until
+ * replies arrive. Namespace requests go first, so that the tree structure
+ * is known as soon as possible; get requests are sent in the order they
+ * were added, which keeps "type" and "dataspace" before the attributes
+ * whose parsing depends on them.
+ *
+ * An address is only requested once until its reply arrives.
+ *
+ * Not thread-safe.
+ */
+class request_queue
+{
+public:
+  static constexpr std::size_t default_window = 64;
+
+  explicit request_queue(std::size_t window = default_window) noexcept
+      : m_window{window}
+  {
+  }
+
+  //! Returns false if the same request is already pending or in flight
+  bool add(request_kind k, ossia::string_view address)
+  {
+    auto& known = m_known[int(k)];
+    if (known.find(address) != known.end())
+      return false;
+
+    known.emplace(address);
+    m_pending[int(k)].emplace_back(address);
+    return true;
+  }
+
+  //! Returns false if the request was not known
+  bool reply(request_kind k, ossia::string_view address)
+  {
+    auto& known = m_known[int(k)];
+    auto it = known.find(address);
+    if (it == known.end())
+      return false;
+
+    known.erase(it);
+
+    auto& in_flight = m_inFlight[int(k)];
+    if (auto fit = in_flight.find(address); fit != in_flight.end())
+      in_flight.erase(fit);
+    return true;
+  }
+
+  //! Calls f(kind, address) for each request that can be sent now
+  template <typename F>
+  void take_ready(F&& f)
+  {
+    for (auto k : {request_kind::Namespace, request_kind::Get})
+    {
+      auto& pending = m_pending[int(k)];
+      auto& known = m_known[int(k)];
+      while (!pending.empty() && in_flight_count() < m_window)
+      {
+        std::string addr = std::move(pending.front());
+        pending.pop_front();
+
+        // The reply may have come from an earlier request for this address
+        if (known.find(addr) == known.end())
+          continue;
+
+        f(k, ossia::string_view(addr));
+        m_inFlight[int(k)].insert(std::move(addr));
+      }
+    }
+  }
+
+  //! Calls f(kind, address) for each request sent but still unanswered
+  template <typename F>
+  void for_each_in_flight(F&& f) const
+  {
+    for (auto k : {request_kind::Namespace, request_kind::Get})
+      for (const auto& addr : m_inFlight[int(k)])
+        f(k, ossia::string_view(addr));
+  }
+
+  //! Requests pending or in flight
+  std::size_t size(request_kind k) const noexcept
+  {
+    return m_known[int(k)].size();
+  }
+
+  std::size_t in_flight_count() const noexcept
+  {
+    return m_inFlight[0].size() + m_inFlight[1].size();
+  }
+
+  bool empty() const noexcept
+  {
+    return m_known[0].empty() && m_known[1].empty();
+  }
+
+  void clear()
+  {
+    for (int k = 0; k < 2; k++)
+    {
+      m_pending[k].clear();
+      m_known[k].clear();
+      m_inFlight[k].clear();
+    }
+  }
+
+private:
+  using address_set = std::set<std::string, std::less<>>;
+
+  std::array<std::deque<std::string>, 2> m_pending;
+  // Pending or in flight
+  std::array<address_set, 2> m_known;
+  std::array<address_set, 2> m_inFlight;
+  std::size_t m_window{};
+};
+}
+}
@@ -3,6 +3,7 @@
 #include <ossia/detail/string_view.hpp>
 #include <ossia/network/base/parameter_data.hpp>
 #include <ossia/network/generic/generic_parameter.hpp>
+#include <ossia/network/minuit/detail/minuit_cache.hpp>
 #include <ossia/network/minuit/detail/minuit_common.hpp>
 #include <ossia/network/minuit/detail/minuit_parser.hpp>
 #include <ossia/network/minuit/minuit.hpp>
@@ -11,8 +12,12 @@
 #include <ossia/network/osc/detail/receiver.hpp>
 #include <ossia/network/osc/detail/sender.hpp>
 
+#include <oscpack/osc/OscOutboundPacketStream.h>
 #include <oscpack/osc/OscPrintReceivedElements.h>
 
+#include <array>
+#include <chrono>
+
 namespace ossia
 {
 namespace net
@@ -122,17 +127,40 @@ minuit_protocol& minuit_protocol::set_local_port(uint16_t out_port)
 
 bool minuit_protocol::update(ossia::net::node_base& node)
 {
-  // Reset node
-  node.clear_children();
-  node.remove_parameter();
+  const auto t0 = std::chrono::steady_clock::now();
+  const bool is_root = m_device && &node == &m_device->get_root_node();
+
+  // The tree saved last time is shown right away, and reconciled with
+  // what the device sends.
+  int cached = -1;
+  if (is_root && !m_namespaceCache.empty())
+    cached = ossia::minuit::read_namespace_cache(node, m_namespaceCache);
+
+  if (cached < 0)
+  {
+    // Reset node
+    node.clear_children();
+    node.remove_parameter();
+  }
+  else
+  {
+    logger().info("Minuit: {} nodes restored from {}", cached, m_namespaceCache);
+  }
 
   // Send "namespace" request
-  m_namespaceFinishedPromise = std::promise<void>{};
+  {
+    lock_type lock(m_requestMutex);
+    m_requests.clear();
+    m_discovered.clear();
+    m_namespaceFinished = false;
+    m_namespaceFinishedPromise = std::promise<void>{};
+  }
   auto fut = m_namespaceFinishedPromise.get_future();
 
   auto act
       = name_table.get_action(ossia::minuit::minuit_action::NamespaceRequest);
   namespace_refresh(act, node.osc_address());
+  send_requests();
 
   auto status = fut.wait_for(std::chrono::seconds(5));
   // Won't return as long as the tree exploration request haven't finished.
@@ -140,13 +168,7 @@ bool minuit_protocol::update(ossia::net::node_base& node)
   // If there are still un-explored nodes, we go for a second round
   if (status != std::future_status::ready)
   {
-    auto req = name_table.get_action(minuit::minuit_action::NamespaceRequest);
-    lock_type lock(m_nsRequestMutex);
-    for (const auto& addr : m_nsRequests)
-    {
-      m_sender->send(req, ossia::string_view(addr));
-    }
-    m_lastSentMessage = get_time();
+    resend_in_flight_requests();
   }
   // While messages are being received regularly, we wait.
   m_lastRecvMessage = get_time();
@@ -162,75 +184,72 @@ bool minuit_protocol::update(ossia::net::node_base& node)
   }
 
   auto check_unfinished = [&] {
-    lock_type lock(m_nsRequestMutex);
-    lock_type lock2(m_getRequestMutex);
-    return !m_nsRequests.empty() || !m_getRequests.empty()
-           || status != std::future_status::ready;
+    lock_type lock(m_requestMutex);
+    return !m_requests.empty() || status != std::future_status::ready;
   };
 
   if (check_unfinished())
   {
-    std::vector<std::string> nreq, greq;
     for (int i = 0; i < 100; i++)
     {
       status = fut.wait_for(std::chrono::milliseconds(250));
       if (!check_unfinished())
-      {
         break;
-      }
-      else
-      {
-        {
-          lock_type lock(m_nsRequestMutex);
-          nreq.clear();
-          ossia::copy(m_nsRequests, nreq);
-        }
-        for (const auto& req : nreq)
-        {
-          m_sender->send(
-              name_table.get_action(
-                  ossia::minuit::minuit_action::NamespaceRequest),
-              ossia::string_view(req));
-          std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-
-        {
-          lock_type lock(m_getRequestMutex);
-          greq.clear();
-          for(const auto& req : m_getRequests)
-            greq.push_back(req.first);
-        }
-        for (const auto& req : greq)
-        {
-          m_sender->send(
-              name_table.get_action(ossia::minuit::minuit_action::GetRequest),
-              ossia::string_view(req));
-          std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-      }
+
+      resend_in_flight_requests();
     }
   }
 
+  bool complete = false;
+  std::size_t discovered = 0;
   {
-    lock_type lock(m_nsRequestMutex);
-    for (const auto& node : m_nsRequests)
-    {
-      logger().error("Namespace request unmatched: {0}", node);
-    }
-    m_nsRequests.clear();
+    lock_type lock(m_requestMutex);
+    complete = m_requests.empty();
+    discovered = m_discovered.size();
+    m_requests.for_each_in_flight(
+        [](ossia::minuit::request_kind k, ossia::string_view addr) {
+          if (k == ossia::minuit::request_kind::Namespace)
+            logger().error("Namespace request unmatched: {0}", addr);
+          else
+            logger().error("Get request unmatched: {0}", addr);
+        });
+    m_requests.clear();
+    for (auto& p : m_getPromises)
+      p.second.set_value();
+    m_getPromises.clear();
   }
+
+  if (cached >= 0 && complete)
+    remove_undiscovered_nodes(node);
+
+  const auto t1 = std::chrono::steady_clock::now();
+  logger().info(
+      "Minuit: namespace of {} {} in {} ms ({} nodes)",
+      m_device ? m_device->get_name() : std::string{},
+      complete ? "received" : "partially received",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count(),
+      discovered);
+
+  if (is_root && complete && !m_namespaceCache.empty())
   {
-    lock_type lock(m_getRequestMutex);
-    for (const auto& node : m_getRequests)
-    {
-      logger().error("Namespace request unmatched: {0}", node.first);
-    }
-    m_getRequests.clear();
+    if (!ossia::minuit::write_namespace_cache(node, m_namespaceCache))
+      logger().error("Minuit: could not write {}", m_namespaceCache);
   }
 
   return status == std::future_status::ready || !node.children().empty();
 }
 
+void minuit_protocol::remove_undiscovered_nodes(ossia::net::node_base& node)
+{
+  for (auto child : node.children_copy())
+  {
+    if (m_discovered.find(child->osc_address()) == m_discovered.end())
+      node.remove_child(*child);
+    else
+      remove_undiscovered_nodes(*child);
+  }
+}
+
 void minuit_protocol::request(ossia::net::parameter_base& address)
 {
   auto act = name_table.get_action(ossia::minuit::minuit_action::GetRequest);
@@ -251,6 +270,7 @@ std::future<void> minuit_protocol::pull_async(parameter_base& address)
   addr += ":value";
 
   get_refresh(act, addr, std::move(promise));
+  send_requests();
 
   return fut;
 }
@@ -328,27 +348,20 @@ bool minuit_protocol::observe_quietly(
 void minuit_protocol::namespace_refresh(
     ossia::string_view req, const std::string& addr)
 {
-  lock_type lock(m_nsRequestMutex);
-  auto it = m_nsRequests.find(addr);
-  if (it == m_nsRequests.end())
-  {
-    m_nsRequests.insert(addr);
-    m_sender->send(req, ossia::string_view(addr));
-    m_lastSentMessage = get_time();
-  }
+  lock_type lock(m_requestMutex);
+  m_requests.add(ossia::minuit::request_kind::Namespace, addr);
 }
 
 void minuit_protocol::namespace_refreshed(ossia::string_view addr)
 {
-  lock_type lock(m_nsRequestMutex);
-  auto it = m_nsRequests.find(addr);
-  if (it != m_nsRequests.end())
-  {
-    m_nsRequests.erase(it);
-  }
+  lock_type lock(m_requestMutex);
+  m_requests.reply(ossia::minuit::request_kind::Namespace, addr);
+  m_discovered.emplace(addr);
 
-  if (m_nsRequests.empty())
+  if (m_requests.size(ossia::minuit::request_kind::Namespace) == 0
+      && !m_namespaceFinished)
   {
+    m_namespaceFinished = true;
     m_namespaceFinishedPromise.set_value();
   }
 }
@@ -356,26 +369,139 @@ void minuit_protocol::namespace_refreshed(ossia::string_view addr)
 void minuit_protocol::get_refresh(
     ossia::string_view req, const std::string& addr, std::promise<void>&& p)
 {
-  lock_type lock(m_getRequestMutex);
-  auto it = m_getRequests.find(addr);
-  if (it == m_getRequests.end())
   {
-    m_getRequests[addr] = std::move(p);
-    m_sender->send(req, ossia::string_view(addr));
-
-    m_lastSentMessage = get_time();
+    lock_type lock(m_requestMutex);
+    if (m_requests.add(ossia::minuit::request_kind::Get, addr))
+      m_getPromises[addr] = std::move(p);
   }
+  // Sent by the caller: the requests made while parsing a reply are
+  // sent together once the whole message is handled.
 }
 
 void minuit_protocol::get_refreshed(ossia::string_view addr)
 {
-  lock_type lock(m_getRequestMutex);
-  auto it = m_getRequests.find(addr);
-  if (it != m_getRequests.end())
+  lock_type lock(m_requestMutex);
+  m_requests.reply(ossia::minuit::request_kind::Get, addr);
+
+  auto it = m_getPromises.find(addr);
+  if (it != m_getPromises.end())
   {
     it.value().set_value();
-    m_getRequests.erase(it);
+    m_getPromises.erase(it);
+  }
+}
+
+void minuit_protocol::set_namespace_cache(std::string path)
+{
+  m_namespaceCache = std::move(path);
+}
+
+const std::string& minuit_protocol::get_namespace_cache() const noexcept
+{
+  return m_namespaceCache;
+}
+
+void minuit_protocol::send_requests()
+{
+  std::vector<std::pair<ossia::minuit::request_kind, std::string>> reqs;
+  {
+    lock_type lock(m_requestMutex);
+    m_requests.take_ready(
+        [&](ossia::minuit::request_kind k, ossia::string_view addr) {
+          reqs.emplace_back(k, addr);
+        });
+  }
+  send_bundled(reqs);
+}
+
+void minuit_protocol::resend_in_flight_requests()
+{
+  std::vector<std::pair<ossia::minuit::request_kind, std::string>> reqs;
+  {
+    lock_type lock(m_requestMutex);
+    m_requests.for_each_in_flight(
+        [&](ossia::minuit::request_kind k, ossia::string_view addr) {
+          reqs.emplace_back(k, addr);
+        });
   }
+  send_bundled(reqs);
+
+  // Requests which did not fit in the window yet
+  send_requests();
+}
+
+// Bundles are kept small enough to fit in a single UDP datagram
+static constexpr std::size_t max_bundle_size = 1400;
+
+static constexpr std::size_t osc_string_size(std::size_t n) noexcept
+{
+  return (n + 4) & ~std::size_t(3);
+}
+
+void minuit_protocol::send_bundled(
+    const std::vector<std::pair<minuit::request_kind, std::string>>& reqs)
+{
+  if (reqs.empty())
+    return;
+
+  // oscpack needs some room past the content for the type tags
+  std::array<char, 2 * max_bundle_size> buffer;
+  oscpack::OutboundPacketStream p{buffer.data(), buffer.size()};
+
+  // "#bundle" and the time tag
+  constexpr std::size_t bundle_header_size = 16;
+  std::size_t size = 0;
+
+  auto flush = [&] {
+    if (size == 0)
+      return;
+    p << oscpack::EndBundle();
+    try
+    {
+      m_sender->socket().Send(p.Data(), p.Size());
+    }
+    catch (...)
+    {
+    }
+    p.Clear();
+    size = 0;
+  };
+
+  for (const auto& [kind, addr] : reqs)
+  {
+    const auto act = name_table.get_action(
+        kind == minuit::request_kind::Namespace
+            ? minuit::minuit_action::NamespaceRequest
+            : minuit::minuit_action::GetRequest);
+
+    // Element size, address pattern, ",s" type tags, argument
+    const std::size_t message_size
+        = 4 + osc_string_size(act.size()) + 4 + osc_string_size(addr.size());
+    if (bundle_header_size + message_size > max_bundle_size)
+    {
+      m_sender->send(act, ossia::string_view(addr));
+      continue;
+    }
+
+    if (size + message_size > max_bundle_size)
+      flush();
+
+    if (size == 0)
+    {
+      p << oscpack::BeginBundleImmediate();
+      size = bundle_header_size;
+    }
+
+    p << oscpack::BeginMessageN(act) << ossia::string_view(addr)
+      << oscpack::EndMessage();
+    size += message_size;
+
+    if (m_logger.outbound_logger)
+      m_logger.outbound_logger->info("Out: {} {}", act, addr);
+  }
+  flush();
+
+  m_lastSentMessage = get_time();
 }
 
 osc::sender<osc_1_0_outbound_stream_visitor>& minuit_protocol::sender() const
@@ -403,6 +529,9 @@ void minuit_protocol::on_received_message(
   }
 
   m_lastRecvMessage = get_time();
+
+  // New requests may have been made while handling a reply
+  send_requests();
 }
 
 void minuit_protocol::update_zeroconf()
@@ -4,6 +4,7 @@
 #include <ossia/network/base/listening.hpp>
 #include <ossia/network/base/protocol.hpp>
 #include <ossia/network/minuit/detail/minuit_name_table.hpp>
+#include <ossia/network/minuit/detail/minuit_requests.hpp>
 #include <ossia/network/value/value.hpp>
 #include <ossia/network/zeroconf/zeroconf.hpp>
 
@@ -79,6 +80,16 @@ public:
   void get_refresh(ossia::string_view req, const std::string& addr, std::promise<void>&& p);
   void get_refreshed(ossia::string_view req);
 
+  /**
+   * @brief File where the discovered namespace is saved.
+   *
+   * When set, the next call to update() first recreates the tree from
+   * this file, then reconciles it with the remote device: nodes that the
+   * device does not have anymore are removed once the discovery is complete.
+   */
+  void set_namespace_cache(std::string path);
+  const std::string& get_namespace_cache() const noexcept;
+
   osc::sender<osc_1_0_outbound_stream_visitor>& sender() const;
   ossia::minuit::name_table name_table;
 
@@ -88,6 +99,13 @@ private:
 
   void update_zeroconf();
 
+  // Sends the requests which fit in the window, bundled together
+  void send_requests();
+  void resend_in_flight_requests();
+  void send_bundled(
+      const std::vector<std::pair<minuit::request_kind, std::string>>& reqs);
+  void remove_undiscovered_nodes(ossia::net::node_base& node);
+
   std::string m_localName;
   std::string m_ip;
   uint16_t m_remotePort{}; /// the port that a remote device opens
@@ -97,13 +115,16 @@ private:
   listened_parameters m_listening;
 
   std::promise<void> m_namespaceFinishedPromise;
+  bool m_namespaceFinished{};
   ossia::net::device_base* m_device{};
 
-  mutex_t m_nsRequestMutex;
-  std::set<std::string, std::less<>> m_nsRequests;
+  mutex_t m_requestMutex;
+  minuit::request_queue m_requests;
+  ossia::string_map<std::promise<void>> m_getPromises;
 
-  mutex_t m_getRequestMutex;
-  ossia::string_map<std::promise<void>> m_getRequests;
+  // Addresses answered during the current discovery
+  std::set<std::string, std::less<>> m_discovered;
+  std::string m_namespaceCache;
 
   std::unique_ptr<osc::sender<osc_1_0_outbound_stream_visitor>> m_sender;
   std::unique_ptr<osc::receiver> m_receiver;
@@ -4,6 +4,7 @@
 #include <ossia/network/base/listening.hpp>
 #include <ossia/network/base/message_origin_identifier.hpp>
 #include <ossia/network/base/parameter.hpp>
+#include <ossia/network/common/address_index.hpp>
 #include <ossia/network/common/network_logger.hpp>
 #include <ossia/network/osc/detail/osc.hpp>
 
@@ -90,7 +91,8 @@ void on_input_message(
   else
   {
     // We still want to save the value even if it is not listened to.
-    if (auto n = find_node(dev.get_root_node(), addr_txt))
+    auto& index = dev.get_address_index();
+    if (auto n = index.find_node(addr_txt))
     {
       if (auto base_addr = n->get_parameter())
       {
@@ -103,7 +105,8 @@ void on_input_message(
     else
     {
       // Try to handle pattern matching
-      auto nodes = find_nodes(dev.get_root_node(), addr_txt);
+      ossia::net::address_index::node_list nodes;
+      index.find_nodes(addr_txt, nodes);
       for (auto n : nodes)
       {
         if (auto addr = n->get_parameter())
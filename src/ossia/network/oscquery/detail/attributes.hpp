@@ -187,6 +187,10 @@ constexpr auto rename_node()
 {
   constexpr_return(ossia::make_string_view("RENAME_NODE"));
 }
+constexpr auto binary_namespace()
+{
+  constexpr_return(ossia::make_string_view("BINARY_NAMESPACE"));
+}
 constexpr auto node_name()
 {
   constexpr_return(ossia::make_string_view("NAME"));
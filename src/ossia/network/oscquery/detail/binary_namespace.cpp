@@ -0,0 +1,645 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/network/base/node.hpp>
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/base/parameter.hpp>
+#include <ossia/network/dataspace/dataspace_visitors.hpp>
+#include <ossia/network/domain/domain.hpp>
+#include <ossia/network/exceptions.hpp>
+#include <ossia/network/generic/generic_node.hpp>
+#include <ossia/network/oscquery/detail/binary_namespace.hpp>
+#include <ossia/network/value/value.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace ossia
+{
+namespace oscquery
+{
+namespace
+{
+constexpr char binary_namespace_magic[4] = {'O', 'S', 'Q', 'B'};
+// Increased when the format changes
+constexpr uint8_t binary_namespace_version = 1;
+constexpr std::size_t header_size = sizeof(binary_namespace_magic) + 1;
+// Deeper lists are rejected when reading
+constexpr int max_list_depth = 32;
+
+enum node_flags : uint8_t
+{
+  has_parameter = 1 << 0,
+  has_description = 1 << 1,
+  has_tags = 1 << 2,
+  has_priority = 1 << 3,
+  has_extended_type = 1 << 4,
+  has_default_value = 1 << 5,
+  is_hidden = 1 << 6
+};
+
+enum parameter_flags : uint8_t
+{
+  is_critical = 1 << 0,
+  is_disabled = 1 << 1,
+  is_muted = 1 << 2,
+  has_domain = 1 << 3
+};
+
+// Integers are little-endian whatever the platform
+struct binary_writer
+{
+  std::string& out;
+
+  void u8(uint8_t v)
+  {
+    out.push_back(char(v));
+  }
+
+  void u32(uint32_t v)
+  {
+    char b[4]{char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+    out.append(b, 4);
+  }
+
+  void varint(uint64_t v)
+  {
+    while (v >= 0x80)
+    {
+      out.push_back(char((v & 0x7F) | 0x80));
+      v >>= 7;
+    }
+    out.push_back(char(v));
+  }
+
+  void f32(float v)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &v, 4);
+    u32(bits);
+  }
+
+  void string(ossia::string_view s)
+  {
+    varint(s.size());
+    out.append(s.data(), s.size());
+  }
+
+  void value(const ossia::value& v)
+  {
+    u8(uint8_t(v.get_type()));
+    v.apply(*this);
+  }
+
+  void operator()(ossia::impulse) { }
+  void operator()(int v) { u32(uint32_t(v)); }
+  void operator()(float v) { f32(v); }
+  void operator()(bool v) { u8(v); }
+  void operator()(char v) { u8(uint8_t(v)); }
+  void operator()(const std::string& v) { string(v); }
+
+  template <std::size_t N>
+  void operator()(const std::array<float, N>& v)
+  {
+    for (float f : v)
+      f32(f);
+  }
+
+  void operator()(const std::vector<ossia::value>& v)
+  {
+    varint(v.size());
+    for (const auto& e : v)
+      value(e);
+  }
+
+  void operator()() { }
+};
+
+struct binary_cursor
+{
+  const char* ptr{};
+  const char* end{};
+
+  void require(std::size_t n) const
+  {
+    if (std::size_t(end - ptr) < n)
+      throw ossia::parse_error{"Binary namespace: truncated record"};
+  }
+
+  uint8_t u8()
+  {
+    require(1);
+    return uint8_t(*ptr++);
+  }
+
+  uint32_t u32()
+  {
+    require(4);
+    auto b = reinterpret_cast<const unsigned char*>(ptr);
+    ptr += 4;
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16)
+           | (uint32_t(b[3]) << 24);
+  }
+
+  uint64_t varint()
+  {
+    uint64_t v{};
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      const auto b = u8();
+      v |= uint64_t(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        return v;
+    }
+    throw ossia::parse_error{"Binary namespace: invalid integer"};
+  }
+
+  //! For the element counts: each element takes at least one byte
+  std::size_t count()
+  {
+    const auto n = varint();
+    require(n);
+    return n;
+  }
+
+  float f32()
+  {
+    const uint32_t bits = u32();
+    float v;
+    std::memcpy(&v, &bits, 4);
+    return v;
+  }
+
+  std::string string()
+  {
+    const auto n = count();
+    std::string s(ptr, n);
+    ptr += n;
+    return s;
+  }
+
+  template <std::size_t N>
+  std::array<float, N> vec()
+  {
+    std::array<float, N> v;
+    for (float& f : v)
+      f = f32();
+    return v;
+  }
+
+  ossia::value value(int depth = 0)
+  {
+    switch (ossia::val_type(u8()))
+    {
+      case ossia::val_type::FLOAT:
+        return f32();
+      case ossia::val_type::INT:
+        return int32_t(u32());
+      case ossia::val_type::VEC2F:
+        return vec<2>();
+      case ossia::val_type::VEC3F:
+        return vec<3>();
+      case ossia::val_type::VEC4F:
+        return vec<4>();
+      case ossia::val_type::IMPULSE:
+        return ossia::impulse{};
+      case ossia::val_type::BOOL:
+        return u8() != 0;
+      case ossia::val_type::STRING:
+        return string();
+      case ossia::val_type::LIST:
+      {
+        if (depth >= max_list_depth)
+          throw ossia::parse_error{"Binary namespace: list too deep"};
+
+        std::vector<ossia::value> v;
+        const auto n = count();
+        v.reserve(n);
+        for (std::size_t i = 0; i < n; i++)
+          v.push_back(value(depth + 1));
+        return v;
+      }
+      case ossia::val_type::CHAR:
+        return char(u8());
+      case ossia::val_type::NONE:
+        return ossia::value{};
+      default:
+        throw ossia::parse_error{"Binary namespace: invalid value type"};
+    }
+  }
+};
+
+void write_parameter(binary_writer& w, const ossia::net::parameter_base& p)
+{
+  w.u8(uint8_t(p.get_value_type()));
+  w.u8(uint8_t(p.get_access()));
+  w.u8(uint8_t(p.get_bounding()));
+  w.u8(uint8_t(p.get_repetition_filter()));
+
+  const auto& dom = p.get_domain();
+  uint8_t flags{};
+  if (p.get_critical())
+    flags |= is_critical;
+  if (p.get_disabled())
+    flags |= is_disabled;
+  if (p.get_muted())
+    flags |= is_muted;
+  if (dom)
+    flags |= has_domain;
+  w.u8(flags);
+
+  if (const auto& unit = p.get_unit())
+    w.string(ossia::get_pretty_unit_text(unit));
+  else
+    w.string({});
+
+  w.value(p.value());
+
+  if (dom)
+  {
+    w.value(ossia::get_min(dom));
+    w.value(ossia::get_max(dom));
+    w(ossia::get_values(dom));
+  }
+}
+
+void write_node(
+    binary_writer& w, const ossia::net::node_base& node, std::size_t parent,
+    std::size_t& index)
+{
+  const auto self = index++;
+
+  // The size is known once the record is written
+  const auto size_pos = w.out.size();
+  w.u32(0);
+
+  w.varint(parent);
+  w.string(node.get_name());
+
+  const auto param = node.get_parameter();
+  const auto desc = ossia::net::get_description(node);
+  const auto tags = ossia::net::get_tags(node);
+  const auto prio = ossia::net::get_priority(node);
+  const auto ext = ossia::net::get_extended_type(node);
+  const auto def = ossia::net::get_default_value(node);
+
+  uint8_t flags{};
+  if (param)
+    flags |= has_parameter;
+  if (desc)
+    flags |= has_description;
+  if (tags)
+    flags |= has_tags;
+  if (prio)
+    flags |= has_priority;
+  if (ext)
+    flags |= has_extended_type;
+  if (def)
+    flags |= has_default_value;
+  if (ossia::net::get_hidden(node))
+    flags |= is_hidden;
+  w.u8(flags);
+
+  if (param)
+    write_parameter(w, *param);
+  if (desc)
+    w.string(*desc);
+  if (tags)
+  {
+    w.varint(tags->size());
+    for (const auto& tag : *tags)
+      w.string(tag);
+  }
+  if (prio)
+    w.f32(*prio);
+  if (ext)
+    w.string(*ext);
+  if (def)
+    w.value(*def);
+
+  const auto record_size = uint32_t(w.out.size() - size_pos - 4);
+  std::string size;
+  binary_writer{size}.u32(record_size);
+  std::copy(size.begin(), size.end(), w.out.begin() + size_pos);
+
+  for (const auto& child : node.children())
+    write_node(w, *child, self, index);
+}
+
+struct parameter_record
+{
+  ossia::val_type type{};
+  ossia::access_mode access{};
+  ossia::bounding_mode bounding{};
+  ossia::repetition_filter filter{};
+  uint8_t flags{};
+  std::string unit;
+  ossia::value value;
+  std::optional<ossia::domain> domain;
+};
+
+parameter_record read_parameter(binary_cursor& c)
+{
+  const auto type = c.u8();
+  const auto access = c.u8();
+  const auto bounding = c.u8();
+  const auto filter = c.u8();
+  const auto flags = c.u8();
+  if (type > uint8_t(ossia::val_type::CHAR)
+      || access > uint8_t(ossia::access_mode::SET)
+      || bounding > uint8_t(ossia::bounding_mode::HIGH))
+    throw ossia::parse_error{"Binary namespace: invalid parameter"};
+
+  parameter_record p;
+  p.type = ossia::val_type(type);
+  p.access = ossia::access_mode(access);
+  p.bounding = ossia::bounding_mode(bounding);
+  p.filter = ossia::repetition_filter(filter != 0);
+  p.flags = flags;
+  p.unit = c.string();
+  p.value = c.value();
+
+  if (flags & has_domain)
+  {
+    auto min = c.value();
+    auto max = c.value();
+    std::vector<ossia::value> values;
+    const auto n = c.count();
+    values.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+      values.push_back(c.value());
+
+    ossia::domain dom;
+    if (!min.valid() && !max.valid() && !values.empty())
+    {
+      dom = ossia::make_domain(values);
+    }
+    else
+    {
+      dom = ossia::make_domain(min, max);
+      if (!values.empty())
+        ossia::set_values(dom, values);
+    }
+    p.domain = std::move(dom);
+  }
+  return p;
+}
+
+void apply_parameter(ossia::net::node_base& node, parameter_record&& r)
+{
+  auto p = node.create_parameter(r.type);
+  if (!p)
+    return;
+
+  p->set_access(r.access);
+  p->set_bounding(r.bounding);
+  p->set_repetition_filter(r.filter);
+  if (r.flags & is_critical)
+    p->set_critical(true);
+  if (r.flags & is_disabled)
+    p->set_disabled(true);
+  if (r.flags & is_muted)
+    p->set_muted(true);
+  if (!r.unit.empty())
+    p->set_unit(ossia::parse_pretty_unit(r.unit));
+
+  if (r.value.valid())
+    p->set_value(std::move(r.value));
+
+  if (r.domain)
+    p->set_domain(*r.domain);
+}
+}
+
+// The parameter and attributes of a node, as read from its record
+struct binary_namespace_reader::node_record
+{
+  ossia::net::node_base* node{};
+  uint8_t flags{};
+  parameter_record parameter;
+  std::string description;
+  ossia::net::tags tags;
+  float priority{};
+  std::string extended_type;
+  ossia::value default_value;
+
+  void read(binary_cursor& c)
+  {
+    if (flags & has_parameter)
+      parameter = read_parameter(c);
+    if (flags & has_description)
+      description = c.string();
+    if (flags & has_tags)
+    {
+      const auto n = c.count();
+      tags.reserve(n);
+      for (std::size_t i = 0; i < n; i++)
+        tags.push_back(c.string());
+    }
+    if (flags & has_priority)
+      priority = c.f32();
+    if (flags & has_extended_type)
+      extended_type = c.string();
+    if (flags & has_default_value)
+      default_value = c.value();
+  }
+
+  void apply()
+  {
+    if (flags & has_parameter)
+      apply_parameter(*node, std::move(parameter));
+    if (flags & has_description)
+      ossia::net::set_description(*node, std::move(description));
+    if (flags & has_tags)
+      ossia::net::set_tags(*node, std::move(tags));
+    if (flags & has_priority)
+      ossia::net::set_priority(*node, priority);
+    if (flags & has_extended_type)
+      ossia::net::set_extended_type(*node, std::move(extended_type));
+    if (flags & has_default_value)
+      ossia::net::set_default_value(*node, std::move(default_value));
+    if (flags & is_hidden)
+      ossia::net::set_hidden(*node, true);
+  }
+};
+
+std::string write_binary_namespace(const ossia::net::node_base& root)
+{
+  std::string out;
+  out.reserve(4096);
+  out.append(binary_namespace_magic, sizeof(binary_namespace_magic));
+  out.push_back(char(binary_namespace_version));
+
+  binary_writer w{out};
+  std::size_t index = 0;
+  write_node(w, root, 0, index);
+  return out;
+}
+
+binary_namespace_reader::binary_namespace_reader(ossia::net::node_base& root)
+    : m_root{&root}
+    , m_genericRoot{dynamic_cast<ossia::net::generic_node*>(&root)}
+{
+}
+
+binary_namespace_reader::binary_namespace_reader(
+    binary_namespace_reader&&) noexcept
+    = default;
+
+binary_namespace_reader::~binary_namespace_reader() = default;
+
+void binary_namespace_reader::feed(const char* data, std::size_t size)
+{
+  m_buffer.append(data, size);
+
+  std::size_t pos = 0;
+  if (!m_header)
+  {
+    if (m_buffer.size() < header_size)
+      return;
+    read_header();
+    pos = header_size;
+  }
+
+  while (m_buffer.size() - pos >= 4)
+  {
+    binary_cursor c{m_buffer.data() + pos, m_buffer.data() + pos + 4};
+    const auto record_size = c.u32();
+    if (m_buffer.size() - pos - 4 < record_size)
+      break;
+
+    pos += 4;
+    read_record(m_buffer.data() + pos, record_size);
+    pos += record_size;
+  }
+
+  m_buffer.erase(0, pos);
+}
+
+void binary_namespace_reader::finish()
+{
+  if (!m_header || m_nodes.empty() || !m_buffer.empty())
+    throw ossia::parse_error{"Binary namespace: incomplete data"};
+
+  attach_subtree();
+}
+
+void binary_namespace_reader::read_header()
+{
+  if (std::memcmp(
+          m_buffer.data(), binary_namespace_magic,
+          sizeof(binary_namespace_magic))
+      != 0)
+    throw ossia::parse_error{"Binary namespace: invalid header"};
+  if (uint8_t(m_buffer[sizeof(binary_namespace_magic)])
+      != binary_namespace_version)
+    throw ossia::parse_error{"Binary namespace: unsupported version"};
+
+  m_header = true;
+}
+
+void binary_namespace_reader::read_record(const char* data, std::size_t size)
+{
+  binary_cursor c{data, data + size};
+  const auto parent = c.varint();
+  auto name = c.string();
+  const auto flags = c.u8();
+
+  ossia::net::node_base* node{};
+  if (m_nodes.empty())
+  {
+    // The requested node itself: its name is not changed
+    node = m_root;
+    node->clear_children();
+    node->remove_parameter();
+  }
+  else
+  {
+    if (parent >= m_nodes.size())
+      throw ossia::parse_error{"Binary namespace: invalid parent"};
+    if (name.empty())
+      throw ossia::parse_error{"Binary namespace: empty name"};
+    node = create_node(parent, std::move(name));
+  }
+
+  m_nodes.push_back(node);
+
+  node_record r;
+  r.node = node;
+  r.flags = flags;
+  r.read(c);
+
+  // e.g. the subtree could not be added to the device
+  if (!node)
+    return;
+
+  // The device is told about the parameters and attributes of a subtree
+  // being built only once it has been added
+  if (m_subtree && m_nodes.size() - 1 >= m_subtreeIndex)
+    m_pending.push_back(std::move(r));
+  else
+    r.apply();
+}
+
+ossia::net::node_base*
+binary_namespace_reader::create_node(std::size_t parent, std::string name)
+{
+  auto p = m_nodes[parent];
+  if (!p)
+    return nullptr;
+
+  if (!m_genericRoot)
+    return p->create_child(std::move(name));
+
+  if (parent == 0)
+  {
+    // A new subtree starts: the previous one is complete.
+    // add_child only accepts the names that are already sanitized.
+    attach_subtree();
+    name = ossia::net::sanitize_name(
+        std::move(name), m_genericRoot->children_names());
+    m_subtree = std::make_unique<ossia::net::generic_node>(
+        std::move(name), m_genericRoot->get_device(), *m_genericRoot);
+    m_subtreeIndex = m_nodes.size();
+    return m_subtree.get();
+  }
+
+  if (m_subtree && parent >= m_subtreeIndex)
+  {
+    // Not reachable from the device yet: no lock nor signal, but the names
+    // coming from the remote are checked as create_child would
+    auto& gp = *static_cast<ossia::net::generic_node*>(p);
+    ossia::net::sanitize_name(name, gp.unsafe_children());
+    return &gp.unsafe_create_child(std::move(name));
+  }
+
+  return p->create_child(std::move(name));
+}
+
+void binary_namespace_reader::attach_subtree()
+{
+  if (!m_subtree)
+    return;
+
+  // add_child destroys the nodes it refuses: check beforehand, so that they
+  // can be removed properly
+  auto& dev = m_genericRoot->get_device();
+  const auto& name = m_subtree->get_name();
+  if (dev.get_capabilities().change_tree
+      && name == ossia::net::sanitize_name(name, m_genericRoot->children_names())
+      && m_genericRoot->add_child(std::move(m_subtree)))
+  {
+    for (auto& r : m_pending)
+      r.apply();
+    m_pending.clear();
+    return;
+  }
+
+  // Nothing has been announced yet: the nodes are simply dropped
+  m_pending.clear();
+  m_subtree.reset();
+  std::fill(m_nodes.begin() + m_subtreeIndex, m_nodes.end(), nullptr);
+}
+}
+}
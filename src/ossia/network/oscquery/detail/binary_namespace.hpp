@@ -0,0 +1,90 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ossia
+{
+namespace net
+{
+class node_base;
+class generic_node;
+}
+namespace oscquery
+{
+/**
+ * @brief Binary snapshot of a namespace
+ *
+ * Compact alternative to the JSON namespace reply, negotiated with the
+ * BINARY_NAMESPACE extension of HOST_INFO and requested with
+ * `/path?BINARY_NAMESPACE`.
+ *
+ * The snapshot starts with a small header, followed by one record per node,
+ * depth-first. Each record is prefixed by its size, and refers to its parent
+ * by index: the first record is the requested node itself, so a reader can
+ * create the nodes as soon as their record has arrived.
+ *
+ * Only meant to be exchanged between ossia peers: values, domains and units
+ * are written in the ossia data model and not as OSC typetags.
+ */
+OSSIA_EXPORT
+std::string write_binary_namespace(const ossia::net::node_base& root);
+
+/**
+ * @brief Recreates a namespace from a binary snapshot, incrementally
+ *
+ * The existing children and parameter of the node are replaced,
+ * as with json_parser::parse_namespace.
+ *
+ * If the node is a generic_node, each subtree below it is built before
+ * being added to the device: its nodes are created without locking, and
+ * the device is only notified of them once the subtree has been added.
+ *
+ * Throws ossia::parse_error on malformed data.
+ */
+class OSSIA_EXPORT binary_namespace_reader
+{
+public:
+  explicit binary_namespace_reader(ossia::net::node_base& root);
+  binary_namespace_reader(binary_namespace_reader&&) noexcept;
+  ~binary_namespace_reader();
+
+  //! Reads the complete records, and keeps the rest for the next call
+  void feed(const char* data, std::size_t size);
+
+  //! To call once all the data has been received
+  void finish();
+
+  //! Number of nodes read, including the root
+  std::size_t nodes() const noexcept
+  {
+    return m_nodes.size();
+  }
+
+private:
+  void read_header();
+  void read_record(const char* data, std::size_t size);
+  ossia::net::node_base* create_node(std::size_t parent, std::string name);
+  void attach_subtree();
+
+  struct node_record;
+
+  ossia::net::node_base* m_root{};
+  ossia::net::generic_node* m_genericRoot{};
+
+  std::string m_buffer;
+  bool m_header{};
+
+  std::vector<ossia::net::node_base*> m_nodes;
+
+  // Subtree being built below a generic root, and the index of its root
+  std::unique_ptr<ossia::net::generic_node> m_subtree;
+  std::size_t m_subtreeIndex{};
+
+  // Parameters and attributes of the subtree, set once it has been added
+  std::vector<node_record> m_pending;
+};
+}
+}
@@ -2,6 +2,7 @@
 #include <ossia/detail/small_vector.hpp>
 #include <ossia/detail/string_map.hpp>
 #include <ossia/network/exceptions.hpp>
+#include <ossia/network/oscquery/detail/binary_namespace.hpp>
 #include <ossia/network/oscquery/detail/html_writer.hpp>
 #include <ossia/network/oscquery/detail/json_writer.hpp>
 #include <ossia/network/oscquery/detail/outbound_visitor.hpp>
@@ -111,6 +112,16 @@ public:
             return static_html_builder{}.build_tree(*node);
           }
 
+          // BINARY_NAMESPACE
+          auto binary_it = parameters.find(detail::binary_namespace());
+          if (binary_it != parameters.end())
+          {
+            ossia::net::server_reply rep;
+            rep.type = ossia::net::server_reply::data_type::binary;
+            rep.data = write_binary_namespace(*node);
+            return rep;
+          }
+
           // ADD_NODE
           auto add_instance_it = parameters.find(detail::add_node());
           if (add_instance_it != parameters.end())
@@ -553,6 +553,9 @@ json_writer::query_host_info(const std::string& name, const int osc_port)
   wr.Key("ECHO");
   wr.Bool(true);
 
+  write_json_key(wr, detail::binary_namespace());
+  wr.Bool(true);
+
   wr.Key(detail::path_changed());
   wr.Bool(false);
   wr.Key(detail::path_renamed());
@@ -0,0 +1,140 @@
+#pragma once
+#include <ossia/detail/mutex.hpp>
+#include <ossia/detail/string_map.hpp>
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ossia
+{
+namespace oscquery
+{
+//! An encoded message, shared by all the clients it is sent to.
+using shared_payload = std::shared_ptr<const std::string>;
+
+/**
+ * @brief Messages waiting to be sent to a client
+ *
+ * Filled by the threads which push values, emptied by the network thread.
+ *
+ * Non-critical values are coalesced per address: a client which falls
+ * behind only gets the latest value of each address.
+ * Critical values are all kept, in order.
+ * Past max_size pending messages, new ones are dropped.
+ */
+class outbound_queue
+{
+public:
+  struct message
+  {
+    shared_payload payload;
+    bool critical{};
+  };
+
+  static constexpr std::size_t max_size = 4096;
+
+  /**
+   * @brief Adds a message to the queue.
+   *
+   * @return true if the caller must schedule a call to \ref consume:
+   * it is the case for the first message pushed after the last consume.
+   */
+  bool push(std::string_view address, shared_payload p, bool critical)
+  {
+    lock_t lock(m_mutex);
+    if (!critical)
+    {
+      auto it = m_index.find(address);
+      if (it != m_index.end())
+      {
+        auto& slot = it.value();
+        if (slot.generation == m_generation)
+        {
+          m_messages[slot.index].payload = std::move(p);
+          return false;
+        }
+
+        if (!enqueue(std::move(p), false))
+          return false;
+        slot = {m_generation, m_messages.size() - 1};
+      }
+      else
+      {
+        if (!enqueue(std::move(p), false))
+          return false;
+
+        // Stale addresses are forgotten from time to time
+        if (m_index.size() > 4 * max_size)
+          m_index.clear();
+        m_index.insert({std::string(address), {m_generation, m_messages.size() - 1}});
+      }
+    }
+    else
+    {
+      if (!enqueue(std::move(p), true))
+        return false;
+    }
+
+    return std::exchange(m_scheduled, true) == false;
+  }
+
+  /**
+   * @brief Calls f on every pending message, in order, and empties the queue.
+   *
+   * Must always be called from the same thread.
+   * The queue is not locked while f runs.
+   */
+  template <typename F>
+  void consume(F&& f)
+  {
+    {
+      lock_t lock(m_mutex);
+      std::swap(m_messages, m_sending);
+      m_generation++;
+      m_scheduled = false;
+    }
+
+    for (const message& m : m_sending)
+      f(m);
+    m_sending.clear();
+  }
+
+  //! Number of messages dropped since the last call
+  std::size_t take_dropped() noexcept
+  {
+    lock_t lock(m_mutex);
+    return std::exchange(m_dropped, 0);
+  }
+
+private:
+  bool enqueue(shared_payload&& p, bool critical)
+  {
+    if (m_messages.size() >= max_size)
+    {
+      m_dropped++;
+      return false;
+    }
+    m_messages.push_back({std::move(p), critical});
+    return true;
+  }
+
+  struct slot
+  {
+    uint64_t generation{};
+    std::size_t index{};
+  };
+
+  mutex_t m_mutex;
+  std::vector<message> m_messages;
+  string_map<slot> m_index;
+  uint64_t m_generation{1};
+  std::size_t m_dropped{};
+  bool m_scheduled{};
+
+  std::vector<message> m_sending;
+};
+}
+}
@@ -4,6 +4,7 @@
 #include <ossia/network/oscquery/oscquery_server.hpp>
 #include <ossia/network/common/network_logger.hpp>
 #include <ossia/network/osc/detail/sender.hpp>
+#include <ossia/network/oscquery/detail/outbound_queue.hpp>
 #include <ossia/network/oscquery/detail/outbound_visitor.hpp>
 #include <ossia/network/sockets/websocket_server.hpp>
 
@@ -27,9 +28,12 @@ struct oscquery_client
   string_map<ossia::net::parameter_base*> listening;
 
   std::string client_ip;
-  std::unique_ptr<osc::sender<oscquery::osc_outbound_visitor>> sender;
+  std::shared_ptr<osc::sender<oscquery::osc_outbound_visitor>> sender;
   int remote_sender_port{};
 
+  // Values waiting to be sent by the network thread
+  std::shared_ptr<outbound_queue> outbound{std::make_shared<outbound_queue>()};
+
 public:
   oscquery_client() = default;
   oscquery_client(oscquery_client&& other)
@@ -37,6 +41,8 @@ public:
       , listening{std::move(other.listening)}
       , client_ip{std::move(other.client_ip)}
       , sender{std::move(other.sender)}
+      , remote_sender_port{other.remote_sender_port}
+      , outbound{std::move(other.outbound)}
   {
     // FIXME http://stackoverflow.com/a/29988626/1495627
   }
@@ -47,6 +53,8 @@ public:
     listening = std::move(other.listening);
     client_ip = std::move(other.client_ip);
     sender = std::move(other.sender);
+    remote_sender_port = other.remote_sender_port;
+    outbound = std::move(other.outbound);
     return *this;
   }
 
@@ -79,7 +87,7 @@ public:
 
   void open_osc_sender(const ossia::oscquery::oscquery_server_protocol& proto, uint16_t port)
   {
-    sender = std::make_unique<osc::sender<oscquery::osc_outbound_visitor>>(
+    sender = std::make_shared<osc::sender<oscquery::osc_outbound_visitor>>(
         proto.get_logger(), client_ip, port);
   }
 };
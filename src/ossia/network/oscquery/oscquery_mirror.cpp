@@ -11,6 +11,7 @@
 #include <ossia/network/osc/detail/sender.hpp>
 #include <ossia/network/sockets/websocket_client.hpp>
 #include <ossia/network/http/http_client.hpp>
+#include <ossia/network/oscquery/detail/binary_namespace.hpp>
 #include <ossia/network/oscquery/detail/osc_writer.hpp>
 #include <ossia/network/oscquery/detail/json_parser.hpp>
 #include <ossia/network/oscquery/detail/json_writer.hpp>
@@ -46,7 +47,85 @@ struct http_error
   }
 };
 
+//! The future returned by update_async fails with the error
+static void fail_namespace_request(
+    std::promise<void>& promise, std::exception_ptr e) noexcept
+{
+  try
+  {
+    promise.set_exception(std::move(e));
+  }
+  catch (const std::future_error&)
+  {
+    // Already answered
+  }
+}
+
+//! Creates the nodes as the records of the binary namespace arrive
+struct http_binary_namespace_answer
+{
+  oscquery_mirror_protocol& self;
+  binary_namespace_reader reader;
+  std::exception_ptr error;
+
+  void on_chunk(const char* data, std::size_t size)
+  {
+    if (error)
+      return;
+
+    try
+    {
+      reader.feed(data, size);
+    }
+    catch (const std::exception& e)
+    {
+      ossia::logger().error("Invalid binary namespace: {}", e.what());
+      error = std::current_exception();
+    }
+  }
+
+  template <typename T, typename S>
+  void operator()(T& req, const S& str)
+  {
+    on_chunk(str.data(), str.size());
+    if (!error)
+    {
+      try
+      {
+        reader.finish();
+        self.m_namespacePromise.set_value();
+      }
+      catch (const std::exception& e)
+      {
+        ossia::logger().error("Invalid binary namespace: {}", e.what());
+        error = std::current_exception();
+      }
+    }
+
+    if (error)
+      fail_namespace_request(self.m_namespacePromise, error);
+    req.close();
+  }
+};
+
+struct http_binary_namespace_error
+{
+  oscquery_mirror_protocol& self;
+
+  template <typename T>
+  void operator()(T& req)
+  {
+    fail_namespace_request(
+        self.m_namespacePromise,
+        std::make_exception_ptr(ossia::connection_error{
+            "Binary namespace: request failed"}));
+    req.close();
+  }
+};
+
 using http_request = ossia::net::http_get_request<http_answer, http_error>;
+using http_binary_namespace_request = ossia::net::http_get_request<
+    http_binary_namespace_answer, http_binary_namespace_error>;
 
 struct http_client_context
 {
@@ -434,14 +513,47 @@ bool oscquery_mirror_protocol::update(net::node_base& b)
 {
   auto fut = update_async(b);
   auto status = fut.wait_for(std::chrono::seconds(3));
-  return status == std::future_status::ready;
+  if (status != std::future_status::ready)
+    return false;
+
+  try
+  {
+    fut.get();
+    return true;
+  }
+  catch (const std::exception& e)
+  {
+    ossia::logger().error("oscquery_mirror_protocol::update: {}", e.what());
+    return false;
+  }
 }
 
 std::future<void> oscquery_mirror_protocol::update_async(net::node_base& b)
 {
   m_namespacePromise = std::promise<void>{};
   auto fut = m_namespacePromise.get_future();
-  http_send_message(b.osc_address());
+
+  bool binary{};
+  {
+    std::lock_guard lock{m_host_info_mutex};
+    binary = m_host_info.extensions[std::string(detail::binary_namespace())];
+  }
+
+  if (binary)
+  {
+    std::string req = b.osc_address();
+    req += '?';
+    req += detail::binary_namespace();
+
+    auto hrq = std::make_shared<http_binary_namespace_request>(
+        http_binary_namespace_answer{*this, binary_namespace_reader{b}},
+        http_binary_namespace_error{*this}, m_http->context, m_httpHost, req);
+    hrq->resolve(m_httpHost, m_queryPort);
+  }
+  else
+  {
+    http_send_message(b.osc_address());
+  }
   return fut;
 }
 
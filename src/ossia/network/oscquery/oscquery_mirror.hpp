@@ -127,6 +127,8 @@ public:
   void connect() override;
 private:
   friend struct http_answer;
+  friend struct http_binary_namespace_answer;
+  friend struct http_binary_namespace_error;
 
   void init();
   using connection_handler = std::weak_ptr<void>;
@@ -18,6 +18,7 @@
 #include <ossia/network/oscquery/detail/json_query_parser.hpp>
 #include <ossia/network/oscquery/detail/json_writer.hpp>
 #include <ossia/network/oscquery/detail/osc_writer.hpp>
+#include <ossia/network/oscquery/detail/outbound_queue.hpp>
 #include <ossia/network/oscquery/detail/outbound_visitor.hpp>
 #include <ossia/network/oscquery/detail/query_parser.hpp>
 #include <ossia/network/sockets/websocket_server.hpp>
@@ -94,6 +95,9 @@ oscquery_server_protocol::oscquery_server_protocol(
 
 oscquery_server_protocol::~oscquery_server_protocol()
 {
+  // The sends still queued in the network thread are dropped
+  m_alive.reset();
+
   if (m_device)
   {
     auto& dev = *m_device;
@@ -130,6 +134,101 @@ void oscquery_server_protocol::request(net::parameter_base&)
   // Do nothing
 }
 
+// Past this amount of bytes waiting to be written to a websocket,
+// the client is considered late and its values are coalesced
+static constexpr std::size_t max_buffered_bytes = 256 * 1024;
+static constexpr long late_client_retry_ms = 10;
+
+template <typename T, typename Filter>
+void oscquery_server_protocol::push_to_clients(
+    const T& addr, const ossia::value& val, Filter&& filter)
+{
+  if (m_logger.outbound_logger)
+  {
+    m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
+  }
+
+  // The network thread does the actual sending
+  lock_t lock(m_clientsMutex);
+  if (m_clients.empty())
+    return;
+
+  // The same OSC message is sent through UDP and as a binary websocket message:
+  // it is encoded once for all the clients, if at least one wants it.
+  std::shared_ptr<const std::string> payload;
+  const auto& address = ossia::net::osc_address(addr);
+  const bool critical = addr.get_critical();
+
+  for (auto& client : m_clients)
+  {
+    if (!filter(client))
+      continue;
+
+    if (!payload)
+      payload = std::make_shared<const std::string>(
+          osc_writer::to_message(addr, val));
+
+    if (client.outbound->push(address, payload, critical))
+    {
+      m_websocketServer->impl().get_io_service().post(
+          [this, alive = std::weak_ptr<int>{m_alive}, hdl = client.connection,
+           queue = client.outbound, sender = client.sender] {
+            if (auto self = alive.lock())
+              flush_client(hdl, queue, sender);
+          });
+    }
+  }
+}
+
+void oscquery_server_protocol::flush_client(
+    const connection_handler& hdl, const std::shared_ptr<outbound_queue>& queue,
+    const std::shared_ptr<osc::sender<osc_outbound_visitor>>& sender) try
+{
+  websocketpp::lib::error_code ec;
+  auto con = m_websocketServer->impl().get_con_from_hdl(hdl, ec);
+  if (!con)
+  {
+    // The client is gone
+    queue->consume([](const outbound_queue::message&) {});
+    return;
+  }
+
+  if (con->get_buffered_amount() > max_buffered_bytes)
+  {
+    // Until the client catches up, only the latest value of each address is kept
+    m_websocketServer->impl().set_timer(
+        late_client_retry_ms,
+        [this, alive = std::weak_ptr<int>{m_alive}, hdl, queue,
+         sender](const websocketpp::lib::error_code& ec) {
+          if (ec)
+            return;
+          if (auto self = alive.lock())
+            flush_client(hdl, queue, sender);
+        });
+    return;
+  }
+
+  queue->consume([&](const outbound_queue::message& m) {
+    const std::string& data = *m.payload;
+    // Critical values always go through the websocket
+    if (sender && !m.critical)
+      sender->socket().Send(data.data(), data.size());
+    else
+      con->send(data.data(), data.size(), websocketpp::frame::opcode::binary);
+  });
+
+  if (auto dropped = queue->take_dropped())
+    logger().warn("OSCQuery: {} messages dropped for a late client", dropped);
+}
+catch (const std::exception& e)
+{
+  logger().error("oscquery_server_protocol::flush_client: {}", e.what());
+}
+catch (...)
+{
+  logger().error("oscquery_server_protocol::flush_client: error.");
+}
+
 template <typename T>
 bool oscquery_server_protocol::push_impl(const T& addr, const ossia::value& v)
 {
@@ -137,47 +236,7 @@ bool oscquery_server_protocol::push_impl(const T& addr, const ossia::value& v)
   if (val.valid())
   {
     // Push to all clients
-    auto critical = addr.get_critical();
-    if (!critical)
-    {
-      lock_t lock(m_clientsMutex);
-      for (auto& client : m_clients)
-      {
-        if (client.sender)
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-          }
-          ossia::oscquery::osc_writer::send_message(
-              addr, val, client.sender->socket());
-        }
-        else
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-          }
-          m_websocketServer->send_binary_message(
-              client.connection,
-              osc_writer::to_message(addr, val));
-        }
-      }
-    }
-    else
-    {
-      lock_t lock(m_clientsMutex);
-      for (auto& client : m_clients)
-      {
-        if (m_logger.outbound_logger)
-        {
-          m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-        }
-        m_websocketServer->send_binary_message(
-            client.connection, osc_writer::to_message(addr, val));
-      }
-    }
-
+    push_to_clients(addr, val, [](const oscquery_client&) { return true; });
     return true;
   }
   return false;
@@ -258,54 +317,9 @@ bool oscquery_server_protocol::echo_incoming_message(
   bool not_this_protocol = &id.protocol != this;
   // we know that the value is valid
   // Push to all clients except ours
-  auto critical = addr.get_critical();
-  if (!critical)
-  {
-    lock_t lock(m_clientsMutex);
-    // No need to echo if we just have one client, the most common case
-    for (auto& client : m_clients)
-    {
-      if (not_this_protocol || !is_same(client, id)) {
-        if (client.sender)
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-          }
-          ossia::oscquery::osc_writer::send_message(
-                addr, val, client.sender->socket());
-        }
-        else
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-          }
-          m_websocketServer->send_binary_message(
-                client.connection,
-                osc_writer::to_message(addr, val));
-        }
-      }
-    }
-  }
-  else
-  {
-    lock_t lock(m_clientsMutex);
-
-    for (auto& client : m_clients)
-    {
-      if (not_this_protocol || !is_same(client, id)) {
-
-        if (m_logger.outbound_logger)
-        {
-          m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-        }
-
-        m_websocketServer->send_binary_message(
-              client.connection, osc_writer::to_message(addr, val));
-      }
-    }
-  }
+  push_to_clients(addr, val, [&](const oscquery_client& client) {
+    return not_this_protocol || !is_same(client, id);
+  });
 
   return true;
 }
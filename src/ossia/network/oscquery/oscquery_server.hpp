@@ -31,6 +31,8 @@ class websocket_server;
 namespace oscquery
 {
 struct oscquery_client;
+struct osc_outbound_visitor;
+class outbound_queue;
 //! Implementation of an oscquery server.
 class OSSIA_EXPORT oscquery_server_protocol final
     : public ossia::net::protocol_base
@@ -106,6 +108,16 @@ private:
   template <typename T>
   bool push_impl(const T& addr, const ossia::value& v);
 
+  // Encodes a value once and queues it for all the clients matching filter
+  template <typename T, typename Filter>
+  void push_to_clients(const T& addr, const ossia::value& v, Filter&& filter);
+
+  // Network thread: sends the pending values of a client
+  void flush_client(
+      const connection_handler& hdl,
+      const std::shared_ptr<outbound_queue>& queue,
+      const std::shared_ptr<osc::sender<osc_outbound_visitor>>& sender);
+
   void update_zeroconf();
   // Exceptions here will be catched by the server
   // which will set appropriate error codes.
@@ -117,6 +129,9 @@ private:
   std::unique_ptr<osc::receiver> m_oscServer;
   std::unique_ptr<ossia::net::websocket_server> m_websocketServer;
 
+  // Checked by the sends queued in the network thread, see flush_client
+  std::shared_ptr<int> m_alive = std::make_shared<int>();
+
   net::zeroconf_server m_zeroconfServerWS;
   net::zeroconf_server m_zeroconfServerOSC;
 
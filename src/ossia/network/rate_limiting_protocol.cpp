@@ -6,81 +6,155 @@
 
 namespace ossia::net
 {
+namespace
+{
+constexpr std::size_t osc_padded_size(std::size_t n) noexcept
+{
+  return (n + 4) & ~std::size_t(3);
+}
+
+// Upper bound of the size of a value in an OSC message:
+// its type tags and its payload.
+struct osc_value_size
+{
+  std::size_t operator()(ossia::impulse) const noexcept { return 1; }
+  std::size_t operator()(int32_t) const noexcept { return 5; }
+  std::size_t operator()(float) const noexcept { return 5; }
+  std::size_t operator()(bool) const noexcept { return 1; }
+  std::size_t operator()(char) const noexcept { return 5; }
+  std::size_t operator()(const std::string& s) const noexcept
+  {
+    return 1 + osc_padded_size(s.size());
+  }
+  template <std::size_t N>
+  std::size_t operator()(std::array<float, N>) const noexcept
+  {
+    return N * 5;
+  }
+  std::size_t operator()(const std::vector<ossia::value>& v) const noexcept
+  {
+    std::size_t sz = 2;
+    for (const auto& val : v)
+      sz += val.apply(*this);
+    return sz;
+  }
+  std::size_t operator()() const noexcept { return 0; }
+};
+
+std::size_t estimated_osc_size(const ossia::net::parameter_base& p)
+{
+  // Bundle element size, address, type tag string start
+  std::size_t sz = 4 + osc_padded_size(p.get_node().osc_address().size()) + 4;
+
+  switch (p.get_value_type())
+  {
+    case ossia::val_type::STRING:
+    case ossia::val_type::LIST:
+      return sz + p.value().apply(osc_value_size{});
+    case ossia::val_type::VEC4F:
+      return sz + 4 * 5;
+    default:
+      return sz + 3 * 5;
+  }
+}
+}
+
 struct rate_limiter
 {
   rate_limiting_protocol& self;
-  void operator()() const noexcept {
-    using namespace std::literals;
+
+  void send() const
+  {
+    auto& slots = self.m_threadSlots;
+    auto& params = self.m_threadValues;
+    slots.clear();
+    params.clear();
+
+    rate_limiting_protocol::slot* buf[256];
+    while (auto n = self.m_dirty.try_dequeue_bulk(buf, std::size(buf)))
+    {
+      slots.insert(slots.end(), buf, buf + n);
+      if (n < std::size(buf))
+        break;
+    }
+
+    for (auto s : slots)
+    {
+      // Cleared before taking the value: a new value pushed while
+      // sending is sent at the next period.
+      s->dirty.store(false, std::memory_order_release);
+
+      lock_t lock{s->mutex};
+      if (s->parameter && s->value.valid())
+        params.emplace_back(s->parameter, std::move(s->value));
+      s->value = ossia::value{};
+    }
+
+    if (params.empty())
+      return;
+
+    if (!self.m_bundling)
+    {
+      for (auto& [p, v] : params)
+        self.m_protocol->push(*p, v);
+      return;
+    }
+
+    const std::size_t max_size = self.m_maxBundleSize;
+    // "#bundle" and time tag
+    constexpr std::size_t bundle_header_size = 16;
+
+    auto& bundle = self.m_threadBundle;
+    bundle.clear();
+    std::size_t size = bundle_header_size;
+    for (auto& [p, v] : params)
+    {
+      // Bundles carry the current value of their parameters:
+      // a value which differs from it is sent on its own.
+      if (v != p->value())
+      {
+        self.m_protocol->push(*p, v);
+        continue;
+      }
+
+      const auto sz = estimated_osc_size(*p);
+      if (!bundle.empty() && size + sz > max_size)
+      {
+        self.m_protocol->push_bundle(bundle);
+        bundle.clear();
+        size = bundle_header_size;
+      }
+      bundle.push_back(p);
+      size += sz;
+    }
+    if (!bundle.empty())
+      self.m_protocol->push_bundle(bundle);
+  }
+
+  void operator()() const noexcept
+  {
     using clock = rate_limiting_protocol::clock;
-    const auto duration = self.m_duration.load();
-    thread_local auto time_to_sleep = duration;
-    while(self.m_running)
+    auto deadline = clock::now();
+    while (self.m_running)
     {
-      try {
-        auto prev_time = clock::now();
-        if(time_to_sleep > 1ms)
-          std::this_thread::sleep_for(time_to_sleep);
+      deadline += self.m_duration.load();
 
-        // TODO find safe way to handle if a parameter is removed
-        // TODO instead we should do the value filtering in the parameter ...
-        // but still have to handle cases that can be optimized, such as midi
-        {
-          std::lock_guard lock{self.m_msgMutex};
-          std::swap(self.m_buffer, self.m_userMessages);
-        }
-
-        // Copy newest messages in local map
-        for(auto& msg : self.m_buffer.container)
-        {
-          if(msg.second.first.valid())
-          {
-            self.m_threadMessages[msg.first] = std::move(msg.second);
-            msg.second.first = ossia::value{};
-          }
-        }
-
-        // Push the actual messages
-        for(auto& v : self.m_threadMessages.container)
-        {
-          auto val = v.second.first;
-          if(val.valid())
-          {
-            self.m_protocol->push(*v.first, v.second.first);
-          }
-        }
-
-        // Clear both containers (while keeping memory allocated for sent messages
-        // so that it stays fast)
-        for(auto& v : self.m_buffer.container)
-        {
-          if(v.second.first.valid())
-          {
-            v.second.first = ossia::value{};
-          }
-        }
-
-        for(auto& v : self.m_threadMessages.container)
-        {
-          if(v.second.first.valid())
-          {
-            v.second.first = ossia::value{};
-          }
-        }
-        auto new_time = clock::now();
-        auto observed_duration = std::chrono::duration_cast<std::chrono::milliseconds>(new_time - prev_time);
-        if(observed_duration > duration)
-        {
-          if(observed_duration >= 2 * duration)
-            time_to_sleep = 0ms;
-          else
-            time_to_sleep = 2 * duration - observed_duration ;
-        }
-        else
-        {
-          time_to_sleep = duration;
-        }
-      } catch(...) {
+      // If we are late by more than a period, skip the missed periods
+      // instead of sending several times in a row.
+      const auto now = clock::now();
+      if (deadline < now)
+        deadline = now;
+      else
+        std::this_thread::sleep_until(deadline);
 
+      try
+      {
+        // TODO find safe way to handle if a parameter is removed
+        // while it is being sent
+        send();
+      }
+      catch (...)
+      {
       }
     }
   }
@@ -92,12 +166,11 @@ rate_limiting_protocol::rate_limiting_protocol(
   : protocol_base{flags{SupportsMultiplex}}
   , m_duration{d}
   , m_protocol{std::move(arg)}
-
+  , m_dirty{4096}
 {
-  m_userMessages.container.reserve(4096);
-  m_buffer.container.reserve(4096);
-  m_threadMessages.container.reserve(4096);
-  m_lastTime = clock::now();
+  m_threadSlots.reserve(4096);
+  m_threadValues.reserve(4096);
+  m_threadBundle.reserve(4096);
   m_thread = std::thread{rate_limiter{*this}};
 }
 
@@ -105,6 +178,10 @@ rate_limiting_protocol::~rate_limiting_protocol()
 {
   m_running = false;
   m_thread.join();
+
+  if (m_device)
+    m_device->on_parameter_removing
+        .disconnect<&rate_limiting_protocol::on_parameter_removing>(this);
 }
 
 void rate_limiting_protocol::set_duration(rate_limiting_protocol::duration d)
@@ -112,15 +189,63 @@ void rate_limiting_protocol::set_duration(rate_limiting_protocol::duration d)
   m_duration = d;
 }
 
+void rate_limiting_protocol::set_bundling(bool b)
+{
+  m_bundling = b;
+}
+
+void rate_limiting_protocol::set_max_bundle_size(std::size_t bytes)
+{
+  m_maxBundleSize = bytes;
+}
+
 bool rate_limiting_protocol::pull(ossia::net::parameter_base& address)
 {
   return m_protocol->pull(address);
 }
 
+rate_limiting_protocol::slot*
+rate_limiting_protocol::find_slot(const parameter_base& p)
+{
+  if (auto s = m_slots.find(&p))
+    return *s;
+
+  lock_t lock{m_slotMutex};
+  if (auto s = m_slots.find(&p))
+    return *s;
+
+  slot* s{};
+  if (!m_freeSlots.empty())
+  {
+    s = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else
+  {
+    s = m_slotStorage.emplace_back(std::make_unique<slot>()).get();
+  }
+  {
+    lock_t slot_lock{s->mutex};
+    s->parameter = &p;
+  }
+  m_slots.insert({&p, s});
+  return s;
+}
+
 bool rate_limiting_protocol::push(const ossia::net::parameter_base& address, const ossia::value& v)
 {
-  std::lock_guard lock{m_msgMutex};
-  m_userMessages[&address] = {v, {}};
+  // Only the latest value of the period is sent
+  auto s = find_slot(address);
+  {
+    lock_t lock{s->mutex};
+    // The parameter was removed in the meantime
+    if (s->parameter != &address)
+      return false;
+    s->value = v;
+  }
+
+  if (!s->dirty.exchange(true, std::memory_order_acq_rel))
+    m_dirty.enqueue(s);
   return true;
 }
 
@@ -157,8 +282,30 @@ void rate_limiting_protocol::stop()
 
 void rate_limiting_protocol::set_device(device_base& dev)
 {
+  if (m_device)
+    m_device->on_parameter_removing
+        .disconnect<&rate_limiting_protocol::on_parameter_removing>(this);
+
   m_device = &dev;
   m_protocol->set_device(dev);
+  dev.on_parameter_removing
+      .connect<&rate_limiting_protocol::on_parameter_removing>(this);
+}
+
+void rate_limiting_protocol::on_parameter_removing(const parameter_base& p)
+{
+  lock_t lock{m_slotMutex};
+  if (auto s = m_slots.find_and_take(&p))
+  {
+    // The slot may still be in the dirty queue: it is then skipped,
+    // or sends the parameter which reuses it one period early.
+    {
+      lock_t slot_lock{(*s)->mutex};
+      (*s)->parameter = nullptr;
+      (*s)->value = ossia::value{};
+    }
+    m_freeSlots.push_back(*s);
+  }
 }
 
 }
@@ -1,11 +1,15 @@
 #pragma once
 #include <ossia/network/base/protocol.hpp>
 #include <ossia/network/base/parameter_data.hpp>
+#include <ossia/network/base/listening.hpp>
 #include <ossia/network/base/message_queue.hpp>
-#include <ossia/detail/flat_map.hpp>
+#include <ossia/detail/ptr_set.hpp>
+#include <ossia/detail/mutex.hpp>
 #include <ossia/detail/algorithms.hpp>
-#include <readerwriterqueue.h>
+#include <concurrentqueue.h>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -16,13 +20,22 @@ class OSSIA_EXPORT rate_limiting_protocol final
     : public ossia::net::protocol_base
 {
 public:
-  using clock = std::chrono::high_resolution_clock;
+  using clock = std::chrono::steady_clock;
   using duration = clock::duration;
   rate_limiting_protocol(duration d, std::unique_ptr<protocol_base> arg);
   ~rate_limiting_protocol() override;
 
   void set_duration(duration d);
 
+  /**
+   * @brief Send the values of each period with push_bundle
+   *
+   * Bundles are split so that their estimated OSC size stays below
+   * max_bundle_size bytes.
+   */
+  void set_bundling(bool b);
+  void set_max_bundle_size(std::size_t bytes);
+
 private:
   bool pull(ossia::net::parameter_base&) override;
   bool push(const ossia::net::parameter_base& addr, const ossia::value& v) override;
@@ -36,7 +49,7 @@ private:
   void stop() override;
   void set_device(ossia::net::device_base& dev) override;
 
-  void parameter_removed(const ossia::net::parameter_base& b);
+  void on_parameter_removing(const ossia::net::parameter_base& b);
 
   rate_limiting_protocol() = delete;
   rate_limiting_protocol(const rate_limiting_protocol&) = delete;
@@ -51,14 +64,42 @@ private:
   ossia::net::device_base* m_device{};
 
   std::atomic_bool m_running{true};
+  std::atomic_bool m_bundling{false};
+  std::atomic_size_t m_maxBundleSize{1400};
   std::thread m_thread;
 
-  clock::time_point m_lastTime;
-  using map_t = ossia::flat_map<const ossia::net::parameter_base*, std::pair<ossia::value, clock::time_point>>;
-  map_t m_userMessages;
-  map_t m_buffer;
-  map_t m_threadMessages;
-  std::mutex m_msgMutex;
+  // Each parameter pushed at least once gets a slot.
+  // A slot is put in the dirty queue when it gets a new value and
+  // was not already in it: the latest value pushed for the parameter
+  // is sent at the end of the period.
+  struct slot
+  {
+    // Both guarded by the mutex: a slot is reused once its parameter is
+    // removed, and a push may still hold it.
+    mutex_t mutex;
+    const ossia::net::parameter_base* parameter{};
+    ossia::value value;
+
+    std::atomic_bool dirty{};
+  };
+
+  slot* find_slot(const ossia::net::parameter_base& p);
+
+  // Lookups do not lock; the mutex is only taken when a parameter is
+  // pushed for the first time or removed.
+  ossia::rcu_map<ossia::ptr_map<const ossia::net::parameter_base*, slot*>, 16>
+      m_slots;
+  mutex_t m_slotMutex;
+  std::vector<std::unique_ptr<slot>> m_slotStorage;
+  std::vector<slot*> m_freeSlots;
+
+  moodycamel::ConcurrentQueue<slot*> m_dirty;
+
+  // Used by the sending thread
+  std::vector<slot*> m_threadSlots;
+  std::vector<std::pair<const ossia::net::parameter_base*, ossia::value>>
+      m_threadValues;
+  std::vector<const ossia::net::parameter_base*> m_threadBundle;
 };
 
 template<typename Protocol, typename... Args>
@@ -14,16 +14,24 @@ struct framed_listener : public Base
 {
   using proto = typename Base::proto;
   using socket = typename proto::socket;
+  using encoder = typename Framing::template encoder<socket>;
   using decoder = typename Framing::template decoder<socket>;
 
   template<typename F>
   framed_listener(socket&& sock, F f)
       : Base{std::move(sock)}
+      , m_encoder{this->m_socket}
       , m_decoder{this->m_socket}
   {
     m_decoder.receive(stream_processor<framed_listener, F>{*this, std::move(f)});
   }
 
+  void write(const char* data, std::size_t sz)
+  {
+    m_encoder.write(data, sz);
+  }
+
+  encoder m_encoder;
   decoder m_decoder;
 };
 
@@ -34,8 +42,6 @@ public:
   using proto = typename Base::proto;
   using socket = typename proto::socket;
   using listener = framed_listener<typename Base::listener, Framing>;
-  using encoder = typename Framing::template encoder<multi_socket_writer<std::unique_ptr<listener>>>;
-  using decoder = typename Framing::template decoder<socket>;
 
   template<typename... Args>
   framed_server(Args&&... args)
@@ -72,8 +78,10 @@ public:
 
   void write(const char* data, std::size_t sz)
   {
-    multi_socket_writer<std::unique_ptr<listener>> wr{this->m_sockets};
-    encoder{wr}.write(data, sz);
+    for(auto& sock : m_sockets)
+    {
+      sock->write(data, sz);
+    }
   }
 
   std::vector<std::unique_ptr<listener>> m_sockets;
@@ -89,6 +97,7 @@ struct framed_client : Base
   template<typename... Args>
   framed_client(Args&&... args)
       : Base{std::forward<Args>(args)...}
+      , m_encoder{this->m_socket}
       , m_decoder{this->m_socket}
   {
 
@@ -101,9 +110,10 @@ struct framed_client : Base
 
   void write(const char* data, std::size_t sz)
   {
-    encoder{this->m_socket}.write(data, sz);
+    m_encoder.write(data, sz);
   }
 
+  encoder m_encoder;
   decoder m_decoder;
 };
 
@@ -117,6 +127,7 @@ struct framed_socket : Base
   template<typename... Args>
   framed_socket(Args&&... args)
       : Base{std::forward<Args>(args)...}
+      , m_encoder{this->m_socket}
       , m_decoder{this->m_socket}
   {
 
@@ -136,9 +147,10 @@ struct framed_socket : Base
 
   void write(const char* data, std::size_t sz)
   {
-    encoder{this->m_socket}.write(data, sz);
+    m_encoder.write(data, sz);
   }
 
+  encoder m_encoder;
   decoder m_decoder;
 };
 
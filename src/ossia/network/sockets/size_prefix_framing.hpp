@@ -8,6 +8,8 @@
 
 #include <boost/endian/conversion.hpp>
 
+#include <cstring>
+
 namespace ossia::net
 {
 
@@ -15,90 +17,100 @@ template<typename Socket>
 struct size_prefix_decoder
 {
   Socket& socket;
-  int32_t m_next_packet_size {};
   ossia::pod_vector<char> m_data;
 
+  // Bytes received in m_data and not processed yet
+  std::size_t m_received{};
+
   explicit size_prefix_decoder(Socket& socket)
       : socket{socket}
   {
-    m_data.reserve(65535);
+    m_data.resize(65536);
   }
 
   template <typename F>
   void receive(F f)
   {
-    // Receive the size prefix
+    // As many bytes as possible are read at once:
+    // a single read may bring many packets, or a part of one.
     socket.async_read_some(
-        boost::asio::buffer(&m_next_packet_size, sizeof(int32_t)),
+        boost::asio::buffer(m_data.data() + m_received, m_data.size() - m_received),
         [this, f = std::move(f)] (boost::system::error_code ec, std::size_t sz) mutable {
-          read_size(std::move(f), ec, sz);
-        });
-  }
-
-  template <typename F>
-  void read_size(F&& f, boost::system::error_code ec, std::size_t sz)
-  {
-    if(!f.validate_stream(ec))
-      return;
+          if(!f.validate_stream(ec))
+            return;
 
-    boost::endian::big_to_native_inplace(m_next_packet_size);
-    if (m_next_packet_size <= 0)
-      return;
+          m_received += sz;
+          if(!process_packets(f))
+            return;
 
-    m_data.resize(m_next_packet_size);
-    boost::asio::async_read(socket,
-        boost::asio::buffer(m_data.data(), m_next_packet_size),
-        boost::asio::transfer_exactly(m_next_packet_size),
-        [this, f = std::move(f)] (boost::system::error_code ec, std::size_t sz) mutable {
-          read_data(std::move(f), ec, sz);
+          this->receive(std::move(f));
         });
   }
 
+  // Returns false if the stream is invalid
   template <typename F>
-  void read_data(F&& f, boost::system::error_code ec, std::size_t sz)
+  bool process_packets(const F& f)
   {
-    if(!f.validate_stream(ec))
-      return;
-
-    if (!ec && sz > 0)
+    std::size_t begin = 0;
+    std::size_t required = 0;
+    while (m_received - begin >= sizeof(int32_t))
     {
+      int32_t packet_size{};
+      std::memcpy(&packet_size, m_data.data() + begin, sizeof(int32_t));
+      boost::endian::big_to_native_inplace(packet_size);
+      if (packet_size <= 0)
+        return false;
+
+      const std::size_t frame_size = sizeof(int32_t) + packet_size;
+      if (m_received - begin < frame_size)
+      {
+        required = frame_size;
+        break;
+      }
+
       try
       {
-        f(m_data.data(), sz);
+        f(m_data.data() + begin + sizeof(int32_t), std::size_t(packet_size));
       }
       catch (...)
       {
       }
+      begin += frame_size;
+    }
+
+    // The incomplete packet goes back to the start of the buffer
+    if (begin > 0)
+    {
+      m_received -= begin;
+      std::memmove(m_data.data(), m_data.data() + begin, m_received);
     }
 
-    this->receive(std::move(f));
+    if (required > m_data.size())
+      m_data.resize(required);
+    return true;
   }
 };
 
 template<typename Socket>
 struct size_prefix_encoder
 {
-  Socket& socket;
-
-  void write(const char* data, std::size_t sz)
+  explicit size_prefix_encoder(Socket& socket)
+      : m_queue{socket}
   {
-    int32_t packet_size = sz;
-    boost::endian::native_to_big_inplace(packet_size);
-    this->write(socket, boost::asio::buffer(reinterpret_cast<const char*>(&packet_size), sizeof(int32_t)));
-    this->write(socket, boost::asio::buffer(data, sz));
   }
 
-  template<typename T>
-  void write(T& sock, const boost::asio::const_buffer& buf)
+  bool write(const char* data, std::size_t sz)
   {
-    boost::asio::write(sock, buf);
+    return m_queue.write([=](ossia::pod_vector<char>& buf) {
+      int32_t packet_size = sz;
+      boost::endian::native_to_big_inplace(packet_size);
+      const char* prefix = reinterpret_cast<const char*>(&packet_size);
+      buf.insert(buf.end(), prefix, prefix + sizeof(int32_t));
+      buf.insert(buf.end(), data, data + sz);
+    });
   }
 
-  template<typename T>
-  void write(multi_socket_writer<T>& sock, const boost::asio::const_buffer& buf)
-  {
-    sock.write(buf);
-  }
+  stream_write_queue<Socket> m_queue;
 };
 
 struct size_prefix_framing
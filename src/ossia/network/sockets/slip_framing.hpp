@@ -5,7 +5,6 @@
 #include <boost/asio/write.hpp>
 
 #include <boost/asio/error.hpp>
-#include <boost/asio/streambuf.hpp>
 
 namespace ossia::net
 {
@@ -21,28 +20,29 @@ template<typename Socket>
 struct slip_decoder
 {
   Socket& socket;
-  boost::asio::streambuf m_data;
+  ossia::pod_vector<char> m_data;
   ossia::pod_vector<char> m_decoded;
   enum { waiting, reading_char, reading_esc } m_status{waiting};
 
   explicit slip_decoder(Socket& socket)
       : socket{socket}
   {
-
+    m_data.resize(65536);
   }
 
   template <typename F>
   void receive(F f)
   {
     socket.async_read_some(
-        boost::asio::buffer(m_data.prepare(1024)),
+        boost::asio::buffer(m_data.data(), m_data.size()),
         [this, f = std::move(f)] (boost::system::error_code ec, std::size_t sz) mutable {
           if(!f.validate_stream(ec))
             return;
 
           if (sz > 0)
           {
-            process_bytes(f, sz);
+            auto begin = reinterpret_cast<const uint8_t*>(m_data.data());
+            process_bytes(f, begin, begin + sz);
           }
 
           receive(std::move(f));
@@ -50,16 +50,38 @@ struct slip_decoder
   }
 
   template <typename F>
-  void process_bytes(const F& f, std::size_t sz)
+  void process_bytes(const F& f, const uint8_t* begin, const uint8_t* end)
   {
-    auto begin = (const uint8_t*)m_data.data().data();
-    for(std::size_t i = 0; i < sz; i++)
+    while(begin != end)
     {
-      const uint8_t next_char = *begin;
-      process_byte(f, next_char);
+      if(m_status == reading_char)
+      {
+        // Handle the characters up to the next special one at once
+        auto run_end = begin;
+        while(run_end != end && *run_end != slip::eot && *run_end != slip::esc)
+          ++run_end;
+
+        if(run_end != end && *run_end == slip::eot && m_decoded.empty())
+        {
+          // The whole message is in the read buffer: no need to copy it
+          m_status = waiting;
+          if(run_end != begin)
+          {
+            f(reinterpret_cast<const char*>(begin), std::size_t(run_end - begin));
+          }
+          begin = run_end + 1;
+          continue;
+        }
+
+        m_decoded.insert(m_decoded.end(), begin, run_end);
+        begin = run_end;
+        if(begin == end)
+          break;
+      }
+
+      process_byte(f, *begin);
       ++begin;
     }
-    m_data.consume(sz);
   }
 
   template <typename F>
@@ -142,37 +164,42 @@ struct slip_decoder
 template<typename Socket>
 struct slip_encoder
 {
-  Socket& socket;
+  explicit slip_encoder(Socket& socket)
+      : m_queue{socket}
+  {
+  }
 
   // This is tailored for OSC which uses double-ended encoding
-  void write(const char* data, std::size_t sz)
+  bool write(const char* data, std::size_t sz)
   {
-    this->write(socket, boost::asio::buffer(&slip::eot, 1));
+    return m_queue.write([=](ossia::pod_vector<char>& buf) {
+      buf.push_back(char(slip::eot));
 
-    const uint8_t* begin = reinterpret_cast<const uint8_t*>(data);
-    const uint8_t* end = begin + sz;
-    while(begin < end)
-    {
-      std::size_t written = this->write(begin, end);
-      begin += written;
-    }
-    this->write(socket, boost::asio::buffer(&slip::eot, 1));
+      const uint8_t* begin = reinterpret_cast<const uint8_t*>(data);
+      const uint8_t* end = begin + sz;
+      while(begin < end)
+      {
+        std::size_t written = this->write(buf, begin, end);
+        begin += written;
+      }
+      buf.push_back(char(slip::eot));
+    });
   }
 
-  std::size_t write(const uint8_t* begin, const uint8_t* end) {
+  static std::size_t write(ossia::pod_vector<char>& buf, const uint8_t* begin, const uint8_t* end) {
     const uint8_t byte = *begin;
     switch(byte)
     {
       case slip::eot:
       {
-        const uint8_t data[2] = {slip::esc, slip::esc_end};
-        this->write(socket, boost::asio::buffer(data, 2));
+        buf.push_back(char(slip::esc));
+        buf.push_back(char(slip::esc_end));
         return 1;
       }
       case slip::esc:
       {
-        const uint8_t data[2] = {slip::esc, slip::esc_esc};
-        this->write(socket, boost::asio::buffer(data, 2));
+        buf.push_back(char(slip::esc));
+        buf.push_back(char(slip::esc_esc));
         return 1;
       }
       default:
@@ -181,23 +208,13 @@ struct slip_encoder
         while(sub_end != end && *sub_end != slip::eot && *sub_end != slip::esc)
           ++sub_end;
 
-        this->write(socket, boost::asio::buffer(begin, sub_end - begin));
+        buf.insert(buf.end(), begin, sub_end);
         return sub_end - begin;
       }
     }
   }
 
-  template<typename T>
-  void write(T& sock, const boost::asio::const_buffer& buf)
-  {
-    boost::asio::write(sock, buf);
-  }
-
-  template<typename T>
-  void write(multi_socket_writer<T>& sock, const boost::asio::const_buffer& buf)
-  {
-    sock.write(buf);
-  }
+  stream_write_queue<Socket> m_queue;
 };
 
 
@@ -0,0 +1,330 @@
+#pragma once
+#include <ossia/detail/buffer_pool.hpp>
+#include <ossia/detail/logger.hpp>
+#include <ossia/detail/mutex.hpp>
+#include <ossia/network/sockets/configuration.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/post.hpp>
+
+#include <nano_signal_slot.hpp>
+
+#if defined(__linux__)
+#define OSSIA_HAS_UDP_BATCHING 1
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * \file udp_batch_socket.hpp
+ *
+ * UDP sockets which read and write datagrams in batches, with a single
+ * recvmmsg / sendmmsg system call per batch.
+ *
+ * They are drop-in replacements for udp_receive_socket and udp_send_socket.
+ */
+namespace ossia::net
+{
+//! Number of system calls made and datagrams transferred by a batch socket
+struct udp_batch_stats
+{
+  std::atomic<uint64_t> syscalls{};
+  std::atomic<uint64_t> datagrams{};
+};
+
+class udp_batch_receive_socket
+{
+  using proto = boost::asio::ip::udp;
+
+public:
+  //! Maximal number of datagrams read per system call
+  static constexpr int max_batch = 32;
+  static constexpr int max_datagram_size = 65535;
+
+  udp_batch_receive_socket(const socket_configuration& conf, boost::asio::io_context& ctx)
+      : m_context {ctx}
+      , m_endpoint {boost::asio::ip::make_address(conf.host), conf.port}
+      , m_socket {ctx}
+  {
+    // Buffers are not initialized by the pool's allocator:
+    // pages are only committed once a datagram of that size is received.
+    auto& pool = ossia::buffer_pool::instance();
+    for (int i = 0; i < max_batch; i++)
+    {
+      m_buffers[i] = pool.acquire(max_datagram_size);
+
+      m_iovecs[i].iov_base = m_buffers[i].data();
+      m_iovecs[i].iov_len = m_buffers[i].size();
+
+      std::memset(&m_msgs[i], 0, sizeof(mmsghdr));
+      m_msgs[i].msg_hdr.msg_iov = &m_iovecs[i];
+      m_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  ~udp_batch_receive_socket()
+  {
+    auto& pool = ossia::buffer_pool::instance();
+    for (auto& buf : m_buffers)
+      pool.release(std::move(buf));
+  }
+
+  void open()
+  {
+    m_socket.open(boost::asio::ip::udp::v4());
+    m_socket.bind(m_endpoint);
+  }
+
+  void close()
+  {
+    m_context.post([this] {
+      m_socket.close();
+      on_close();
+    });
+  }
+
+  template <typename F>
+  void receive(F f)
+  {
+    m_socket.async_wait(
+        proto::socket::wait_read,
+        [this, f](boost::system::error_code ec) {
+          if (ec == boost::asio::error::operation_aborted)
+            return;
+
+          if (!ec)
+            read_batches(f);
+
+          this->receive(f);
+        });
+  }
+
+  const udp_batch_stats& stats() const noexcept
+  {
+    return m_stats;
+  }
+
+  Nano::Signal<void()> on_close;
+
+  boost::asio::io_context& m_context;
+  proto::endpoint m_endpoint;
+  proto::socket m_socket;
+
+private:
+  template <typename F>
+  void read_batches(const F& f)
+  {
+    const int fd = m_socket.native_handle();
+    int n = 0;
+    do
+    {
+      n = ::recvmmsg(fd, m_msgs.data(), max_batch, MSG_DONTWAIT, nullptr);
+      m_stats.syscalls.fetch_add(1, std::memory_order_relaxed);
+      if (n <= 0)
+      {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+          ossia::logger().error(
+              "[udp_batch_socket::receive]: {}", std::strerror(errno));
+        return;
+      }
+
+      m_stats.datagrams.fetch_add(n, std::memory_order_relaxed);
+      for (int i = 0; i < n; i++)
+      {
+        auto& msg = m_msgs[i];
+        if (msg.msg_hdr.msg_flags & MSG_TRUNC)
+        {
+          ossia::logger().error("[udp_batch_socket::receive]: truncated datagram");
+        }
+        else if (msg.msg_len > 0)
+        {
+          try
+          {
+            f(static_cast<const char*>(m_iovecs[i].iov_base), msg.msg_len);
+          }
+          catch (const std::exception& e)
+          {
+            ossia::logger().error("[udp_batch_socket::receive]: {}", e.what());
+          }
+          catch (...)
+          {
+            ossia::logger().error("[udp_batch_socket::receive]: unknown error");
+          }
+        }
+        msg.msg_hdr.msg_flags = 0;
+      }
+    } while (n == max_batch);
+  }
+
+  std::array<ossia::buffer_pool::buffer, max_batch> m_buffers;
+  std::array<iovec, max_batch> m_iovecs;
+  std::array<mmsghdr, max_batch> m_msgs;
+  udp_batch_stats m_stats;
+};
+
+class udp_batch_send_socket
+{
+  using proto = boost::asio::ip::udp;
+
+public:
+  //! Maximal number of datagrams written per system call
+  static constexpr int max_batch = 64;
+
+  udp_batch_send_socket(const socket_configuration& conf, boost::asio::io_context& ctx)
+      : m_context {ctx}
+      , m_endpoint {boost::asio::ip::make_address(conf.host), conf.port}
+      , m_socket {ctx}
+  {
+  }
+
+  udp_batch_send_socket(const boost::asio::ip::address_v4& host, const uint16_t port, boost::asio::io_context& ctx)
+      : m_context {ctx}
+      , m_endpoint {host, port}
+      , m_socket {ctx}
+  {
+  }
+
+  ~udp_batch_send_socket()
+  {
+    // A flush may be running in the network thread: wait until it is done,
+    // the ones posted after this do nothing.
+    std::weak_ptr<int> alive = m_alive;
+    m_alive.reset();
+    while (!alive.expired())
+      std::this_thread::yield();
+
+    if (m_socket.is_open())
+      flush();
+  }
+
+  void connect()
+  {
+    m_socket.open(boost::asio::ip::udp::v4());
+  }
+
+  void close()
+  {
+    m_context.post([this] {
+      flush();
+      m_socket.close();
+      on_close();
+    });
+  }
+
+  /**
+   * @brief Queues a datagram.
+   *
+   * All the datagrams written before the network context gets to run
+   * the flush are sent with a single system call.
+   */
+  void write(const char* data, std::size_t sz)
+  {
+    auto buf = ossia::buffer_pool::instance().acquire(sz);
+    std::memcpy(buf.data(), data, sz);
+
+    bool schedule = false;
+    {
+      lock_t lock{m_mutex};
+      m_pending.push_back(std::move(buf));
+      schedule = !m_flushScheduled;
+      m_flushScheduled = true;
+    }
+
+    if (schedule)
+    {
+      boost::asio::post(
+          m_context, [this, alive = std::weak_ptr<int>{m_alive}] {
+            // Kept for the whole flush: the destructor waits for it
+            if (auto self = alive.lock())
+              flush();
+          });
+    }
+  }
+
+  //! Sends all the queued datagrams. Runs in the network context's thread.
+  void flush()
+  {
+    lock_t send_lock{m_sendMutex};
+    {
+      lock_t lock{m_mutex};
+      std::swap(m_pending, m_sending);
+      m_flushScheduled = false;
+    }
+
+    const int fd = m_socket.native_handle();
+    const std::size_t count = m_sending.size();
+    std::size_t sent = 0;
+    while (sent < count)
+    {
+      const int batch = std::min<std::size_t>(count - sent, max_batch);
+      for (int i = 0; i < batch; i++)
+      {
+        auto& buf = m_sending[sent + i];
+        m_iovecs[i].iov_base = buf.data();
+        m_iovecs[i].iov_len = buf.size();
+
+        auto& hdr = m_msgs[i].msg_hdr;
+        hdr = msghdr{};
+        hdr.msg_name = m_endpoint.data();
+        hdr.msg_namelen = m_endpoint.size();
+        hdr.msg_iov = &m_iovecs[i];
+        hdr.msg_iovlen = 1;
+      }
+
+      int n = ::sendmmsg(fd, m_msgs.data(), batch, 0);
+      m_stats.syscalls.fetch_add(1, std::memory_order_relaxed);
+      if (n <= 0)
+      {
+        if (n < 0 && errno == EINTR)
+          continue;
+
+        ossia::logger().error(
+            "[udp_batch_socket::write]: {}", std::strerror(errno));
+        break;
+      }
+
+      m_stats.datagrams.fetch_add(n, std::memory_order_relaxed);
+      sent += n;
+    }
+
+    auto& pool = ossia::buffer_pool::instance();
+    for (auto& buf : m_sending)
+      pool.release(std::move(buf));
+    m_sending.clear();
+  }
+
+  const udp_batch_stats& stats() const noexcept
+  {
+    return m_stats;
+  }
+
+  Nano::Signal<void()> on_close;
+
+  boost::asio::io_context& m_context;
+  proto::endpoint m_endpoint;
+  proto::socket m_socket;
+
+private:
+  mutex_t m_mutex;
+  //! Held during a flush, which uses m_sending and the system call buffers
+  mutex_t m_sendMutex;
+  std::vector<ossia::buffer_pool::buffer> m_pending;
+  std::vector<ossia::buffer_pool::buffer> m_sending;
+  bool m_flushScheduled{};
+
+  std::array<iovec, max_batch> m_iovecs;
+  std::array<mmsghdr, max_batch> m_msgs;
+  udp_batch_stats m_stats;
+
+  std::shared_ptr<int> m_alive = std::make_shared<int>();
+};
+}
+#endif
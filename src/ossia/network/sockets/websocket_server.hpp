@@ -141,6 +141,11 @@ public:
             con->replace_header("Content-Type", "text/html; charset=utf-8");
             break;
           }
+          case server_reply::data_type::binary:
+          {
+            con->replace_header("Content-Type", "application/octet-stream");
+            break;
+          }
           default:
             break;
         }
@@ -1,10 +1,16 @@
 #pragma once
 #include <ossia/detail/config.hpp>
+#include <ossia/detail/logger.hpp>
+#include <ossia/detail/mutex.hpp>
+#include <ossia/detail/pod_vector.hpp>
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
 
 #include <cinttypes>
+#include <utility>
 #include <vector>
 
 namespace ossia::net
@@ -19,24 +25,98 @@ struct socket_writer
   }
 };
 
-template<typename Socket>
-struct multi_socket_writer
+/**
+ * @brief Queue of frames to write on a stream socket
+ *
+ * Frames can be queued from any thread: they are written from the socket's
+ * executor. All the frames queued while a write is in progress are sent
+ * together by the next one, with a single write.
+ *
+ * When the peer does not read fast enough, the data waiting to be written
+ * is capped by a high-water mark: past it, new frames are dropped whole.
+ */
+template <typename Socket>
+class stream_write_queue
 {
-  std::vector<Socket>& sockets;
-  void write(const boost::asio::const_buffer& buf)
+public:
+  static constexpr std::size_t default_high_water_mark = 16 * 1024 * 1024;
+
+  explicit stream_write_queue(
+      Socket& socket, std::size_t high_water_mark = default_high_water_mark)
+      : m_socket{socket}
+      , m_highWaterMark{high_water_mark}
+  {
+  }
+
+  stream_write_queue(const stream_write_queue&) = delete;
+  stream_write_queue& operator=(const stream_write_queue&) = delete;
+
+  //! encode appends the framed data to the buffer it is given.
+  //! Returns false if the frame was dropped as the high-water mark is reached.
+  template <typename Encode>
+  bool write(Encode&& encode)
   {
-    for(auto& sock : sockets)
+    lock_t lock{m_mutex};
+    if (m_pending.size() >= m_highWaterMark)
     {
-      sock->write(buf);
+      if (m_dropped++ == 0)
+        ossia::logger().warn(
+            "stream_write_queue: {} bytes waiting to be written, dropping "
+            "messages",
+            m_pending.size());
+      return false;
     }
+
+    if (m_dropped > 0)
+    {
+      ossia::logger().warn(
+          "stream_write_queue: {} messages were dropped", m_dropped);
+      m_dropped = 0;
+    }
+
+    encode(m_pending);
+    if (!std::exchange(m_writing, true))
+      boost::asio::post(m_socket.get_executor(), [this] { write_next(); });
+    return true;
   }
-  void write_some(const boost::asio::const_buffer& buf)
+
+private:
+  void write_next()
   {
-    for(auto& sock : sockets)
     {
-      sock->write(buf);
+      lock_t lock{m_mutex};
+      if (m_pending.empty())
+      {
+        m_writing = false;
+        return;
+      }
+      std::swap(m_pending, m_sending);
     }
+
+    boost::asio::async_write(
+        m_socket, boost::asio::buffer(m_sending.data(), m_sending.size()),
+        [this](boost::system::error_code ec, std::size_t) {
+          m_sending.clear();
+          if (ec)
+          {
+            // The reading side reports the closed connection
+            lock_t lock{m_mutex};
+            m_pending.clear();
+            m_writing = false;
+            return;
+          }
+
+          write_next();
+        });
   }
+
+  Socket& m_socket;
+  mutex_t m_mutex;
+  ossia::pod_vector<char> m_pending;
+  ossia::pod_vector<char> m_sending;
+  std::size_t m_highWaterMark{};
+  std::size_t m_dropped{};
+  bool m_writing{};
 };
 
 template<typename T, typename F>
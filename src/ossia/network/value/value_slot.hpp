@@ -0,0 +1,258 @@
+#pragma once
+#include <ossia/network/value/value.hpp>
+
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+#include <thread>
+
+/**
+ * \file value_slot.hpp
+ */
+namespace ossia
+{
+/**
+ * @brief Lock-free storage for the trivially copyable values
+ *
+ * Holds the current and the previous value of a parameter when they are
+ * a float, int, vec2f, vec3f, vec4f, impulse or bool, behind a sequence lock.
+ *
+ * Readers never block the writers: they retry if a write happened
+ * while they were reading.
+ * Writers only contend with each other, for the duration of a few stores.
+ *
+ * Other types (strings, lists...) are not stored: the slot
+ * is then marked as empty and the owner has to store them elsewhere.
+ */
+class value_slot
+{
+public:
+  //! Type of the value when the slot holds something else
+  static constexpr int8_t none = -1;
+
+  static constexpr bool is_trivial(int which) noexcept
+  {
+    return which >= 0 && which <= int(ossia::val_type::BOOL);
+  }
+
+  static bool is_trivial(const ossia::value& v) noexcept
+  {
+    return is_trivial(v.v.which());
+  }
+
+  value_slot() noexcept = default;
+  value_slot(const value_slot&) = delete;
+  value_slot(value_slot&&) = delete;
+  value_slot& operator=(const value_slot&) = delete;
+  value_slot& operator=(value_slot&&) = delete;
+
+  //! Type index of the current value, or none
+  int8_t type() const noexcept
+  {
+    return m_slots[current].type.load(std::memory_order_relaxed);
+  }
+
+  //! False if the slot does not hold the current value
+  bool load(ossia::value& v) const noexcept
+  {
+    return read(current, v);
+  }
+
+  //! False if the slot does not hold the previous value
+  bool load_previous(ossia::value& v) const noexcept
+  {
+    return read(previous, v);
+  }
+
+  /**
+   * @brief Sets the current value.
+   *
+   * The current value becomes the previous one.
+   * \p v must be trivial, see \ref is_trivial.
+   */
+  void store(const ossia::value& v) noexcept
+  {
+    write(make_payload(v), any);
+  }
+
+  /**
+   * @brief Sets the current value if it has the same type as \p v.
+   *
+   * The type is checked by the writer holding the sequence lock, so that
+   * it cannot change between the check and the store.
+   * \p v must be trivial, see \ref is_trivial.
+   *
+   * @return false if the types differ: nothing is stored then.
+   */
+  bool store_same_type(const ossia::value& v) noexcept
+  {
+    return write(make_payload(v), int8_t(v.v.which()));
+  }
+
+  //! Marks the current value as stored outside the slot.
+  void store_none() noexcept
+  {
+    write(payload{}, any);
+  }
+
+private:
+  enum index : int
+  {
+    current = 0,
+    previous = 1
+  };
+
+  //! Accepted by write() as the expected type: writes unconditionally
+  static constexpr int8_t any = -2;
+
+  struct payload
+  {
+    int8_t type{none};
+    uint32_t words[4]{};
+  };
+
+  static payload make_payload(const ossia::value& v) noexcept
+  {
+    payload p;
+    p.type = v.v.which();
+    switch (v.get_type())
+    {
+      case ossia::val_type::FLOAT:
+        std::memcpy(p.words, &v.get<float>(), sizeof(float));
+        break;
+      case ossia::val_type::INT:
+        std::memcpy(p.words, &v.get<int>(), sizeof(int));
+        break;
+      case ossia::val_type::VEC2F:
+        std::memcpy(p.words, v.get<ossia::vec2f>().data(), sizeof(ossia::vec2f));
+        break;
+      case ossia::val_type::VEC3F:
+        std::memcpy(p.words, v.get<ossia::vec3f>().data(), sizeof(ossia::vec3f));
+        break;
+      case ossia::val_type::VEC4F:
+        std::memcpy(p.words, v.get<ossia::vec4f>().data(), sizeof(ossia::vec4f));
+        break;
+      case ossia::val_type::BOOL:
+        p.words[0] = v.get<bool>();
+        break;
+      default:
+        break;
+    }
+    return p;
+  }
+
+  struct atomic_payload
+  {
+    std::atomic<int8_t> type{none};
+    std::atomic<uint32_t> words[4]{};
+
+    payload load() const noexcept
+    {
+      payload p;
+      p.type = type.load(std::memory_order_relaxed);
+      for (int i = 0; i < 4; i++)
+        p.words[i] = words[i].load(std::memory_order_relaxed);
+      return p;
+    }
+
+    void store(const payload& p) noexcept
+    {
+      type.store(p.type, std::memory_order_relaxed);
+      for (int i = 0; i < 4; i++)
+        words[i].store(p.words[i], std::memory_order_relaxed);
+    }
+  };
+
+  bool read(index idx, ossia::value& v) const noexcept
+  {
+    payload p;
+    for (;;)
+    {
+      const uint32_t s1 = m_seq.load(std::memory_order_acquire);
+      if (s1 & 1)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      p = m_slots[idx].load();
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_seq.load(std::memory_order_relaxed) == s1)
+        break;
+    }
+
+    return to_value(p, v);
+  }
+
+  bool write(const payload& p, int8_t expected) noexcept
+  {
+    uint32_t s = m_seq.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      if (!(s & 1)
+          && m_seq.compare_exchange_weak(
+              s, s + 1, std::memory_order_relaxed))
+        break;
+      std::this_thread::yield();
+      s = m_seq.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (expected != any
+        && m_slots[current].type.load(std::memory_order_relaxed) != expected)
+    {
+      m_seq.store(s + 2, std::memory_order_release);
+      return false;
+    }
+
+    m_slots[previous].store(m_slots[current].load());
+    m_slots[current].store(p);
+
+    m_seq.store(s + 2, std::memory_order_release);
+    return true;
+  }
+
+  static bool to_value(const payload& p, ossia::value& v) noexcept
+  {
+    float f[4];
+    switch (p.type)
+    {
+      case int8_t(ossia::val_type::FLOAT):
+        std::memcpy(f, p.words, sizeof(float));
+        v = f[0];
+        return true;
+      case int8_t(ossia::val_type::INT):
+      {
+        int i;
+        std::memcpy(&i, p.words, sizeof(int));
+        v = i;
+        return true;
+      }
+      case int8_t(ossia::val_type::VEC2F):
+        std::memcpy(f, p.words, sizeof(ossia::vec2f));
+        v = ossia::vec2f{f[0], f[1]};
+        return true;
+      case int8_t(ossia::val_type::VEC3F):
+        std::memcpy(f, p.words, sizeof(ossia::vec3f));
+        v = ossia::vec3f{f[0], f[1], f[2]};
+        return true;
+      case int8_t(ossia::val_type::VEC4F):
+        std::memcpy(f, p.words, sizeof(ossia::vec4f));
+        v = ossia::vec4f{f[0], f[1], f[2], f[3]};
+        return true;
+      case int8_t(ossia::val_type::IMPULSE):
+        v = ossia::impulse{};
+        return true;
+      case int8_t(ossia::val_type::BOOL):
+        v = bool(p.words[0]);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  std::atomic<uint32_t> m_seq{0};
+  atomic_payload m_slots[2];
+};
+}
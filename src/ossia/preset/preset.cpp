@@ -9,6 +9,7 @@
 #include <ossia/network/base/parameter.hpp>
 #include <ossia/network/oscquery/detail/value_to_json.hpp>
 #include <ossia/network/value/detail/value_parse_impl.hpp>
+#include <ossia/network/value/value_conversion.hpp>
 #include <ossia/network/base/osc_address.hpp>
 #include <ossia/preset/exception.hpp>
 #include <ossia/preset/preset.hpp>
@@ -25,6 +26,8 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <iostream>
 #include <memory>
@@ -1509,6 +1512,180 @@ void ossia::presets::apply_preset(
   }
 }
 
+namespace ossia::presets
+{
+namespace
+{
+ossia::value
+interpolate_value(const ossia::value& a, const ossia::value& b, double t)
+{
+  if (t >= 1. || a.get_type() != b.get_type())
+    return t >= 1. ? b : a;
+
+  auto lerp = [t](float x, float y) { return float(x + (y - x) * t); };
+  auto lerp_vec = [&](auto x, const auto& y) {
+    for (std::size_t i = 0; i < x.size(); i++)
+      x[i] = lerp(x[i], y[i]);
+    return ossia::value{x};
+  };
+
+  switch (b.get_type())
+  {
+    case ossia::val_type::FLOAT:
+      return lerp(*a.target<float>(), *b.target<float>());
+    case ossia::val_type::INT:
+    {
+      const auto x = *a.target<int32_t>();
+      const auto y = *b.target<int32_t>();
+      return int32_t(std::lround(x + (y - x) * t));
+    }
+    case ossia::val_type::VEC2F:
+      return lerp_vec(*a.target<ossia::vec2f>(), *b.target<ossia::vec2f>());
+    case ossia::val_type::VEC3F:
+      return lerp_vec(*a.target<ossia::vec3f>(), *b.target<ossia::vec3f>());
+    case ossia::val_type::VEC4F:
+      return lerp_vec(*a.target<ossia::vec4f>(), *b.target<ossia::vec4f>());
+    case ossia::val_type::LIST:
+    {
+      const auto& x = *a.target<std::vector<ossia::value>>();
+      const auto& y = *b.target<std::vector<ossia::value>>();
+      if (x.size() != y.size())
+        return a;
+
+      std::vector<ossia::value> res;
+      res.reserve(x.size());
+      for (std::size_t i = 0; i < x.size(); i++)
+        res.push_back(interpolate_value(x[i], y[i], t));
+      return res;
+    }
+    default:
+      return a;
+  }
+}
+}
+
+compiled_preset::compiled_preset() = default;
+compiled_preset::~compiled_preset() = default;
+
+compiled_preset::compiled_preset(
+    ossia::net::node_base& root, const preset& p)
+{
+  m_entries.reserve(p.size());
+  for (const auto& [address, value] : p)
+  {
+    auto n = ossia::net::find_node(root, address);
+    auto param = n ? n->get_parameter() : nullptr;
+    if (!param)
+    {
+      m_unresolved.push_back(address);
+      continue;
+    }
+
+    if (ossia::net::get_recall_safe(*n))
+      continue;
+
+    // Converted once so that comparing with the current value is exact
+    auto target = ossia::convert(value, param->get_value_type());
+    if (target.valid())
+      m_entries.push_back({param, std::move(target), {}});
+  }
+
+  std::stable_sort(
+      m_entries.begin(), m_entries.end(), [](const entry& a, const entry& b) {
+        return &a.parameter->get_node().get_device()
+               < &b.parameter->get_node().get_device();
+      });
+  m_bundle.reserve(m_entries.size());
+}
+
+std::size_t compiled_preset::size() const noexcept
+{
+  return m_entries.size();
+}
+
+const std::vector<std::string>& compiled_preset::unresolved() const noexcept
+{
+  return m_unresolved;
+}
+
+template <typename F>
+std::size_t compiled_preset::push(F&& value_for_entry)
+{
+  std::size_t changed = 0;
+  ossia::net::device_base* device{};
+
+  auto flush = [&] {
+    if (device && !m_bundle.empty())
+    {
+      device->get_protocol().push_bundle(m_bundle);
+      changed += m_bundle.size();
+    }
+    m_bundle.clear();
+  };
+
+  for (auto& e : m_entries)
+  {
+    auto& dev = e.parameter->get_node().get_device();
+    if (&dev != device)
+    {
+      flush();
+      device = &dev;
+    }
+
+    const ossia::value& v = value_for_entry(e);
+    if (e.parameter->value() == v)
+      continue;
+
+    if (e.parameter->set_value(v).valid())
+      m_bundle.push_back(e.parameter);
+  }
+  flush();
+
+  return changed;
+}
+
+std::size_t compiled_preset::apply()
+{
+  m_ticks = 0;
+  return push([](const entry& e) -> const ossia::value& { return e.target; });
+}
+
+void compiled_preset::start_recall(int ticks)
+{
+  m_tick = 0;
+  m_ticks = std::max(ticks, 1);
+  for (auto& e : m_entries)
+    e.start = e.parameter->value();
+}
+
+bool compiled_preset::tick()
+{
+  if (!recalling())
+    return false;
+
+  m_tick++;
+  const double t = double(m_tick) / m_ticks;
+  ossia::value current;
+  push([&](const entry& e) -> const ossia::value& {
+    current = interpolate_value(e.start, e.target, t);
+    return current;
+  });
+
+  if (m_tick >= m_ticks)
+  {
+    m_ticks = 0;
+    for (auto& e : m_entries)
+      e.start = ossia::value{};
+  }
+  return recalling();
+}
+
+bool compiled_preset::recalling() const noexcept
+{
+  return m_ticks > 0;
+}
+}
+
 #if defined(OSSIA_C)
 /// Exception handling ///
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ossia/detail/string_view.hpp>
+#include <ossia/network/value/value.hpp>
 #include <ossia/preset/exception.hpp>
 
 #include <ossia/detail/config.hpp>
@@ -11,6 +12,7 @@
 #include <memory>
 #include <regex>
 #include <string>
+#include <vector>
 
 namespace ossia
 {
@@ -111,5 +113,77 @@ get_node(ossia::net::node_base&, const std::string&);
 
 OSSIA_EXPORT std::string to_string(const ossia::net::device_base& ossiadev);
 
+/**
+ * @brief A preset whose addresses are resolved once.
+ *
+ * Applying it only changes the parameters whose current value differs
+ * from the preset, and sends the changes of each device in a single
+ * protocol bundle.
+ *
+ * It can also be recalled progressively: numeric values are then
+ * interpolated from their value when the recall starts, other values
+ * change on the last tick.
+ *
+ * The parameters must outlive the compiled preset.
+ */
+class OSSIA_EXPORT compiled_preset
+{
+public:
+  compiled_preset();
+  ~compiled_preset();
+
+  /**
+   * @param root : node the addresses of the preset are relative to,
+   * as with apply_preset(const std::string&, node_base&, func_t)
+   *
+   * Addresses without parameter and recall-safe nodes are skipped.
+   */
+  compiled_preset(ossia::net::node_base& root, const preset& p);
+
+  //! Number of parameters the preset applies to
+  std::size_t size() const noexcept;
+
+  //! Addresses of the preset which could not be resolved
+  const std::vector<std::string>& unresolved() const noexcept;
+
+  /**
+   * @brief Set all the parameters to their value in the preset.
+   * @return the number of parameters which changed
+   */
+  std::size_t apply();
+
+  /**
+   * @brief Start an interpolated recall over a number of calls to tick().
+   */
+  void start_recall(int ticks);
+
+  /**
+   * @brief Advance the recall started with start_recall.
+   * @return false once the recall is finished
+   */
+  bool tick();
+
+  bool recalling() const noexcept;
+
+private:
+  struct entry
+  {
+    ossia::net::parameter_base* parameter{};
+    ossia::value target;
+    ossia::value start;
+  };
+
+  template <typename F>
+  std::size_t push(F&& value_for_entry);
+
+  // Sorted by device, so that each device gets one bundle
+  std::vector<entry> m_entries;
+  std::vector<std::string> m_unresolved;
+  std::vector<const ossia::net::parameter_base*> m_bundle;
+
+  int m_tick{};
+  int m_ticks{};
+};
+
 } // namespace presets
 } // namespace ossia
@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/detail/small_vector.hpp>
 #include <ossia/editor/state/message.hpp>
 #include <ossia/network/domain/domain.hpp>
 #include <ossia/protocols/midi/detail/channel.hpp>
@@ -70,7 +71,7 @@ public:
     } catch(...) {
     }
 
-    if(num == -1)
+    if(num < 0 || num > 127)
     {
       return nullptr;
     }
@@ -97,6 +98,26 @@ public:
     return std::make_unique<generic_node>(ai, m_device, *this);
   }
 
+  std::vector<std::string> virtual_children_names() const override
+  {
+    switch(m_info.type)
+    {
+      case address_info::Type::NoteOn:
+      case address_info::Type::NoteOff:
+      case address_info::Type::CC:
+      case address_info::Type::PC:
+      {
+        std::vector<std::string> names;
+        names.reserve(128);
+        for (int i = 0; i < 128; i++)
+          names.push_back(midi_node_name(i));
+        return names;
+      }
+      default:
+        return {};
+    }
+  }
+
   ~generic_node()
   {
     m_children.clear();
@@ -424,24 +445,34 @@ public:
     about_to_be_deleted(*this);
   }
 
-  std::array<ossia::message, 2> note_on(midi_size_t note, midi_size_t vel)
+  //! Creates the nodes for each kind of message, but not their children
+  void create_lazy_children()
   {
-    const auto& c = children();
-    return {{ossia::message{
-                 *c[0]->get_parameter(),
-                 std::vector<ossia::value>{int32_t{note}, int32_t{vel}}},
-             ossia::message{*c[0]->children()[note]->get_parameter(),
-                            int32_t{vel}}}};
+    using T = address_info::Type;
+    for (auto type : {T::NoteOn, T::NoteOff, T::CC, T::PC, T::PB})
+    {
+      m_children.push_back(std::make_unique<generic_node>(
+          address_info{channel, type, 0}, m_device, *this));
+    }
+  }
+
+  std::vector<std::string> virtual_children_names() const override
+  {
+    return {"on", "off", "control", "program", "pitchbend"};
   }
 
-  std::array<ossia::message, 2> note_off(midi_size_t note, midi_size_t vel)
+  //! The messages for the nodes of a note-on which exist: in a lazy tree,
+  //! the node of a note is not created here if nobody looked it up before.
+  ossia::static_vector<ossia::message, 2>
+  note_on(midi_size_t note, midi_size_t vel)
   {
-    const auto& c = children();
-    return {{ossia::message{
-                 *c[1]->get_parameter(),
-                 std::vector<ossia::value>{int32_t{note}, int32_t{vel}}},
-             ossia::message{*c[1]->children()[note]->get_parameter(),
-                            int32_t{vel}}}};
+    return note_messages("on", note, vel);
+  }
+
+  ossia::static_vector<ossia::message, 2>
+  note_off(midi_size_t note, midi_size_t vel)
+  {
+    return note_messages("off", note, vel);
   }
 
 
@@ -476,6 +507,23 @@ public:
     return std::make_unique<generic_node>(ai, m_device, *this);
   }
 
+private:
+  ossia::static_vector<ossia::message, 2>
+  note_messages(ossia::string_view kind, midi_size_t note, midi_size_t vel)
+  {
+    ossia::static_vector<ossia::message, 2> res;
+    auto node = static_cast<midi_node*>(find_existing_child(kind));
+    if (!node)
+      return res;
+
+    res.push_back(ossia::message{
+        *node->get_parameter(),
+        std::vector<ossia::value>{int32_t{note}, int32_t{vel}}});
+
+    if (auto n = node->find_existing_child(midi_node_name(note)))
+      res.push_back(ossia::message{*n->get_parameter(), int32_t{vel}});
+    return res;
+  }
 };
 
 
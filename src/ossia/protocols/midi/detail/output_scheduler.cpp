@@ -0,0 +1,144 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/detail/thread.hpp>
+#include <ossia/protocols/midi/detail/output_scheduler.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace ossia::net::midi
+{
+namespace
+{
+constexpr std::size_t queue_size = 4096;
+}
+
+output_scheduler::output_scheduler(send_function send)
+    : m_send{std::move(send)}, m_queue{queue_size}
+{
+  m_pending.reserve(queue_size);
+  m_thread = std::thread{[this] { run(); }};
+  set_thread_realtime(m_thread);
+}
+
+output_scheduler::~output_scheduler()
+{
+  m_running.store(false, std::memory_order_release);
+  wake();
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+bool output_scheduler::schedule(
+    const ossia::midi_message& m, clock::time_point date) noexcept
+{
+  if (m_queue.try_enqueue(scheduled_message{m, date}))
+  {
+    wake();
+    return true;
+  }
+
+  m_dropped.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+output_scheduler::statistics output_scheduler::stats() const noexcept
+{
+  statistics s;
+  const auto count = m_count.load(std::memory_order_relaxed);
+  s.messages = std::size_t(count);
+  s.dropped = std::size_t(m_dropped.load(std::memory_order_relaxed));
+  if (count > 0)
+    s.mean_lateness = std::chrono::nanoseconds{
+        m_totalLateness.load(std::memory_order_relaxed) / count};
+  s.max_lateness
+      = std::chrono::nanoseconds{m_maxLateness.load(std::memory_order_relaxed)};
+  return s;
+}
+
+void output_scheduler::reset_stats() noexcept
+{
+  m_count.store(0, std::memory_order_relaxed);
+  m_totalLateness.store(0, std::memory_order_relaxed);
+  m_maxLateness.store(0, std::memory_order_relaxed);
+  m_dropped.store(0, std::memory_order_relaxed);
+}
+
+void output_scheduler::run()
+{
+  while (m_running.load(std::memory_order_acquire))
+  {
+    receive_messages();
+    send_due_messages();
+
+    if (m_pending.empty())
+      wait(clock::time_point::max());
+    else
+      wait(m_pending.front().date);
+  }
+
+  // What remains is sent right away, so that no note is left hanging
+  receive_messages();
+  for (const auto& m : m_pending)
+    m_send(m.message);
+  m_pending.clear();
+}
+
+void output_scheduler::wake() noexcept
+{
+  // The flag is set under the mutex, so that the output thread cannot
+  // check it and then miss the notification before it blocks.
+  {
+    std::lock_guard<std::mutex> lck{m_wakeMutex};
+    m_signaled = true;
+  }
+  m_wakeup.notify_one();
+}
+
+void output_scheduler::wait(clock::time_point deadline)
+{
+  std::unique_lock<std::mutex> lck{m_wakeMutex};
+  const auto signaled = [this] { return std::exchange(m_signaled, false); };
+  if (deadline == clock::time_point::max())
+    m_wakeup.wait(lck, signaled);
+  else
+    m_wakeup.wait_until(lck, deadline, signaled);
+}
+
+void output_scheduler::receive_messages()
+{
+  scheduled_message m;
+  while (m_queue.try_dequeue(m))
+  {
+    // Messages mostly come in order: the insertion is usually at the end
+    auto it = std::upper_bound(
+        m_pending.begin(), m_pending.end(), m.date,
+        [](clock::time_point d, const scheduled_message& other) {
+          return d < other.date;
+        });
+    m_pending.insert(it, m);
+  }
+}
+
+void output_scheduler::send_due_messages()
+{
+  auto it = m_pending.begin();
+  for (; it != m_pending.end(); ++it)
+  {
+    const auto now = clock::now();
+    if (it->date > now)
+      break;
+
+    m_send(it->message);
+
+    const auto lateness
+        = std::chrono::duration_cast<std::chrono::nanoseconds>(now - it->date)
+              .count();
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalLateness.fetch_add(lateness, std::memory_order_relaxed);
+    if (lateness > m_maxLateness.load(std::memory_order_relaxed))
+      m_maxLateness.store(lateness, std::memory_order_relaxed);
+  }
+  m_pending.erase(m_pending.begin(), it);
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <ossia/dataflow/midi_message.hpp>
+#include <ossia/detail/config.hpp>
+#include <ossia/detail/lockfree_queue.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ossia::net::midi
+{
+/**
+ * @brief Sends MIDI messages at a given date, from a dedicated thread
+ *
+ * The execution thread schedules the messages of a tick with the date of
+ * their sample offset; the output thread sleeps until the date of the next
+ * message, or until a new message is scheduled.
+ *
+ * The lateness of each message relative to its date is measured.
+ */
+class OSSIA_EXPORT output_scheduler
+{
+public:
+  using clock = std::chrono::steady_clock;
+  using send_function = std::function<void(const ossia::midi_message&)>;
+
+  struct statistics
+  {
+    std::size_t messages{};
+    std::size_t dropped{};
+    std::chrono::nanoseconds mean_lateness{};
+    std::chrono::nanoseconds max_lateness{};
+  };
+
+  explicit output_scheduler(send_function send);
+  ~output_scheduler();
+
+  output_scheduler(const output_scheduler&) = delete;
+  output_scheduler(output_scheduler&&) = delete;
+  output_scheduler& operator=(const output_scheduler&) = delete;
+  output_scheduler& operator=(output_scheduler&&) = delete;
+
+  //! Called from a single thread; does not allocate, and only locks the
+  //! mutex that the output thread holds for a few instructions.
+  //! The output thread is woken up if it was waiting.
+  //! Returns false if the queue is full, in which case the message is dropped.
+  bool schedule(const ossia::midi_message& m, clock::time_point date) noexcept;
+
+  //! Measured since the last reset
+  statistics stats() const noexcept;
+  void reset_stats() noexcept;
+
+private:
+  struct scheduled_message
+  {
+    ossia::midi_message message;
+    clock::time_point date;
+  };
+
+  void run();
+  void wake() noexcept;
+  //! Until the deadline, or a message is scheduled; time_point::max()
+  //! to wait for a message only
+  void wait(clock::time_point deadline);
+  void receive_messages();
+  void send_due_messages();
+
+  send_function m_send;
+  ossia::spsc_queue<scheduled_message> m_queue;
+
+  // Only accessed from the output thread, sorted by date
+  std::vector<scheduled_message> m_pending;
+
+  std::atomic<int64_t> m_count{};
+  std::atomic<int64_t> m_totalLateness{};
+  std::atomic<int64_t> m_maxLateness{};
+  std::atomic<int64_t> m_dropped{};
+
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wakeup;
+  bool m_signaled{};
+
+  std::atomic_bool m_running{true};
+  std::thread m_thread;
+};
+}
@@ -54,6 +54,45 @@ std::unique_ptr<node_base> midi_device::make_child(const std::string& name)
   return nullptr;
 }
 
+std::vector<std::string> midi_device::virtual_children_names() const
+{
+  std::vector<std::string> names;
+  names.reserve(16);
+  for (int i = 1; i <= 16; i++)
+    names.push_back(midi_node_name(i));
+  return names;
+}
+
+bool midi_device::create_lazy_tree()
+{
+  clear_children();
+
+  m_parameter = std::make_unique<midi_parameter>(
+      address_info{{}, address_info::Type::Any, {}}, *this);
+
+  try
+  {
+    for (int i = 1; i <= 16; i++)
+    {
+      auto ptr = std::make_unique<channel_node>(false, i, *this, *this);
+      ptr->create_lazy_children();
+
+      write_lock_t lock{m_mutex};
+      m_children.push_back(std::move(ptr));
+    }
+  }
+  catch (std::exception& e)
+  {
+    logger().error("midi_device::create_lazy_tree() catched: {}", e.what());
+  }
+  catch (...)
+  {
+    logger().error("midi_device::create_lazy_tree() failed.");
+    return false;
+  }
+  return true;
+}
+
 bool midi_device::create_full_tree()
 {
   clear_children();
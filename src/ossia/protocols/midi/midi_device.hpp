@@ -16,6 +16,19 @@ public:
   //! Create a default MIDI tree with all the nodes available
   bool create_full_tree();
 
+  /**
+   * @brief Create a MIDI tree where only the channels and the message
+   * kinds exist, e.g. /1/on, /1/control...
+   *
+   * Nodes for specific notes, controls and programs (e.g. /1/on/64) are
+   * created the first time they are looked up, with node_base::find_child
+   * or ossia::net::find_or_create_node.
+   * midi_node::virtual_children_names lists them without creating them.
+   */
+  bool create_lazy_tree();
+
+  std::vector<std::string> virtual_children_names() const override;
+
   using midi_node::get_name;
   using midi_node::get_parameter;
 
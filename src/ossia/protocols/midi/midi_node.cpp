@@ -88,4 +88,50 @@ midi_node* midi_node::add_midi_node(std::unique_ptr<midi_node> n)
   return ptr;
 }
 
+std::vector<std::string> midi_node::virtual_children_names() const
+{
+  return children_names();
+}
+
+node_base* midi_node::find_existing_child(ossia::string_view name) const
+{
+  read_lock_t lock{m_mutex};
+  for (auto& node : m_children)
+  {
+    if (node->get_name() == name)
+      return node.get();
+  }
+  return nullptr;
+}
+
+node_base* midi_node::find_lazy_child(ossia::string_view name)
+{
+  if (!m_device.get_capabilities().change_tree)
+    return nullptr;
+
+  node_base* ptr{};
+  {
+    write_lock_t lock{m_mutex};
+
+    // Another thread may have created it in the meantime
+    for (auto& node : m_children)
+    {
+      if (node->get_name() == name)
+        return node.get();
+    }
+
+    auto res = make_child(std::string(name));
+
+    // e.g. "064" would give a node named "64"
+    if (!res || res->get_name() != name)
+      return nullptr;
+
+    ptr = res.get();
+    m_children.push_back(std::move(res));
+  }
+
+  m_device.on_node_created(*ptr);
+  return ptr;
+}
+
 }
@@ -36,5 +36,16 @@ public:
 
   //! Explicitely add a child node (which has to be valid)
   midi_node* add_midi_node(std::unique_ptr<midi_node> n);
+
+  //! Names of all the children this node can have, whether they
+  //! have been created yet or not.
+  virtual std::vector<std::string> virtual_children_names() const;
+
+  //! Returns the child with this name if it was already created.
+  //! Never allocates, so that it can be used from the MIDI callbacks.
+  node_base* find_existing_child(ossia::string_view name) const;
+
+protected:
+  node_base* find_lazy_child(ossia::string_view name) override;
 };
 }
@@ -135,7 +135,30 @@ void midi_parameter::on_removing_last_callback()
 
 void midi_parameter::value_callback(const ossia::value& val)
 {
-  this->set_value(val);
+  // Unlike set_value, no copy of the value is returned
+  if (m_type == val.get_type())
+    m_value = val;
+  else
+    m_value = ossia::convert(val, m_type);
+
+  send(m_value);
+}
+
+void midi_parameter::value_callback(int32_t a, int32_t b)
+{
+  // The existing list is reused: no allocation for each received message
+  auto vec = m_value.target<std::vector<ossia::value>>();
+  if (vec && vec->size() == 2)
+  {
+    (*vec)[0] = a;
+    (*vec)[1] = b;
+  }
+  else
+  {
+    m_value = std::vector<ossia::value>{a, b};
+  }
+
+  send(m_value);
 }
 }
 }
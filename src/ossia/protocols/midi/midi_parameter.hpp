@@ -164,6 +164,9 @@ public:
 
   void value_callback(const ossia::value& val);
 
+  //! For [ note, velocity ] or [ CC, value ] lists
+  void value_callback(int32_t a, int32_t b);
+
 protected:
   address_info m_info;
   ossia::net::protocol_base& m_protocol;
@@ -33,6 +33,7 @@ midi_protocol::midi_protocol(ossia::net::network_context_ptr ctx, midi_info m, l
 
 midi_protocol::~midi_protocol()
 {
+  m_scheduler.reset();
   try
   {
     m_input->close_port();
@@ -62,6 +63,7 @@ bool midi_protocol::set_info(midi_info m)
     }
     else if (m_info.type == midi_info::Type::Output)
     {
+      m_scheduler.reset();
       m_output->close_port();
     }
 
@@ -82,6 +84,9 @@ bool midi_protocol::set_info(midi_info m)
         m_output->open_port(m_info.port, m_dev->get_name());
       else
         m_output->open_port(m_info.port, "libossia MIDI out");
+
+      m_scheduler = std::make_unique<output_scheduler>(
+          [this](const ossia::midi_message& m) { push_value(m); });
     }
 
     return true;
@@ -186,6 +191,7 @@ bool midi_protocol::push(const parameter_base& address, const ossia::value& v)
     if (m_info.type != midi_info::Type::Output)
       return false;
 
+    std::lock_guard<std::mutex> lck{m_outputMutex};
     auto& adrinfo = adrs.info();
     switch (adrinfo.type)
     {
@@ -355,9 +361,15 @@ void midi_protocol::set_device(device_base& dev)
   m_dev = static_cast<midi_device*>(&dev);
 }
 
-void midi_protocol::value_callback(parameter_base& param, const value& val)
+void midi_protocol::value_callback(midi_parameter& param, const value& val)
+{
+  param.value_callback(val);
+  m_dev->on_message(param);
+}
+
+void midi_protocol::value_callback(midi_parameter& param, int32_t a, int32_t b)
 {
-  param.set_value(val);
+  param.value_callback(a, b);
   m_dev->on_message(param);
 }
 
@@ -379,7 +391,12 @@ void midi_protocol::midi_callback(const libremidi::message& mess)
     return;
 
   if (m_registers)
-    messages.enqueue(mess);
+  {
+    // System exclusive messages are not sent to the execution
+    ossia::midi_message m;
+    if (m.assign(mess.bytes.data(), mess.bytes.size()))
+      messages.try_enqueue(m);
+  }
 
   midi_channel& c = m_channels[chan - 1];
   switch (mess.get_message_type())
@@ -390,9 +407,7 @@ void midi_protocol::midi_callback(const libremidi::message& mess)
       c.note_on_N[c.note_on.first] = c.note_on.second;
       if (auto ptr = c.callback_note_on)
       {
-        std::vector<ossia::value> t{int32_t{c.note_on.first},
-                                    int32_t{c.note_on.second}};
-        value_callback(*ptr, t);
+        value_callback(*ptr, c.note_on.first, c.note_on.second);
       }
       if (auto ptr = c.callback_note_on_N[c.note_on.first])
       {
@@ -406,9 +421,7 @@ void midi_protocol::midi_callback(const libremidi::message& mess)
       c.note_off_N[c.note_off.first] = c.note_off.second;
       if (auto ptr = c.callback_note_off)
       {
-        std::vector<ossia::value> t{int32_t{c.note_off.first},
-                                    int32_t{c.note_off.second}};
-        value_callback(*ptr, t);
+        value_callback(*ptr, c.note_off.first, c.note_off.second);
       }
       if (auto ptr = c.callback_note_off_N[c.note_off.first])
       {
@@ -422,9 +435,7 @@ void midi_protocol::midi_callback(const libremidi::message& mess)
       c.cc_N[c.cc.first] = c.cc.second;
       if (auto ptr = c.callback_cc)
       {
-        std::vector<ossia::value> t{int32_t{c.cc.first},
-                                    int32_t{c.cc.second}};
-        value_callback(*ptr, t);
+        value_callback(*ptr, c.cc.first, c.cc.second);
       }
       if (auto ptr = c.callback_cc_N[c.cc.first])
       {
@@ -549,9 +560,30 @@ std::vector<midi_info> midi_protocol::scan(libremidi::API api)
   return vec;
 }
 
-void midi_protocol::push_value(const libremidi::message& m)
+void midi_protocol::push_value(const ossia::midi_message& m)
+{
+  std::lock_guard<std::mutex> lck{m_outputMutex};
+  m_output->send_message(m.bytes.data(), m.size());
+}
+
+void midi_protocol::push_value(
+    const ossia::midi_message& m, output_scheduler::clock::time_point date)
+{
+  if (m_scheduler)
+    m_scheduler->schedule(m, date);
+  else
+    push_value(m);
+}
+
+output_scheduler::statistics midi_protocol::output_timing() const noexcept
+{
+  return m_scheduler ? m_scheduler->stats() : output_scheduler::statistics{};
+}
+
+void midi_protocol::reset_output_timing() noexcept
 {
-  m_output->send_message(m);
+  if (m_scheduler)
+    m_scheduler->reset_stats();
 }
 
 void midi_protocol::enable_registration()
@@ -5,9 +5,11 @@
 #include <ossia/network/common/parameter_properties.hpp>
 #include <ossia/network/domain/domain.hpp>
 #include <ossia/protocols/midi/detail/channel.hpp>
+#include <ossia/protocols/midi/detail/output_scheduler.hpp>
 #include <ossia/network/value/value.hpp>
 #include <ossia/network/context_functions.hpp>
 
+#include <ossia/dataflow/midi_message.hpp>
 #include <ossia/detail/lockfree_queue.hpp>
 
 #include <libremidi/api.hpp>
@@ -15,6 +17,7 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <mutex>
 namespace libremidi
 {
 class midi_in;
@@ -24,6 +27,7 @@ struct message;
 namespace ossia::net::midi
 {
 class midi_device;
+class midi_parameter;
 struct OSSIA_EXPORT midi_info
 {
   enum class Type
@@ -55,12 +59,21 @@ public:
 
   static std::vector<midi_info> scan(libremidi::API = libremidi::API::UNSPECIFIED);
 
-  void push_value(const libremidi::message&);
+  void push_value(const ossia::midi_message&);
 
+  //! Sends the message at the given date, from the output thread.
+  //! Always called from the same thread.
+  void push_value(const ossia::midi_message&, output_scheduler::clock::time_point date);
+
+  //! Timing of the messages sent with push_value(message, date)
+  output_scheduler::statistics output_timing() const noexcept;
+  void reset_output_timing() noexcept;
+
+  //! Called from the execution thread with the messages received since the last call
   template <typename T>
   void clone_value(T& port)
   {
-    typename T::value_type mess;
+    ossia::midi_message mess;
     while (messages.try_dequeue(mess))
     {
       port.push_back(mess);
@@ -73,10 +86,17 @@ public:
   void set_learning(bool);
 
 private:
-  ossia::spsc_queue<libremidi::message> messages;
+  // Preallocated: the MIDI thread never allocates when pushing to it.
+  // When the execution does not keep up, new messages are dropped.
+  static constexpr std::size_t queue_size = 4096;
+  ossia::spsc_queue<ossia::midi_message> messages{queue_size};
   ossia::net::network_context_ptr m_context;
   std::unique_ptr<libremidi::midi_in> m_input;
   std::unique_ptr<libremidi::midi_out> m_output;
+  std::unique_ptr<output_scheduler> m_scheduler;
+
+  // The output is used by the scheduler thread and by direct pushes
+  std::mutex m_outputMutex;
 
   std::array<midi_channel, 16> m_channels;
 
@@ -95,8 +115,8 @@ private:
   bool update(ossia::net::node_base& node_base) override;
   void set_device(ossia::net::device_base& dev) override;
 
-  void
-  value_callback(ossia::net::parameter_base& param, const ossia::value& val);
+  void value_callback(midi_parameter& param, const ossia::value& val);
+  void value_callback(midi_parameter& param, int32_t a, int32_t b);
 
   void midi_callback(const libremidi::message&);
   void on_learn(const libremidi::message& m);
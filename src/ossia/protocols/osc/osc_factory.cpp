@@ -3,6 +3,7 @@
 #include <ossia/network/sockets/null_socket.hpp>
 #include <ossia/network/sockets/serial_socket.hpp>
 #include <ossia/network/sockets/udp_socket.hpp>
+#include <ossia/network/sockets/udp_batch_socket.hpp>
 #include <ossia/network/sockets/tcp_socket.hpp>
 #include <ossia/network/sockets/unix_socket.hpp>
 #include <ossia/network/sockets/websocket.hpp>
@@ -10,6 +11,19 @@
 
 namespace ossia::net
 {
+template<typename OscMode, typename SendSocket, typename RecvSocket>
+std::unique_ptr<osc_protocol_base> make_udp_osc_protocol(network_context_ptr&& ctx, const udp_configuration& conf)
+{
+  if(conf.remote && conf.local)
+    return std::make_unique<osc_generic_bidir_protocol<OscMode, SendSocket, RecvSocket>>(std::move(ctx), *conf.remote, *conf.local);
+  else if(conf.remote)
+    return std::make_unique<osc_generic_bidir_protocol<OscMode, SendSocket, null_socket>>(std::move(ctx), *conf.remote);
+  else if(conf.local)
+    return std::make_unique<osc_generic_bidir_protocol<OscMode, null_socket, RecvSocket>>(std::move(ctx), *conf.local);
+  else
+    return {};
+}
+
 template<typename OscVersion>
 std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&& ctx, osc_protocol_configuration&& config)
 {
@@ -26,14 +40,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
         auto operator()(ossia::net::udp_configuration&& conf) const
             -> std::unique_ptr<osc_protocol_base>
         {
-          if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local);
-          else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote);
-          else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local);
-          else
-            return {};
+#if defined(OSSIA_HAS_UDP_BATCHING)
+          if(config.udp_batching)
+            return make_udp_osc_protocol<client_type, udp_batch_send_socket, udp_batch_receive_socket>(std::move(ctx), conf);
+#endif
+          return make_udp_osc_protocol<client_type, udp_send_socket, udp_receive_socket>(std::move(ctx), conf);
         }
 
         auto operator()(ossia::net::tcp_configuration&& conf) const
@@ -107,14 +118,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
         auto operator()(ossia::net::udp_configuration&& conf) const
             -> std::unique_ptr<osc_protocol_base>
         {
-          if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local);
-          else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote);
-          else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local);
-          else
-            return {};
+#if defined(OSSIA_HAS_UDP_BATCHING)
+          if(config.udp_batching)
+            return make_udp_osc_protocol<client_type, udp_batch_send_socket, udp_batch_receive_socket>(std::move(ctx), conf);
+#endif
+          return make_udp_osc_protocol<client_type, udp_send_socket, udp_receive_socket>(std::move(ctx), conf);
         }
 
         auto operator()(ossia::net::tcp_configuration&& conf) const
@@ -20,6 +20,10 @@ struct osc_protocol_configuration
   enum { SIZE_PREFIX, SLIP }
   framing{SLIP};
 
+  // Only relevant for UDP: on Linux, read and write datagrams in batches,
+  // with one recvmmsg / sendmmsg system call per batch.
+  bool udp_batching{false};
+
   ossia::variant<
         udp_configuration
       , tcp_configuration
@@ -38,6 +38,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/ptr_set.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/pod_vector.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/ptr_container.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/rcu.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/regex_fwd.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/std_fwd.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/safe_vec.hpp"
@@ -52,6 +53,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/to_tuple.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/typelist.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/variant.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/work_stealing_deque.hpp"
 #    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/instantiations.hpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/parameter_properties.hpp"
@@ -63,6 +65,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/configuration.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/tcp_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/udp_socket.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/udp_batch_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/unix_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/serial_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/null_socket.hpp"
@@ -115,6 +118,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/debug.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/extended_types.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/path.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/address_index.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/complex_type.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/device_parameter.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/generic/generic_parameter.hpp"
@@ -143,6 +147,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/value/value_algorithms.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/value/value_variant_impl.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/value/value_hash.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/value/value_slot.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/value/vec.hpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/dataspace/detail/dataspace_parse.hpp"
@@ -181,6 +186,7 @@ set(SRCS
 #    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/ossia.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/context.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/thread.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/rcu.cpp"
 #    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/instantiations.cpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/context.cpp"
@@ -201,6 +207,7 @@ set(SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/protocol.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/extended_types.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/path.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/address_index.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/complex_type.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/debug.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/device_parameter.cpp"
@@ -371,10 +378,13 @@ set(OSSIA_MINUIT_HEADERS
   "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_parser.hpp"
   "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_common.hpp"
   "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_name_table.hpp"
+  "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_requests.hpp"
+  "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_cache.hpp"
   )
 set(OSSIA_MINUIT_SRCS
   "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/minuit.cpp"
   "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_impl.cpp"
+  "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/minuit/detail/minuit_cache.cpp"
   )
 
 set(OSSIA_MIDI_HEADERS
@@ -385,13 +395,15 @@ set(OSSIA_MIDI_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_parameter.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/detail/channel.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/detail/midi_impl.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/detail/output_scheduler.hpp"
     )
 
 set(OSSIA_MIDI_SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_device.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_protocol.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_node.cpp"
-    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_parameter.cpp")
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/midi_parameter.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/midi/detail/output_scheduler.cpp")
 
 set(OSSIA_OSCQUERY_HEADERS
 
@@ -419,6 +431,8 @@ set(OSSIA_OSCQUERY_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/oscquery_units.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/oscquery_protocol_common.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/osc_writer.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/outbound_queue.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/binary_namespace.hpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/oscquery/oscquery_mirror_asio.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/protocols/oscquery/oscquery_server_asio.hpp"
@@ -434,6 +448,7 @@ set(OSSIA_OSCQUERY_SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/html_writer.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/query_parser.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/osc_writer.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/binary_namespace.cpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/attributes.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/oscquery/detail/typetag.cpp"
@@ -617,25 +632,32 @@ set(OSSIA_QT_SCORE_SRCS
 )
 
 set(OSSIA_DATAFLOW_HEADERS
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_kernels.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_parameter.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_engine.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_device.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_tick.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/drwav_handle.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/sample_cache.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/sound_stream.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/portaudio_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/pulseaudio_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/jack_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/sdl_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/dummy_protocol.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/offline_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/bench_map.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/dataflow.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/connection.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/control_rate.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/data.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/value_vector.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/value_port.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_port.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_stretch_mode.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/buffer_clock.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/midi_message.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/midi_port.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/data_copy.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/dataflow_fwd.hpp"
@@ -710,10 +732,13 @@ set(OSSIA_DATAFLOW_HEADERS
 )
 
 set(OSSIA_DATAFLOW_SRCS
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_kernels.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_kernels_impl.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_parameter.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_protocol.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_device.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_engine.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/sample_cache.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/data.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/port.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph_node.cpp"
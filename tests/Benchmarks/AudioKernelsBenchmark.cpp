@@ -0,0 +1,83 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/audio/audio_kernels.hpp>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// Mixing many channels of a 512-sample buffer in one sink,
+// as the audio inlets do every tick.
+
+using namespace ossia::audio_kernels;
+
+static constexpr std::size_t buffer_size = 512;
+
+static void run_mix(benchmark::State& state, isa i)
+{
+  if (i > best_isa())
+  {
+    state.SkipWithError("Not supported by this CPU");
+    return;
+  }
+  set_isa(i);
+
+  const std::size_t channels = state.range(0);
+  std::vector<std::vector<double>> sources(
+      channels, std::vector<double>(buffer_size, 0.1));
+  std::vector<double> sink(buffer_size);
+
+  for (auto _ : state)
+  {
+    for (auto& src : sources)
+      add(sink.data(), src.data(), buffer_size);
+    benchmark::DoNotOptimize(sink.data());
+  }
+  state.SetItemsProcessed(state.iterations() * channels * buffer_size);
+  set_isa(best_isa());
+}
+
+static void run_output(benchmark::State& state, isa i)
+{
+  if (i > best_isa())
+  {
+    state.SkipWithError("Not supported by this CPU");
+    return;
+  }
+  set_isa(i);
+
+  // Conversion to the float buffer of the sound card, then interleaving
+  std::vector<double> left(buffer_size, 0.1), right(buffer_size, 0.2);
+  std::vector<float> l(buffer_size), r(buffer_size), out(2 * buffer_size);
+  const float* chans[2]{l.data(), r.data()};
+
+  for (auto _ : state)
+  {
+    convert(l.data(), left.data(), buffer_size);
+    convert(r.data(), right.data(), buffer_size);
+    interleave(out.data(), chans, 2, buffer_size);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * buffer_size);
+  set_isa(best_isa());
+}
+
+static void BM_mix_scalar(benchmark::State& s) { run_mix(s, isa::scalar); }
+static void BM_mix_sse2(benchmark::State& s) { run_mix(s, isa::sse2); }
+static void BM_mix_avx2(benchmark::State& s) { run_mix(s, isa::avx2); }
+static void BM_mix_avx512(benchmark::State& s) { run_mix(s, isa::avx512); }
+static void BM_output_scalar(benchmark::State& s) { run_output(s, isa::scalar); }
+static void BM_output_sse2(benchmark::State& s) { run_output(s, isa::sse2); }
+static void BM_output_avx2(benchmark::State& s) { run_output(s, isa::avx2); }
+static void BM_output_avx512(benchmark::State& s) { run_output(s, isa::avx512); }
+
+BENCHMARK(BM_mix_scalar)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_mix_sse2)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_mix_avx2)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_mix_avx512)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_output_scalar);
+BENCHMARK(BM_output_sse2);
+BENCHMARK(BM_output_avx2);
+BENCHMARK(BM_output_avx512);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,86 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/editor/curve/curve.hpp>
+#include <ossia/editor/curve/curve_segment/linear.hpp>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+// Evaluation of a curve with a varying number of breakpoints,
+// as automations do once per tick or once per sub-block.
+
+static ossia::curve<double, float> make_curve(int points)
+{
+  ossia::curve<double, float> c;
+  c.set_x0(0.);
+  c.set_y0(0.);
+  std::mt19937 rng(points);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  for (int i = 1; i <= points; i++)
+    c.add_point(ossia::curve_segment_linear<float>{}, double(i) / points, dist(rng));
+  return c;
+}
+
+// A playhead moving forward
+static void BM_value_at_forward(benchmark::State& state)
+{
+  const auto c = make_curve(state.range(0));
+  const double step = 1. / 100000.;
+  double x = 0.;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(c.value_at(x));
+    x += step;
+    if (x > 1.)
+      x = 0.;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Arbitrary positions, e.g. when seeking or with a mapping
+static void BM_value_at_random(benchmark::State& state)
+{
+  const auto c = make_curve(state.range(0));
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> dist(0., 1.);
+  std::vector<double> xs(4096);
+  for (auto& x : xs)
+    x = dist(rng);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(c.value_at(xs[i]));
+    i = (i + 1) % xs.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// One value per sample for a 512-sample buffer
+static void BM_values_at_block(benchmark::State& state)
+{
+  const auto c = make_curve(state.range(0));
+  constexpr int block = 512;
+  std::vector<double> xs(block);
+  std::vector<float> ys(block);
+  double start = 0.;
+  for (auto _ : state)
+  {
+    for (int i = 0; i < block; i++)
+      xs[i] = start + i * 1e-6;
+    c.values_at(xs, ys);
+    benchmark::DoNotOptimize(ys.data());
+
+    start += block * 1e-6;
+    if (start > 1.)
+      start = 0.;
+  }
+  state.SetItemsProcessed(state.iterations() * block);
+}
+
+BENCHMARK(BM_value_at_forward)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_value_at_random)->RangeMultiplier(10)->Range(1, 100000);
+BENCHMARK(BM_values_at_block)->RangeMultiplier(10)->Range(1, 100000);
+
+BENCHMARK_MAIN();
@@ -34,6 +34,9 @@ void benchmark_main()
   // We need a graph
 
 
+  std::cout << "audio ports: "
+            << (std::is_same_v<ossia::audio_port_sample, float> ? "float" : "double")
+            << "\n";
   std::cout << "count\tnormal\tordered\tmerged\n";
   ossia::audio_device device;
   int64_t count = 0;
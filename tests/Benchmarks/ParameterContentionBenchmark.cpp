@@ -0,0 +1,65 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/network/generic/generic_parameter.hpp>
+#include <ossia/network/local/local.hpp>
+#include <benchmark/benchmark.h>
+
+// One thread writes a parameter, like the network thread does,
+// while the other threads read it, like the audio or execution threads do.
+
+static ossia::net::parameter_base& shared_parameter(ossia::val_type t)
+{
+  static ossia::net::generic_device dev{
+      std::make_unique<ossia::net::multiplex_protocol>(), "bench"};
+
+  auto& node = ossia::net::find_or_create_node(
+      dev, std::string("/") + std::to_string(int(t)));
+  if (auto p = node.get_parameter())
+    return *p;
+  return *node.create_parameter(t);
+}
+
+template <typename F>
+static void run(benchmark::State& state, ossia::val_type t, F make_value)
+{
+  auto& param = shared_parameter(t);
+  int64_t i = 0;
+  if (state.thread_index() == 0)
+  {
+    for (auto _ : state)
+      param.set_value(make_value(i++));
+  }
+  else
+  {
+    for (auto _ : state)
+      benchmark::DoNotOptimize(param.value());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_contention_float(benchmark::State& state)
+{
+  run(state, ossia::val_type::FLOAT, [] (int64_t i) { return ossia::value{float(i)}; });
+}
+
+static void BM_contention_vec4f(benchmark::State& state)
+{
+  run(state, ossia::val_type::VEC4F, [] (int64_t i) {
+    const float f = i;
+    return ossia::value{ossia::vec4f{f, f, f, f}};
+  });
+}
+
+// Strings still go through the mutex
+static void BM_contention_string(benchmark::State& state)
+{
+  run(state, ossia::val_type::STRING, [] (int64_t i) { return ossia::value{std::to_string(i)}; });
+}
+
+BENCHMARK(BM_contention_float)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_contention_vec4f)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_contention_string)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
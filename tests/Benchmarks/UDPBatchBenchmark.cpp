@@ -0,0 +1,84 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/network/context.hpp>
+#include <ossia/network/sockets/udp_socket.hpp>
+#include <ossia/network/sockets/udp_batch_socket.hpp>
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+// Loopback throughput of the UDP sockets used by the OSC protocols.
+// Each iteration sends state.range(0) datagrams in one "tick"
+// and waits until they have all been received.
+
+static const char osc_message[] = "/mixer/1/gain\0\0\0,f\0\0\x3f\x80\0\0";
+static constexpr int osc_message_size = sizeof(osc_message) - 1;
+
+template<typename SendSocket, typename ReceiveSocket>
+struct loopback
+{
+  ossia::net::network_context ctx;
+  ReceiveSocket recv{ossia::net::socket_configuration{"127.0.0.1", 9987}, ctx.context};
+  SendSocket send{ossia::net::socket_configuration{"127.0.0.1", 9987}, ctx.context};
+  int64_t received{};
+  int64_t lost{};
+
+  loopback()
+  {
+    recv.open();
+    send.connect();
+    recv.receive([this] (const char*, std::size_t) { received++; });
+  }
+
+  void tick(int messages)
+  {
+    const auto expected = received + messages;
+    for(int i = 0; i < messages; i++)
+      send.write(osc_message, osc_message_size);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while(received < expected && std::chrono::steady_clock::now() < deadline)
+      ctx.context.poll();
+
+    if(received < expected)
+    {
+      lost += expected - received;
+      received = expected;
+    }
+  }
+};
+
+static void BM_udp_single(benchmark::State& state)
+{
+  const int messages = state.range(0);
+  loopback<ossia::net::udp_send_socket, ossia::net::udp_receive_socket> lb;
+  for (auto _ : state)
+    lb.tick(messages);
+
+  state.counters["msg/s"] = benchmark::Counter(state.iterations() * messages, benchmark::Counter::kIsRate);
+  state.counters["lost"] = lb.lost;
+}
+
+#if defined(OSSIA_HAS_UDP_BATCHING)
+static void BM_udp_batched(benchmark::State& state)
+{
+  const int messages = state.range(0);
+  loopback<ossia::net::udp_batch_send_socket, ossia::net::udp_batch_receive_socket> lb;
+  for (auto _ : state)
+    lb.tick(messages);
+
+  const double total = state.iterations() * messages;
+  const double syscalls = lb.send.stats().syscalls + lb.recv.stats().syscalls;
+  state.counters["msg/s"] = benchmark::Counter(total, benchmark::Counter::kIsRate);
+  state.counters["syscalls/msg"] = syscalls / total;
+  state.counters["lost"] = lb.lost;
+}
+#endif
+
+BENCHMARK(BM_udp_single)->RangeMultiplier(4)->Range(1, 1024);
+#if defined(OSSIA_HAS_UDP_BATCHING)
+BENCHMARK(BM_udp_batched)->RangeMultiplier(4)->Range(1, 1024);
+#endif
+
+BENCHMARK_MAIN();
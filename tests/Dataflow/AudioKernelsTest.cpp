@@ -0,0 +1,147 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/audio/audio_kernels.hpp>
+
+#include <catch2/catch_approx.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace ossia::audio_kernels;
+
+// Every instruction set must give the results of the plain loops,
+// including for the sizes which are not a multiple of the vector width.
+TEST_CASE ("test_audio_kernels", "test_audio_kernels")
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1., 1.);
+
+  const auto best = best_isa();
+  for (isa i : {isa::scalar, isa::sse2, isa::avx2, isa::avx512})
+  {
+    if (i > best)
+      continue;
+    set_isa(i);
+    REQUIRE(current_isa() == i);
+
+    for (std::size_t n : {0, 1, 3, 7, 8, 15, 17, 33, 512, 1023})
+    {
+      std::vector<double> a(n), b(n), r(n);
+      std::vector<float> f(n), g(n), rf(n);
+      for (std::size_t k = 0; k < n; k++)
+      {
+        a[k] = dist(rng);
+        b[k] = dist(rng);
+        f[k] = dist(rng);
+        g[k] = dist(rng);
+      }
+
+      r = a;
+      add(r.data(), b.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == a[k] + b[k]);
+
+      r = a;
+      add_scaled(r.data(), b.data(), 0.3, n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == Catch::Approx(a[k] + 0.3 * b[k]));
+
+      r = a;
+      scale(r.data(), r.data(), 0.5, n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == 0.5 * a[k]);
+
+      multiply(r.data(), a.data(), f.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == f[k] * a[k]);
+
+      convert(r.data(), f.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == f[k]);
+
+      convert(rf.data(), a.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == float(a[k]));
+
+      r = a;
+      add_converted(r.data(), f.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(r[k] == a[k] + f[k]);
+
+      rf = g;
+      add_converted(rf.data(), a.data(), 0.5, n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == Catch::Approx(g[k] + 0.5 * a[k]));
+
+      std::vector<double> left(n), right(n);
+      double* spread[2]{left.data(), right.data()};
+      const double weights[2]{0.25, 0.75};
+      add_spread(spread, weights, 2, a.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+      {
+        REQUIRE(left[k] == 0.25 * a[k]);
+        REQUIRE(right[k] == 0.75 * a[k]);
+      }
+
+      // Float overloads, used by the audio ports with OSSIA_AUDIO_FLOAT
+      rf = f;
+      add(rf.data(), g.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == f[k] + g[k]);
+
+      rf = f;
+      add_scaled(rf.data(), g.data(), 0.3, n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == Catch::Approx(f[k] + 0.3f * g[k]));
+
+      rf = f;
+      scale(rf.data(), rf.data(), 0.5, n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == 0.5f * f[k]);
+
+      multiply(rf.data(), f.data(), g.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+        REQUIRE(rf[k] == g[k] * f[k]);
+
+      std::vector<float> left_f(n), right_f(n);
+      float* spread_f[2]{left_f.data(), right_f.data()};
+      add_spread(spread_f, weights, 2, f.data(), n);
+      for (std::size_t k = 0; k < n; k++)
+      {
+        REQUIRE(left_f[k] == 0.25f * f[k]);
+        REQUIRE(right_f[k] == 0.75f * f[k]);
+      }
+
+      for (std::size_t channels : {1, 2, 3})
+      {
+        std::vector<std::vector<float>> chans(channels, std::vector<float>(n));
+        std::vector<const float*> in;
+        for (auto& c : chans)
+        {
+          for (auto& s : c)
+            s = dist(rng);
+          in.push_back(c.data());
+        }
+
+        std::vector<float> interleaved(n * channels);
+        interleave(interleaved.data(), in.data(), channels, n);
+        for (std::size_t k = 0; k < n; k++)
+          for (std::size_t c = 0; c < channels; c++)
+            REQUIRE(interleaved[k * channels + c] == chans[c][k]);
+
+        std::vector<std::vector<float>> back(channels, std::vector<float>(n));
+        std::vector<float*> out;
+        for (auto& c : back)
+          out.push_back(c.data());
+        deinterleave(out.data(), interleaved.data(), channels, n);
+        REQUIRE(back == chans);
+      }
+    }
+  }
+
+  set_isa(best);
+}
@@ -0,0 +1,72 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/dataflow/control_rate.hpp>
+
+#include <vector>
+
+TEST_CASE ("test_control_blocks", "test_control_blocks")
+{
+  using namespace ossia;
+
+  token_request t;
+  t.prev_date = 0_tv;
+  t.date = 512_tv;
+  t.parent_duration = 1024_tv;
+
+  std::vector<std::pair<int64_t, double>> blocks;
+  auto f = [&](int64_t ts, double pos) { blocks.emplace_back(ts, pos); };
+
+  SECTION("One value per tick by default")
+  {
+    for_each_control_block(t, 10, 512, 0, f);
+    REQUIRE(blocks.size() == 1);
+    REQUIRE(blocks[0].first == 10);
+    REQUIRE(blocks[0].second == t.position());
+  }
+
+  SECTION("One value per sub-block")
+  {
+    for_each_control_block(t, 0, 512, 200, f);
+    REQUIRE(blocks.size() == 3);
+    // Each value is stamped at the end of its block, where it is computed
+    REQUIRE(blocks[0].first == 199);
+    REQUIRE(blocks[1].first == 399);
+    REQUIRE(blocks[2].first == 511);
+    REQUIRE(blocks[0].second == Approx(200. / 1024.));
+    REQUIRE(blocks[1].second == Approx(400. / 1024.));
+    REQUIRE(blocks[2].second == Approx(t.position()));
+  }
+}
+
+TEST_CASE ("test_control_buffer", "test_control_buffer")
+{
+  using namespace ossia;
+
+  value_vector<timed_value> data;
+  data.emplace_back(ossia::value{1.f}, 4);
+  data.emplace_back(ossia::value{0.f}, 6);
+
+  float buf[10]{};
+  float current = 0.f;
+  render_control_buffer(data, buf, 0, 10, current);
+
+  // Ramps up to 1 at sample 4, down to 0 at sample 6, then holds
+  REQUIRE(buf[0] == Approx(0.2f));
+  REQUIRE(buf[3] == Approx(0.8f));
+  REQUIRE(buf[4] == Approx(1.f));
+  REQUIRE(buf[5] == Approx(0.5f));
+  REQUIRE(buf[6] == Approx(0.f));
+  REQUIRE(buf[9] == Approx(0.f));
+  REQUIRE(current == 0.f);
+
+  // Without values, the last one is held.
+  // The buffer starts at the first rendered sample.
+  current = 0.5f;
+  render_control_buffer({}, buf, 2, 8, current);
+  REQUIRE(buf[0] == 0.5f);
+  REQUIRE(buf[7] == 0.5f);
+}
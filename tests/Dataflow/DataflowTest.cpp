@@ -954,3 +954,50 @@ TEST_CASE ("hierarchical_ordering", "hierarchical_ordering")
 {
 
 }
+
+TEST_CASE ("received_value_slots", "received_value_slots")
+{
+  using namespace ossia;
+  TestDevice test;
+  execution_state e;
+  e.register_device(&test.device);
+  e.begin_tick();
+
+  value_inlet a{*test.float_addr};
+  a->is_event = true;
+  value_inlet b{*test.int_addr};
+  b->is_event = true;
+  e.register_port(a);
+  e.register_port(b);
+  REQUIRE(a.received_slot >= 0);
+  REQUIRE(b.received_slot >= 0);
+  REQUIRE(a.received_slot != b.received_slot);
+
+  test.float_addr->push_value(1.f);
+  test.float_addr->push_value(2.f);
+
+  e.begin_tick();
+  e.copy_from_global(*test.float_addr, a);
+  e.copy_from_global(*test.int_addr, b);
+  REQUIRE(a->get_data().size() == 2);
+  REQUIRE(b->get_data().empty());
+
+  // Values are only kept for one tick
+  a->get_data().clear();
+  e.begin_tick();
+  e.copy_from_global(*test.float_addr, a);
+  REQUIRE(a->get_data().empty());
+
+  // The slot of an unregistered parameter is reused
+  const auto slot = a.received_slot;
+  e.unregister_port(a);
+  REQUIRE(a.received_slot == -1);
+
+  value_inlet c{*test.f1};
+  c->is_event = true;
+  e.register_port(c);
+  REQUIRE(c.received_slot == slot);
+
+  e.unregister_port(b);
+  e.unregister_port(c);
+}
@@ -0,0 +1,64 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/dataflow/midi_port.hpp>
+
+#include <type_traits>
+
+using namespace ossia;
+
+static_assert(std::is_trivially_copyable_v<midi_message>);
+
+TEST_CASE("test_midi_message_factories", "test_midi_message_factories")
+{
+  using type = midi_message::message_type;
+  midi_port p;
+  p.note_on(1, 60, 127);
+  p.note_off(16, 60, 0);
+  p.control_change(3, 7, 100);
+  p.program_change(4, 12);
+  p.pitch_bend(5, 8192);
+  p.poly_pressure(6, 61, 20);
+  p.aftertouch(7, 30);
+
+  REQUIRE(p.messages.size() == 7);
+
+  REQUIRE((p.messages[0] == midi_message{0x90, 60, 127}));
+  REQUIRE(p.messages[0].get_message_type() == type::NOTE_ON);
+  REQUIRE(p.messages[0].get_channel() == 1);
+
+  REQUIRE((p.messages[1] == midi_message{0x8F, 60, 0}));
+  REQUIRE(p.messages[1].get_message_type() == type::NOTE_OFF);
+  REQUIRE(p.messages[1].get_channel() == 16);
+
+  REQUIRE((p.messages[2] == midi_message{0xB2, 7, 100}));
+  REQUIRE((p.messages[3] == midi_message{0xC3, 12}));
+  REQUIRE(p.messages[3].size() == 2);
+  REQUIRE((p.messages[4] == midi_message{0xE4, 0x00, 0x40}));
+  REQUIRE((p.messages[5] == midi_message{0xA5, 61, 20}));
+  REQUIRE((p.messages[6] == midi_message{0xD6, 30}));
+
+  // Channels out of range are clamped
+  REQUIRE(midi_message::note_on(0, 1, 1)[0] == 0x90);
+  REQUIRE(midi_message::note_on(42, 1, 1)[0] == 0x9F);
+}
+
+TEST_CASE("test_midi_message_assign", "test_midi_message_assign")
+{
+  midi_message m;
+  REQUIRE(m.empty());
+  REQUIRE(m.get_channel() == 0);
+
+  const uint8_t clock[] = {0xF8};
+  REQUIRE(m.assign(clock, 1));
+  REQUIRE(m.size() == 1);
+  REQUIRE(m.get_message_type() == midi_message::message_type(0xF8));
+
+  // System exclusive messages do not fit
+  const uint8_t sysex[] = {0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7};
+  REQUIRE(!m.assign(sysex, sizeof(sysex)));
+  REQUIRE((m == midi_message{0xF8}));
+}
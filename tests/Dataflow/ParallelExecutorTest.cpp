@@ -0,0 +1,161 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/dataflow/graph/graph_parallel_impl.hpp>
+#include <ossia/detail/algorithms.hpp>
+#include <ossia/detail/hash_map.hpp>
+#include <ossia/detail/work_stealing_deque.hpp>
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+TEST_CASE ("test_work_stealing_deque", "test_work_stealing_deque")
+{
+  int values[100];
+  ossia::work_stealing_deque<int*> deque{4};
+  REQUIRE(deque.capacity() == 4);
+  REQUIRE(deque.pop() == nullptr);
+  REQUIRE(deque.steal() == nullptr);
+
+  deque.reserve(100);
+  REQUIRE(deque.capacity() == 128);
+
+  for (auto& v : values)
+    deque.push(&v);
+
+  // The owner pops the most recent, thieves steal the oldest
+  REQUIRE(deque.pop() == &values[99]);
+  REQUIRE(deque.steal() == &values[0]);
+
+  std::atomic_int stolen{0};
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; i++)
+  {
+    thieves.emplace_back([&] {
+      while (!deque.empty())
+        if (deque.steal())
+          stolen++;
+    });
+  }
+
+  int popped = 0;
+  while (deque.pop())
+    popped++;
+
+  for (auto& t : thieves)
+    t.join();
+
+  REQUIRE(popped + stolen == 98);
+}
+
+TEST_CASE ("test_parallel_executor", "test_parallel_executor")
+{
+  // Random DAG: every enabled node must run once per tick,
+  // after its enabled predecessors.
+  std::mt19937 rng(42);
+  const int N = 300;
+
+  std::vector<std::unique_ptr<ossia::graph_node>> nodes;
+  ossia::taskflow tf;
+  tf.reserve(N);
+  std::vector<ossia::task*> tasks;
+  for (int i = 0; i < N; i++)
+  {
+    auto& n = nodes.emplace_back(std::make_unique<ossia::graph_node>());
+    if (rng() % 7 != 0)
+      n->request(ossia::token_request{});
+    tasks.push_back(tf.emplace(*n));
+  }
+
+  std::vector<std::vector<int>> preds(N);
+  for (int i = 0; i < N; i++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      const int j = rng() % N;
+      if (j < i && ossia::find(preds[i], j) == preds[i].end())
+      {
+        preds[i].push_back(j);
+        tasks[j]->precede(*tasks[i]);
+      }
+    }
+  }
+
+  ossia::fast_hash_map<ossia::graph_node*, int> index;
+  for (int i = 0; i < N; i++)
+    index[nodes[i].get()] = i;
+
+  std::vector<std::atomic_int> count(N);
+  std::vector<std::atomic_int> order(N);
+  std::atomic_int clock{0};
+
+  for (int threads : {0, 1, 3})
+  {
+    ossia::executor ex;
+    ex.start(threads, false);
+    ex.set_task_executor([&] (ossia::graph_node& n) {
+      const int i = index.at(&n);
+      count[i]++;
+      order[i] = ++clock;
+    });
+
+    for (int tick = 0; tick < 200; tick++)
+    {
+      clock = 0;
+      for (auto& c : count)
+        c = 0;
+
+      ex.run(tf);
+
+      for (int i = 0; i < N; i++)
+      {
+        if (!nodes[i]->enabled())
+          continue;
+        REQUIRE(count[i] == 1);
+        for (int p : preds[i])
+          if (nodes[p]->enabled())
+            REQUIRE(order[p] < order[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE ("test_taskflow_priorities", "test_taskflow_priorities")
+{
+  // 0 -> 1 -> 2, 3 -> 2, 5 -> 4
+  std::vector<std::unique_ptr<ossia::graph_node>> nodes;
+  ossia::taskflow tf;
+  tf.reserve(6);
+  std::vector<ossia::task*> tasks;
+  for (int i = 0; i < 6; i++)
+  {
+    auto& n = nodes.emplace_back(std::make_unique<ossia::graph_node>());
+    tasks.push_back(tf.emplace(*n));
+  }
+  tasks[0]->precede(*tasks[1]);
+  tasks[1]->precede(*tasks[2]);
+  tasks[3]->precede(*tasks[2]);
+  tasks[5]->precede(*tasks[4]);
+
+  // Without measurements, the longest chain goes first
+  tf.update_priorities();
+  REQUIRE(tasks[0]->priority() == 3);
+  REQUIRE(tasks[3]->priority() == 2);
+  REQUIRE(tasks[5]->priority() == 2);
+  REQUIRE(tasks[2]->priority() == 1);
+
+  // Measured costs are smoothed
+  tf.set_cost(*tasks[4], 1000);
+  tf.set_cost(*tasks[5], 1000);
+  tf.set_cost(*tasks[5], 2000);
+  REQUIRE(tasks[5]->cost() == 1250);
+
+  tf.update_priorities();
+  REQUIRE(tasks[4]->priority() == 1000);
+  REQUIRE(tasks[5]->priority() == 2250);
+  REQUIRE(tasks[0]->priority() == 3);
+}
@@ -4,6 +4,14 @@
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/nodes/sound_ref.hpp>
 #include <ossia/dataflow/nodes/sound_mmap.hpp>
+#include <ossia/audio/offline_protocol.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 TEST_CASE ("test_sound_ref", "test_sound_ref")
 {
@@ -35,6 +43,125 @@ TEST_CASE ("test_sound_ref", "test_sound_ref")
   REQUIRE(op == expected);
 }
 
+TEST_CASE ("test_sample_cache", "test_sample_cache")
+{
+  using namespace ossia;
+  std::atomic_int decoded{};
+
+  // Decodes "N" into N frames of 2 channels
+  sample_cache c;
+  c.set_decoder([&] (const std::string& path, int, audio_array& out) {
+    decoded++;
+    if(path == "missing")
+      return false;
+    const int n = std::stoi(path);
+    out.resize(2);
+    for(auto& chan : out)
+      for(int i = 0; i < n; i++)
+        chan.push_back(float(i) / n);
+    return true;
+  });
+
+  // Shared between the requests for the same file and rate
+  auto a = c.load("100", 44100);
+  REQUIRE(a);
+  REQUIRE(a->channels() == 2);
+  REQUIRE(a->frames() == 100);
+  REQUIRE(a->rate() == 44100);
+  REQUIRE(c.load("100", 44100) == a);
+  REQUIRE(c.find("100", 44100) == a);
+  REQUIRE(decoded == 1);
+
+  auto b = c.load("100", 48000);
+  REQUIRE(b != a);
+  REQUIRE(decoded == 2);
+  REQUIRE(c.memory() == 2 * 2 * 100 * sizeof(float));
+
+  // Failures are not cached
+  REQUIRE(!c.load("missing", 44100));
+  REQUIRE(!c.load("missing", 44100));
+  REQUIRE(decoded == 4);
+  REQUIRE(c.size() == 2);
+
+  // Eviction of the sounds that are not in use anymore
+  REQUIRE(c.load("200", 44100));
+  REQUIRE(decoded == 5);
+  c.set_budget(2 * 100 * sizeof(float));
+  REQUIRE(!c.find("200", 44100));
+  REQUIRE(c.find("100", 44100) == a);
+  REQUIRE(c.memory() == 2 * 2 * 100 * sizeof(float));
+
+  b.reset();
+  auto d = c.load("50", 44100);
+  REQUIRE(!c.find("100", 48000));
+  REQUIRE(c.find("100", 44100) == a);
+  REQUIRE(c.find("50", 44100) == d);
+
+  // Asynchronous decoding
+  c.set_budget(-1);
+  auto f0 = c.load_async("300", 44100);
+  auto f1 = c.load_async("300", 44100);
+  REQUIRE(f0.get());
+  REQUIRE(f0.get()->frames() == 300);
+  REQUIRE(f0.get() == f1.get());
+  REQUIRE(decoded == 7);
+
+  c.clear();
+  REQUIRE(c.memory() == 0);
+  REQUIRE(!c.find("100", 44100));
+  REQUIRE(a->frames() == 100);
+}
+
+TEST_CASE ("test_sample_cache_int16", "test_sample_cache_int16")
+{
+  using namespace ossia;
+  sample_cache c;
+  c.set_format(sample_format::int16);
+  c.set_decoder([&] (const std::string&, int, audio_array& out) {
+    out = audio_array{ {0.1, 0.2, 0.3, 0.4} };
+    return true;
+  });
+
+  auto smp = c.load("snd", 44100);
+  REQUIRE(smp->format() == sample_format::int16);
+  REQUIRE(smp->bytes() == 4 * sizeof(int16_t));
+
+  float buf[6];
+  smp->read(0, -1, 6, buf);
+  REQUIRE(buf[0] == 0.f);
+  REQUIRE(std::abs(buf[1] - 0.1f) < 0.0001f);
+  REQUIRE(std::abs(buf[4] - 0.4f) < 0.0001f);
+  REQUIRE(buf[5] == 0.f);
+
+  nodes::sound_ref snd;
+  snd.set_sound(smp);
+  REQUIRE(snd.channels() == 1);
+  REQUIRE(snd.duration() == 4);
+
+  execution_state e;
+  e.bufferSize = 9;
+
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 0_tv, .offset = 0_tv});
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 4_tv, .offset = 0_tv});
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 0_tv, .offset = 4_tv});
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 4_tv, .offset = 4_tv});
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 0_tv, .offset = 8_tv});
+  snd.requested_tokens.push_back(simple_token_request{.prev_date = 0_tv, .date = 1_tv, .offset = 8_tv});
+
+  for(auto tk : snd.requested_tokens)
+  {
+    snd.run(tk, {&e});
+  }
+
+  auto op = snd.root_outputs()[0]->target<audio_port>()->samples;
+  audio_channel expected{0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.2f, 0.3f, 0.4f, 0.1f};
+  REQUIRE(op[0].size() == 9);
+  for(int i = 0; i < 9; i++)
+  {
+    REQUIRE(std::abs(expected[i] - op[0][i]) < 0.0001);
+  }
+}
+
 #if defined(__GNUC__) || defined (__clang__)
 // http://www-mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
 // https://gist.github.com/Jon-Schneider/8b7c53d27a7a13346a643dac9c19d34f
@@ -87,6 +214,9 @@ TEST_CASE ("test_sound_mmap", "test_sound_mmap")
   REQUIRE(v[3] == 0.4f);
 
   snd.set_sound(h);
+  for(int i = 0; i < 2000 && !snd.ready(); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  REQUIRE(snd.ready());
 
   execution_state e;
   e.bufferSize = 9;
@@ -113,3 +243,238 @@ TEST_CASE ("test_sound_mmap", "test_sound_mmap")
   REQUIRE(op == expected);
 }
 #endif
+
+// Mono float wave where each sample is its own index
+static std::vector<char> make_index_wave(int32_t frames)
+{
+  const int32_t data_bytes = frames * 4;
+  std::vector<char> w(44 + data_bytes);
+  auto put = [&](int pos, auto v) { std::memcpy(w.data() + pos, &v, sizeof(v)); };
+  std::memcpy(w.data(), "RIFF", 4);
+  put(4, int32_t(36 + data_bytes));
+  std::memcpy(w.data() + 8, "WAVEfmt ", 8);
+  put(16, int32_t(16));
+  put(20, int16_t(3));
+  put(22, int16_t(1));
+  put(24, int32_t(44100));
+  put(28, int32_t(44100 * 4));
+  put(32, int16_t(4));
+  put(34, int16_t(32));
+  std::memcpy(w.data() + 36, "data", 4);
+  put(40, data_bytes);
+  for (int32_t i = 0; i < frames; i++)
+    put(44 + i * 4, float(i));
+  return w;
+}
+
+TEST_CASE ("test_sound_stream", "test_sound_stream")
+{
+  using namespace ossia;
+  using namespace std::chrono_literals;
+
+  const auto w = make_index_wave(100000);
+  drwav_handle h{w.data(), w.size()};
+  REQUIRE(h.totalPCMFrameCount() == 100000);
+
+  sound_stream s;
+  s.open(h, {}, 4096);
+  REQUIRE(!s.resident());
+  REQUIRE(s.channels() == 1);
+
+  float buf[512]{};
+  float* out[1]{buf};
+
+  auto wait_read = [&] (int64_t frame, const sound_stream_loop& loop) {
+    for(int i = 0; i < 2000; i++)
+    {
+      if(s.read(frame, 512, out, loop) == 512)
+        return true;
+      std::this_thread::sleep_for(1ms);
+    }
+    return false;
+  };
+
+  // The beginning is decoded when opening
+  REQUIRE(s.read(0, 512, out, {}) == 512);
+  REQUIRE(buf[0] == 0.f);
+  REQUIRE(buf[511] == 511.f);
+
+  // Reading far ahead starts decoding from there
+  REQUIRE(s.read(80000, 512, out, {}) == 0);
+  REQUIRE(buf[0] == 0.f);
+  REQUIRE(s.underruns() == 1);
+  REQUIRE(wait_read(80000, {}));
+  for(int i = 0; i < 512; i++)
+    REQUIRE(buf[i] == float(80000 + i));
+
+  // Playback continues from the buffer
+  REQUIRE(wait_read(80512, {}));
+  REQUIRE(buf[0] == 80512.f);
+
+  // Seeking ahead of time
+  s.seek(20000, {});
+  REQUIRE(wait_read(20000, {}));
+  REQUIRE(buf[0] == 20000.f);
+
+  // Loops
+  const sound_stream_loop loop{10, 100, true};
+  REQUIRE(wait_read(0, loop));
+  for(int i = 0; i < 512; i++)
+    REQUIRE(buf[i] == float(10 + i % 100));
+}
+
+TEST_CASE ("test_sound_stream_open_loop", "test_sound_stream_open_loop")
+{
+  using namespace ossia;
+  using namespace std::chrono_literals;
+  const auto w = make_index_wave(100000);
+
+  float buf[512]{};
+  float* out[1]{buf};
+
+  // The window decoded when opening follows the loop
+  {
+    const sound_stream_loop loop{10, 100, true};
+    sound_stream s;
+    s.open(drwav_handle{w.data(), w.size()}, loop, 4096);
+    REQUIRE(!s.resident());
+    REQUIRE(s.read(0, 512, out, loop) == 512);
+    for(int i = 0; i < 512; i++)
+      REQUIRE(buf[i] == float(10 + i % 100));
+    REQUIRE(s.underruns() == 0);
+  }
+
+  // Also when opened in the streaming thread; the loop duration
+  // does not matter if the sound does not loop
+  {
+    sound_stream s;
+    s.open_async(drwav_handle{w.data(), w.size()}, {300, 0, false}, 4096);
+    for(int i = 0; i < 2000 && !s.update(); i++)
+      std::this_thread::sleep_for(1ms);
+    REQUIRE(s.update());
+    REQUIRE(s.read(0, 512, out, {300, 5000, false}) == 512);
+    REQUIRE(buf[0] == 300.f);
+    REQUIRE(buf[511] == 811.f);
+    REQUIRE(s.underruns() == 0);
+  }
+}
+
+TEST_CASE ("test_sound_stream_resident", "test_sound_stream_resident")
+{
+  using namespace ossia;
+  const auto w = make_index_wave(1000);
+  drwav_handle h{w.data(), w.size()};
+
+  sound_stream s;
+  s.open(h);
+  REQUIRE(s.resident());
+
+  float buf[16]{};
+  float* out[1]{buf};
+  REQUIRE(s.read(995, 16, out, {}) == 16);
+  REQUIRE(buf[4] == 999.f);
+  REQUIRE(buf[5] == 0.f);
+
+  REQUIRE(s.read(0, 16, out, {0, 10, true}) == 16);
+  REQUIRE(buf[12] == 2.f);
+  REQUIRE(s.underruns() == 0);
+}
+
+TEST_CASE ("test_sound_stream_async", "test_sound_stream_async")
+{
+  using namespace ossia;
+  using namespace std::chrono_literals;
+  const auto w = make_index_wave(1000);
+
+  sound_stream s;
+  s.open_async(drwav_handle{w.data(), w.size()});
+  auto wait_ready = [&] {
+    for(int i = 0; i < 2000 && !s.update(); i++)
+      std::this_thread::sleep_for(1ms);
+    return s.update();
+  };
+  REQUIRE(wait_ready());
+  REQUIRE(s.resident());
+
+  float buf[16]{};
+  float* out[1]{buf};
+  REQUIRE(s.read(10, 16, out, {}) == 16);
+  REQUIRE(buf[0] == 10.f);
+
+  // Reopened with a smaller window: streamed instead of resident
+  s.reopen({}, 256);
+  REQUIRE(wait_ready());
+  for(int i = 0; i < 2000 && s.resident(); i++)
+  {
+    std::this_thread::sleep_for(1ms);
+    s.update();
+  }
+  REQUIRE(!s.resident());
+  REQUIRE(s.read(0, 16, out, {}) == 16);
+  REQUIRE(buf[15] == 15.f);
+
+  // A request which completes after close() is dropped
+  s.open_async(drwav_handle{w.data(), w.size()});
+  s.close();
+  std::this_thread::sleep_for(20ms);
+  REQUIRE(!s.update());
+}
+
+TEST_CASE ("test_offline_engine", "test_offline_engine")
+{
+  using namespace ossia;
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto in_path = (dir / "ossia_offline_in.wav").string();
+  const auto out_path = (dir / "ossia_offline_out.wav").string();
+
+  {
+    const auto w = make_index_wave(1000);
+    std::ofstream f{in_path, std::ios::binary};
+    f.write(w.data(), w.size());
+  }
+
+  {
+    offline_engine e{44100, 64, 1, 2};
+    REQUIRE(e.open_input(in_path));
+    REQUIRE(e.open_output(out_path));
+
+    int ticks = 0;
+    e.set_tick([&ticks] (const audio_tick_state& st) {
+      ticks++;
+      for(std::size_t i = 0; i < st.frames; i++)
+      {
+        st.outputs[0][i] = st.inputs[0][i];
+        st.outputs[1][i] = *st.position_in_frames + i;
+      }
+    });
+
+    // Stops in the middle of a buffer
+    auto stats = e.render(1000);
+    REQUIRE(stats.frames == 1000);
+    REQUIRE(stats.rendered_seconds == 1000. / 44100.);
+    REQUIRE(stats.realtime_factor() > 0.);
+    REQUIRE(ticks == 16);
+
+    // Past the end of the input
+    stats = e.render(200);
+    REQUIRE(stats.frames == 200);
+    REQUIRE(e.position() == 1200);
+  }
+
+  std::ifstream f{out_path, std::ios::binary};
+  const std::vector<char> out{std::istreambuf_iterator<char>{f}, {}};
+  drwav_handle h{out.data(), out.size()};
+  REQUIRE(h.channels() == 2);
+  REQUIRE(h.totalPCMFrameCount() == 1200);
+
+  std::vector<float> frames(1200 * 2);
+  REQUIRE(h.read_pcm_frames_f32(1200, frames.data()) == 1200);
+  for(int i = 0; i < 1200; i++)
+  {
+    REQUIRE(frames[i * 2] == (i < 1000 ? float(i) : 0.f));
+    REQUIRE(frames[i * 2 + 1] == float(i));
+  }
+
+  std::filesystem::remove(in_path);
+  std::filesystem::remove(out_path);
+}
@@ -10,6 +10,7 @@
 
 #include <catch2/catch_approx.hpp>
 
+#include <cmath>
 #include <iostream>
 
 using namespace ossia;
@@ -135,3 +136,59 @@ TEST_CASE ("test_destination", "test_destination")
   REQUIRE(c->value_at(0.5) == 0.5);
   REQUIRE(c->value_at(1.) == 1.);
 }
+
+TEST_CASE ("test_destination_mid_curve", "test_destination_mid_curve")
+{
+  ossia::net::generic_device device{"test"};
+  auto param = device.create_child("my_float")->create_parameter(val_type::FLOAT);
+  param->set_value(0.5f);
+
+  curve<double, float> c;
+  curve_segment_linear<float> linearSegment;
+  c.set_x0(0.);
+  c.set_y0_destination(destination{*param});
+  c.add_point(linearSegment, 1., 1.);
+  c.add_point(linearSegment, 2., 0.);
+
+  // Starting in the second segment still captures y0 at that point
+  REQUIRE(c.value_at(1.5) == Catch::Approx(0.5));
+  param->set_value(0.f);
+  REQUIRE(c.value_at(0.5) == Catch::Approx(0.75));
+
+  // Until the curve is reset
+  c.reset();
+  REQUIRE(c.value_at(0.5) == Catch::Approx(0.5));
+}
+
+TEST_CASE ("test_many_points", "test_many_points")
+{
+  // Sawtooth: 0 at even abscissas, 1 at odd ones
+  curve<double, float> c;
+  curve_segment_linear<float> linearSegment;
+  c.set_x0(0.);
+  c.set_y0(0.);
+  for (int i = 1; i <= 1000; i++)
+    c.add_point(linearSegment, i, i % 2);
+
+  // Forward, backward and random jumps give the same values
+  for (double x : {0.25, 0.5, 1., 1.5, 999.5, 998.25, 3.5, 3.75, 1200., -1.})
+  {
+    const double frac = x - std::floor(x);
+    float expected = int(std::floor(x)) % 2 == 0 ? frac : 1. - frac;
+    if (x <= 0.)
+      expected = 0.;
+    else if (x >= 1000.)
+      expected = 0.;
+    REQUIRE(c.value_at(x) == Catch::Approx(expected));
+  }
+
+  std::vector<double> xs;
+  for (int i = 0; i < 4000; i++)
+    xs.push_back(i * 0.25);
+  xs.push_back(2.5);
+
+  std::vector<float> ys(xs.size());
+  c.values_at(xs, ys);
+  for (std::size_t i = 0; i < xs.size(); i++)
+    REQUIRE(ys[i] == c.value_at(xs[i]));
+}
@@ -682,6 +682,151 @@ TEST_CASE ("test_trigger_at_start", "test_trigger_at_start")
   REQUIRE(scenario.get_start_time_sync()->is_evaluating());
 }
 
+TEST_CASE ("test_trigger_observed_expression", "test_trigger_observed_expression")
+{
+  using namespace ossia;
+  ossia::net::generic_device device{"test"};
+  auto param = device.create_child("int")->create_parameter(val_type::INT);
+  param->push_value(0);
+
+  root_scenario s;
+
+  ossia::scenario& scenario = *s.scenario;
+  std::shared_ptr<time_event> e0 = start_event(scenario);
+  std::shared_ptr<time_event> e1 = create_event(scenario);
+  std::shared_ptr<time_event> e2 = create_event(scenario);
+  auto& sync = e1->get_time_sync();
+  sync.set_expression(ossia::expressions::make_expression_atom(
+      ossia::destination(*param), ossia::expressions::comparator::EQUAL, 1));
+
+  std::shared_ptr<time_interval> c0 = time_interval::create({}, *e0, *e1, 30_tv, 20_tv, ossia::Infinite);
+  std::shared_ptr<time_interval> c1 = time_interval::create({}, *e1, *e2, 100000_tv, 100000_tv, 100000_tv);
+
+  scenario.add_time_interval(c0);
+  scenario.add_time_interval(c1);
+
+  s.interval->start_and_tick();
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(!sync.is_waiting_for_expression());
+
+  // Past the min: the expression is evaluated once, then observed
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(c0->get_date() == 30_tv);
+  REQUIRE(e1->get_status() == ossia::time_event::status::PENDING);
+  REQUIRE(sync.is_waiting_for_expression());
+
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(c0->get_date() == 45_tv);
+  REQUIRE(e1->get_status() == ossia::time_event::status::PENDING);
+
+  // The change of the parameter wakes the sync up
+  param->push_value(1);
+  REQUIRE(!sync.is_waiting_for_expression());
+
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(c0->get_date() == 0_tv);
+  REQUIRE(e1->get_status() == ossia::time_event::status::FINISHED);
+  REQUIRE(!sync.is_observing_expression());
+}
+
+namespace
+{
+struct polled_expression final : ossia::expressions::expression_generic_base
+{
+  polled_expression(int& evals, bool& result) : evals{evals}, result{result} { }
+  void update() override { }
+  bool evaluate() const override
+  {
+    ++evals;
+    return result;
+  }
+  void on_first_callback_added(ossia::expressions::expression_generic&) override { }
+  void on_removing_last_callback(ossia::expressions::expression_generic&) override { }
+
+  int& evals;
+  bool& result;
+};
+}
+
+TEST_CASE ("test_trigger_polled_expression", "test_trigger_polled_expression")
+{
+  using namespace ossia;
+  int evals = 0;
+  bool result = false;
+
+  root_scenario s;
+
+  ossia::scenario& scenario = *s.scenario;
+  std::shared_ptr<time_event> e0 = start_event(scenario);
+  std::shared_ptr<time_event> e1 = create_event(scenario);
+  std::shared_ptr<time_event> e2 = create_event(scenario);
+  auto& sync = e1->get_time_sync();
+  sync.set_expression(
+      ossia::expressions::make_expression_generic<polled_expression>(evals, result));
+
+  std::shared_ptr<time_interval> c0 = time_interval::create({}, *e0, *e1, 30_tv, 20_tv, ossia::Infinite);
+  std::shared_ptr<time_interval> c1 = time_interval::create({}, *e1, *e2, 100000_tv, 100000_tv, 100000_tv);
+
+  scenario.add_time_interval(c0);
+  scenario.add_time_interval(c1);
+
+  s.interval->start_and_tick();
+  s.interval->tick(30_tv, default_request());
+  REQUIRE(evals == 1);
+
+  // Generic expressions may not notify their changes: they are evaluated at each tick
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(evals == 2);
+  REQUIRE(!sync.is_waiting_for_expression());
+
+  result = true;
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(evals == 3);
+  REQUIRE(e1->get_status() == ossia::time_event::status::FINISHED);
+}
+
+TEST_CASE ("test_trigger_root_expression", "test_trigger_root_expression")
+{
+  using namespace ossia;
+  ossia::net::generic_device device{"test"};
+  auto param = device.create_child("int")->create_parameter(val_type::INT);
+  param->push_value(0);
+
+  root_scenario s;
+
+  ossia::scenario& scenario = *s.scenario;
+  std::shared_ptr<time_event> e0 = create_event(scenario);
+  std::shared_ptr<time_event> e1 = create_event(scenario);
+  auto& root = e0->get_time_sync();
+  root.set_start(true);
+  root.set_expression(ossia::expressions::make_expression_atom(
+      ossia::destination(*param), ossia::expressions::comparator::EQUAL, 1));
+
+  std::shared_ptr<time_interval> c0 = time_interval::create({}, *e0, *e1, 100000_tv, 100000_tv, 100000_tv);
+  scenario.add_time_interval(c0);
+
+  // Evaluated once at start, then left aside until the expression changes
+  s.interval->start_and_tick();
+  REQUIRE(root.is_waiting_for_expression());
+
+  s.interval->tick(15_tv, default_request());
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(root.is_waiting_for_expression());
+  REQUIRE(e0->get_status() == ossia::time_event::status::PENDING);
+  REQUIRE(c0->get_date() == 0_tv);
+
+  param->push_value(1);
+  REQUIRE(!root.is_waiting_for_expression());
+
+  s.interval->tick(15_tv, default_request());
+  REQUIRE(e0->get_status() == ossia::time_event::status::FINISHED);
+  REQUIRE(c0->get_date() > 0_tv);
+
+  // Idle again: it listens for the next trigger
+  REQUIRE(!root.is_evaluating());
+  REQUIRE(root.is_observing_expression());
+}
+
 TEST_CASE ("test_speed", "test_speed")
 {
 
@@ -0,0 +1,70 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/common/address_index.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+
+using namespace ossia;
+using namespace ossia::net;
+
+TEST_CASE ("test_address_index_exact", "test_address_index_exact")
+{
+  generic_device dev{"test"};
+  auto& gain = create_node(dev, "/mixer/1/gain");
+  auto& index = dev.get_address_index();
+
+  REQUIRE(index.find_node("/mixer/1/gain") == &gain);
+  REQUIRE(index.find_node("mixer/1/gain") == &gain);
+  REQUIRE(index.find_node("/mixer/2/gain") == nullptr);
+
+  // Created after the index was built
+  auto& gain2 = create_node(dev, "/mixer/2/gain");
+  REQUIRE(index.find_node("/mixer/2/gain") == &gain2);
+
+  // Removed
+  gain2.get_parent()->remove_child(gain2);
+  REQUIRE(index.find_node("/mixer/2/gain") == nullptr);
+
+  // Renamed
+  find_node(dev, "/mixer")->set_name("desk");
+  REQUIRE(index.find_node("/mixer/1/gain") == nullptr);
+  REQUIRE(index.find_node("/desk/1/gain") == &gain);
+
+  auto st = index.stats();
+  REQUIRE(st.hits == 3);
+  REQUIRE(st.misses == 4);
+}
+
+TEST_CASE ("test_address_index_pattern", "test_address_index_pattern")
+{
+  generic_device dev{"test"};
+  for(int i = 0; i < 8; i++)
+    create_node(dev, "/mixer/" + std::to_string(i) + "/gain");
+
+  auto& index = dev.get_address_index();
+  address_index::node_list nodes;
+
+  REQUIRE(index.find_nodes("/mixer/*/gain", nodes));
+  REQUIRE(nodes.size() == 8);
+  REQUIRE(index.stats().pattern_misses == 1);
+
+  REQUIRE(index.find_nodes("/mixer/*/gain", nodes));
+  REQUIRE(nodes.size() == 8);
+  REQUIRE(index.stats().pattern_hits == 1);
+
+  // The cached result is refreshed when the tree changes
+  create_node(dev, "/mixer/8/gain");
+  REQUIRE(index.find_nodes("/mixer/*/gain", nodes));
+  REQUIRE(nodes.size() == 9);
+  REQUIRE(index.stats().pattern_misses == 2);
+
+  REQUIRE(index.find_nodes("/mixer/{1,2}/gain", nodes));
+  REQUIRE(nodes.size() == 2);
+
+  REQUIRE(index.find_nodes("/nothing/*", nodes));
+  REQUIRE(nodes.empty());
+}
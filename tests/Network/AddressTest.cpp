@@ -9,6 +9,7 @@
 #include <ossia/network/dataspace/detail/dataspace_parse.hpp>
 #include <ossia/network/common/complex_type.hpp>
 #include <ossia/network/domain/domain.hpp>
+#include <ossia/network/value/value_slot.hpp>
 
 #include <iostream>
 #include <ossia/detail/for_each.hpp>
@@ -54,6 +55,41 @@ TEST_CASE( "Nodes", "[Nodes]" )
   REQUIRE(node->get_repetition_filter() == repetition_filter::ON);
 }
 
+TEST_CASE( "Previous value", "[Previous value]" )
+{
+  ossia::net::generic_device device{"test"};
+  auto node = device.create_child("child")->create_parameter(val_type::STRING);
+  node->set_repetition_filter(repetition_filter::ON);
+
+  node->set_value(std::string("foo"));
+  node->set_value_type(val_type::INT);
+  REQUIRE(node->value() == ossia::value{0});
+  REQUIRE(node->filter_value(std::string("foo")));
+  REQUIRE(!node->filter_value(0));
+
+  node->set_value(2);
+  REQUIRE(node->filter_value(0));
+}
+
+TEST_CASE( "Value slot", "[Value slot]" )
+{
+  ossia::value_slot slot;
+  slot.store(1.f);
+  REQUIRE(!slot.store_same_type(2));
+  REQUIRE(slot.type() == int(val_type::FLOAT));
+
+  REQUIRE(slot.store_same_type(3.f));
+  ossia::value v;
+  REQUIRE(slot.load(v));
+  REQUIRE(v == ossia::value{3.f});
+  REQUIRE(slot.load_previous(v));
+  REQUIRE(v == ossia::value{1.f});
+
+  slot.store_none();
+  REQUIRE(!slot.store_same_type(4.f));
+  REQUIRE(!slot.load(v));
+}
+
 // TODO add some checks
 TEST_CASE( "Units", "[Units]" )
 {
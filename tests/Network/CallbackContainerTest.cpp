@@ -0,0 +1,150 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/detail/callback_container.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ossia;
+
+namespace
+{
+struct counting_container : callback_container<std::function<void(int)>>
+{
+  int first_added{};
+  int last_removed{};
+
+  void on_first_callback_added() override
+  {
+    first_added++;
+  }
+  void on_removing_last_callback() override
+  {
+    last_removed++;
+  }
+};
+}
+
+TEST_CASE ("test_callback_container", "test_callback_container")
+{
+  counting_container c;
+  REQUIRE(c.callbacks_empty());
+
+  std::vector<int> calls;
+  auto a = c.add_callback([&] (int v) { calls.push_back(v); });
+  auto b = c.add_callback([&] (int v) { calls.push_back(10 * v); });
+  REQUIRE(c.first_added == 1);
+  REQUIRE(c.callback_count() == 2);
+
+  // Most recent callbacks are called first
+  c.send(1);
+  REQUIRE(calls == std::vector<int>{10, 1});
+
+  c.replace_callback(a, [&] (int v) { calls.push_back(100 * v); });
+  calls.clear();
+  c.send(1);
+  REQUIRE(calls == std::vector<int>{10, 100});
+
+  {
+    auto dis = c.disable_callback(b);
+    calls.clear();
+    c.send(2);
+    REQUIRE(calls == std::vector<int>{200});
+  }
+
+  calls.clear();
+  c.send(3);
+  REQUIRE(calls == std::vector<int>{30, 300});
+
+  c.remove_callback(b);
+  REQUIRE(c.last_removed == 0);
+  c.remove_callback(a);
+  REQUIRE(c.last_removed == 1);
+  REQUIRE(c.callbacks_empty());
+
+  calls.clear();
+  c.send(4);
+  REQUIRE(calls.empty());
+
+  REQUIRE_THROWS_AS(c.add_callback({}), invalid_callback_error);
+}
+
+TEST_CASE ("test_callback_container_remove_from_callback", "test_callback_container_remove_from_callback")
+{
+  callback_container<std::function<void()>> c;
+  int count = 0;
+  callback_container<std::function<void()>>::iterator it;
+  it = c.add_callback([&] { count++; c.remove_callback(it); });
+
+  c.send();
+  c.send();
+  REQUIRE(count == 1);
+  REQUIRE(c.callbacks_empty());
+}
+
+TEST_CASE ("test_callback_container_concurrent", "test_callback_container_concurrent")
+{
+  callback_container<std::function<void(int)>> c;
+  std::atomic_bool stop{false};
+  std::atomic_int sum{0};
+
+  c.add_callback([&] (int v) { sum += v; });
+
+  std::vector<std::thread> senders;
+  for (int i = 0; i < 4; i++)
+  {
+    senders.emplace_back([&] {
+      while (!stop)
+        c.send(1);
+    });
+  }
+
+  for (int i = 0; i < 2000; i++)
+  {
+    // Once removed, the callback must not be running anymore:
+    // the captured state can be destroyed.
+    auto state = std::make_unique<std::atomic_int>(0);
+    auto it = c.add_callback([p = state.get()] (int v) { *p += v; });
+    c.remove_callback(it);
+    state.reset();
+  }
+
+  stop = true;
+  for (auto& t : senders)
+    t.join();
+
+  REQUIRE(sum > 0);
+  REQUIRE(c.callback_count() == 1);
+}
+
+TEST_CASE ("test_callback_container_independent_removal", "test_callback_container_independent_removal")
+{
+  // A callback blocked in one container must not delay removals in another
+  callback_container<std::function<void()>> blocked, other;
+  std::mutex m;
+  std::atomic_bool entered{false};
+  blocked.add_callback([&] {
+    entered = true;
+    std::lock_guard<std::mutex> lck{m};
+  });
+
+  std::unique_lock<std::mutex> lck{m};
+  std::thread sender{[&] { blocked.send(); }};
+  while (!entered)
+    std::this_thread::yield();
+
+  auto it = other.add_callback([] { });
+  other.remove_callback(it);
+  REQUIRE(other.callbacks_empty());
+
+  lck.unlock();
+  sender.join();
+}
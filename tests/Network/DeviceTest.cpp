@@ -7,6 +7,9 @@
 #include <ossia/context.hpp>
 #include <iostream>
 #include <ossia/network/local/local.hpp>
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/domain/domain.hpp>
 
 #if defined(OSSIA_PROTOCOL_OSC)
 #include <ossia/network/osc/osc.hpp>
@@ -41,3 +44,33 @@ TEST_CASE ("test_basic", "test_basic")
 #endif
     }
   }
+
+TEST_CASE ("test_local_copy", "test_local_copy")
+{
+  ossia::net::generic_device src{"remote"};
+  auto& a = ossia::net::create_node(src, "/foo/float");
+  auto pa = a.create_parameter(ossia::val_type::FLOAT);
+  pa->push_value(0.5f);
+  pa->set_domain(ossia::make_domain(0.f, 1.f));
+  pa->set_bounding(ossia::bounding_mode::CLIP);
+  ossia::net::set_description(a, "a float");
+  ossia::net::create_node(src, "/bar");
+
+  auto copy = ossia::net::make_local_copy(src);
+  REQUIRE(copy->get_name() == "remote");
+  REQUIRE(dynamic_cast<ossia::net::multiplex_protocol*>(&copy->get_protocol()));
+
+  auto ca = ossia::net::find_node(*copy, "/foo/float");
+  REQUIRE(ca);
+  REQUIRE(ca->get_parameter());
+  REQUIRE(ca->get_parameter() != pa);
+  REQUIRE(ca->get_parameter()->value() == ossia::value{0.5f});
+  REQUIRE(ca->get_parameter()->get_domain() == pa->get_domain());
+  REQUIRE(ca->get_parameter()->get_bounding() == ossia::bounding_mode::CLIP);
+  REQUIRE(ossia::net::get_description(*ca) == std::string("a float"));
+  REQUIRE(ossia::net::find_node(*copy, "/bar"));
+
+  // The copy is independent from the original
+  ca->get_parameter()->push_value(0.25f);
+  REQUIRE(pa->value() == ossia::value{0.5f});
+}
@@ -0,0 +1,164 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/sockets/size_prefix_framing.hpp>
+#include <ossia/network/sockets/slip_framing.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+using namespace ossia::net;
+using socket_t = boost::asio::local::stream_protocol::socket;
+
+namespace
+{
+struct stream_state
+{
+  bool closed{};
+  void on_close() { closed = true; }
+  void on_fail() { closed = true; }
+};
+
+struct collect
+{
+  std::vector<std::string>& messages;
+  void operator()(const char* data, std::size_t sz) const
+  {
+    messages.emplace_back(data, sz);
+  }
+};
+
+// Messages of various sizes, with the special SLIP characters in them
+std::vector<std::string> test_messages()
+{
+  std::vector<std::string> res;
+  for (int i = 0; i < 500; i++)
+  {
+    std::string msg(4 * (1 + (i * 37) % 300), 'a' + i % 26);
+    msg[i % msg.size()] = char(slip::eot);
+    msg[(i * 7) % msg.size()] = char(slip::esc);
+    res.push_back(std::move(msg));
+  }
+  // Larger than the read buffer
+  res.push_back(std::string(200000, 'x'));
+  return res;
+}
+
+// Keeps a copy of all the bytes read
+struct recording_socket
+{
+  socket_t& socket;
+  std::string& recorded;
+
+  template <typename Buffer, typename Handler>
+  void async_read_some(const Buffer& buf, Handler&& h)
+  {
+    socket.async_read_some(
+        buf, [this, buf, h = std::move(h)](
+                 boost::system::error_code ec, std::size_t n) mutable {
+          recorded.append(static_cast<const char*>(buf.data()), n);
+          h(ec, n);
+        });
+  }
+};
+
+// Sends the messages through a socket pair and returns the encoded stream
+template <typename Framing>
+std::string test_roundtrip(const std::vector<std::string>& sent)
+{
+  boost::asio::io_context ctx;
+  socket_t a{ctx}, b{ctx};
+  boost::asio::local::connect_pair(a, b);
+
+  std::string stream;
+  recording_socket rec{b, stream};
+
+  typename Framing::template encoder<socket_t> enc{a};
+  typename Framing::template decoder<recording_socket> dec{rec};
+
+  std::vector<std::string> received;
+  stream_state state;
+  dec.receive(stream_processor<stream_state, collect>{state, collect{received}});
+
+  for (const auto& msg : sent)
+    enc.write(msg.data(), msg.size());
+
+  while (received.size() < sent.size() && !state.closed)
+    ctx.run_one();
+
+  REQUIRE(received == sent);
+  return stream;
+}
+
+// Feeds a stream to a decoder in chunks of a given size
+struct chunked_stream
+{
+  const std::string& data;
+  std::size_t chunk{};
+  std::size_t pos{};
+  std::function<void(boost::system::error_code, std::size_t)> pending;
+
+  template <typename Buffer, typename Handler>
+  void async_read_some(const Buffer& buf, Handler&& h)
+  {
+    pending = [this, buf, h = std::move(h)](
+                  boost::system::error_code, std::size_t) mutable {
+      std::size_t n = std::min({chunk, buf.size(), data.size() - pos});
+      std::memcpy(buf.data(), data.data() + pos, n);
+      pos += n;
+      h(boost::system::error_code{}, n);
+    };
+  }
+
+  void run()
+  {
+    while (pending && pos < data.size())
+    {
+      auto f = std::move(pending);
+      pending = {};
+      f({}, 0);
+    }
+  }
+};
+
+template <typename Framing>
+void test_framing()
+{
+  const auto sent = test_messages();
+  const auto stream = test_roundtrip<Framing>(sent);
+
+  for (std::size_t chunk : {1, 3, 4, 5, 100, 4096, 1000000})
+  {
+    chunked_stream s{stream, chunk};
+    typename Framing::template decoder<chunked_stream> dec{s};
+
+    std::vector<std::string> received;
+    stream_state state;
+    dec.receive(stream_processor<stream_state, collect>{state, collect{received}});
+    s.run();
+
+    REQUIRE(received == sent);
+  }
+}
+}
+
+TEST_CASE("test_size_prefix_framing", "test_size_prefix_framing")
+{
+  test_framing<size_prefix_framing>();
+}
+
+TEST_CASE("test_slip_framing", "test_slip_framing")
+{
+  test_framing<slip_framing>();
+}
+#endif
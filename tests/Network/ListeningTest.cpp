@@ -0,0 +1,70 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/base/listening.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace ossia;
+
+TEST_CASE ("test_rcu_map", "test_rcu_map")
+{
+  rcu_map<string_map<int>> map;
+  map.insert({"/foo", 1});
+  map.insert({"/bar", 2});
+
+  REQUIRE(map.find(std::string_view("/foo")) == 1);
+  REQUIRE(map.find(std::string_view("/bar")) == 2);
+  REQUIRE(!map.find(std::string_view("/baz")));
+
+  map.rename("/foo", "/baz");
+  REQUIRE(!map.find(std::string_view("/foo")));
+  REQUIRE(map.find(std::string_view("/baz")) == 1);
+
+  REQUIRE(map.find_and_take(std::string_view("/baz")) == 1);
+  REQUIRE(!map.find(std::string_view("/baz")));
+
+  map.erase("/bar");
+  REQUIRE(!map.find(std::string_view("/bar")));
+}
+
+TEST_CASE ("test_rcu_map_concurrent", "test_rcu_map_concurrent")
+{
+  rcu_map<string_map<int>> map;
+  for(int i = 0; i < 100; i++)
+    map.insert({"/stable/" + std::to_string(i), i});
+
+  std::atomic_bool stop{};
+  std::atomic_int errors{};
+  std::vector<std::thread> readers;
+  for(int t = 0; t < 4; t++)
+  {
+    readers.emplace_back([&] {
+      while(!stop)
+      {
+        for(int i = 0; i < 100; i++)
+        {
+          auto res = map.find("/stable/" + std::to_string(i));
+          if(!res || *res != i)
+            errors++;
+        }
+      }
+    });
+  }
+
+  for(int k = 0; k < 2000; k++)
+  {
+    map.insert({"/toggled/" + std::to_string(k % 50), k});
+    map.erase("/toggled/" + std::to_string((k + 25) % 50));
+  }
+
+  stop = true;
+  for(auto& t : readers)
+    t.join();
+
+  REQUIRE(errors == 0);
+}
@@ -0,0 +1,104 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/dataflow/buffer_clock.hpp>
+#include <ossia/protocols/midi/detail/output_scheduler.hpp>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using clk = ossia::buffer_clock::clock;
+
+TEST_CASE("test_buffer_clock", "test_buffer_clock")
+{
+  ossia::buffer_clock c;
+  REQUIRE(!c.valid());
+
+  // 1000 samples at 1 kHz: 1 second buffers
+  const auto t0 = clk::time_point{} + 10s;
+  c.begin_buffer(0, 1000, 1000, t0);
+  REQUIRE(c.valid());
+
+  // Samples are heard one buffer later
+  REQUIRE(c.date(0) == t0 + 1s);
+  REQUIRE(c.date(500) == t0 + 1500ms);
+
+  // A late callback only moves the clock slightly
+  c.begin_buffer(1000, 1000, 1000, t0 + 1s + 160ms);
+  REQUIRE(c.date(1000) == t0 + 2s + 10ms);
+
+  // An early callback is followed right away
+  c.begin_buffer(2000, 1000, 1000, t0 + 2s);
+  REQUIRE(c.date(2000) == t0 + 3s);
+
+  // After a jump, the clock restarts from the callback
+  c.begin_buffer(0, 1000, 1000, t0 + 3s);
+  REQUIRE(c.date(0) == t0 + 4s);
+}
+
+TEST_CASE("test_output_scheduler", "test_output_scheduler")
+{
+  std::mutex mut;
+  std::vector<int> received;
+  {
+    ossia::net::midi::output_scheduler s{[&](const ossia::midi_message& m) {
+      std::lock_guard l{mut};
+      received.push_back(m[1]);
+    }};
+
+    // Scheduled out of order: they are sent by date
+    const auto start = clk::now() + 20ms;
+    for (int i = 0; i < 10; i++)
+    {
+      const int note = 9 - i;
+      REQUIRE(s.schedule(ossia::midi_message::note_on(1, note, 127), start + note * 1ms));
+    }
+
+    while (s.stats().messages < 10)
+      std::this_thread::sleep_for(1ms);
+
+    const auto st = s.stats();
+    REQUIRE(st.dropped == 0);
+    REQUIRE(st.max_lateness >= st.mean_lateness);
+  }
+
+  REQUIRE((received == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_CASE("test_output_scheduler_idle", "test_output_scheduler_idle")
+{
+  ossia::net::midi::output_scheduler s{[](const ossia::midi_message&) {}};
+
+  // Each message arrives while the output thread waits with nothing to do:
+  // it must be woken up and not wait for a timeout.
+  for (int i = 1; i <= 50; i++)
+  {
+    std::this_thread::sleep_for(2ms);
+    REQUIRE(s.schedule(ossia::midi_message::note_on(1, 60, 127), clk::now()));
+
+    const auto deadline = clk::now() + 1s;
+    while (s.stats().messages < std::size_t(i) && clk::now() < deadline)
+      std::this_thread::yield();
+    REQUIRE(s.stats().messages == std::size_t(i));
+  }
+
+  REQUIRE(s.stats().mean_lateness < 1ms);
+}
+
+TEST_CASE("test_output_scheduler_flush", "test_output_scheduler_flush")
+{
+  std::vector<int> received;
+  {
+    ossia::net::midi::output_scheduler s{
+        [&](const ossia::midi_message& m) { received.push_back(m[1]); }};
+    s.schedule(ossia::midi_message::note_off(1, 60, 0), clk::now() + 1h);
+  }
+
+  // Pending messages are sent when the scheduler stops
+  REQUIRE((received == std::vector<int>{60}));
+}
@@ -8,6 +8,7 @@
 
 #if defined(OSSIA_PROTOCOL_MIDI)
 #include <ossia/protocols/midi/midi.hpp>
+#include <ossia/protocols/midi/detail/midi_impl.hpp>
 #endif
 
 #ifdef OSSIA_PROTOCOL_MIDI
@@ -28,4 +29,46 @@ TEST_CASE ("test_midi", "test_midi")
     {
     }
   }
+
+TEST_CASE ("test_midi_lazy_tree", "test_midi_lazy_tree")
+  {
+    using namespace ossia::net::midi;
+    // No port is opened: the tree does not depend on the available devices
+    auto ctx = ossia::net::create_network_context();
+    midi_device dev(std::make_unique<midi_protocol>(ctx, libremidi::API::DUMMY));
+    dev.set_name("dada");
+    REQUIRE(dev.create_lazy_tree());
+
+    REQUIRE(dev.children().size() == 16);
+    auto on = static_cast<midi_node*>(ossia::net::find_node(dev, "/1/on"));
+    REQUIRE(on);
+    REQUIRE(on->children().size() == 0);
+    REQUIRE(on->virtual_children_names().size() == 128);
+
+    // Notes are created when they are first looked up
+    REQUIRE(!on->find_existing_child("64"));
+    auto note = ossia::net::find_node(dev, "/1/on/64");
+    REQUIRE(note);
+    REQUIRE(note->get_parameter());
+    REQUIRE(on->children().size() == 1);
+    REQUIRE(on->find_child("64") == note);
+    REQUIRE(ossia::net::find_or_create_node(dev, "/1/on/64") == note);
+    REQUIRE(on->children().size() == 1);
+
+    REQUIRE(!on->find_child("128"));
+    REQUIRE(!on->find_child("064"));
+    REQUIRE(!ossia::net::find_node(dev, "/17"));
+    REQUIRE(on->children().size() == 1);
+
+    // Handling a note does not create its node
+    auto& chan = static_cast<channel_node&>(*dev.find_child("2"));
+    auto msgs = chan.note_on(64, 100);
+    REQUIRE(msgs.size() == 1);
+    REQUIRE(chan.find_child("on")->children().size() == 0);
+
+    ossia::net::find_node(dev, "/2/on/64");
+    msgs = chan.note_on(64, 100);
+    REQUIRE(msgs.size() == 2);
+    REQUIRE(&msgs[1].dest.address() == ossia::net::find_node(dev, "/2/on/64")->get_parameter());
+  }
 #endif
@@ -0,0 +1,91 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/minuit/detail/minuit_requests.hpp>
+
+#include <string>
+#include <vector>
+
+using ossia::minuit::request_kind;
+using sent_requests = std::vector<std::pair<request_kind, std::string>>;
+
+static sent_requests take(ossia::minuit::request_queue& q)
+{
+  sent_requests r;
+  q.take_ready([&](request_kind k, ossia::string_view addr) {
+    r.emplace_back(k, std::string(addr));
+  });
+  return r;
+}
+
+TEST_CASE("test_minuit_request_window", "test_minuit_request_window")
+{
+  ossia::minuit::request_queue q{2};
+  REQUIRE(q.add(request_kind::Get, "/a:type"));
+  REQUIRE(q.add(request_kind::Namespace, "/a"));
+  REQUIRE(q.add(request_kind::Namespace, "/b"));
+  REQUIRE(q.add(request_kind::Namespace, "/c"));
+
+  // Namespace requests go first, and no more than the window
+  REQUIRE((take(q) == sent_requests{{request_kind::Namespace, "/a"},
+                                    {request_kind::Namespace, "/b"}}));
+  REQUIRE(take(q).empty());
+  REQUIRE(q.in_flight_count() == 2);
+
+  REQUIRE(q.reply(request_kind::Namespace, "/a"));
+  REQUIRE((take(q) == sent_requests{{request_kind::Namespace, "/c"}}));
+
+  REQUIRE(q.reply(request_kind::Namespace, "/b"));
+  REQUIRE(q.reply(request_kind::Namespace, "/c"));
+  REQUIRE(q.size(request_kind::Namespace) == 0);
+  REQUIRE((take(q) == sent_requests{{request_kind::Get, "/a:type"}}));
+
+  REQUIRE(q.reply(request_kind::Get, "/a:type"));
+  REQUIRE(q.empty());
+}
+
+TEST_CASE("test_minuit_request_dedup", "test_minuit_request_dedup")
+{
+  ossia::minuit::request_queue q;
+  REQUIRE(q.add(request_kind::Get, "/a:value"));
+  REQUIRE(!q.add(request_kind::Get, "/a:value"));
+
+  // The same address can be asked for with another kind of request
+  REQUIRE(q.add(request_kind::Namespace, "/a:value"));
+
+  // Once in flight, it is still not requested again
+  REQUIRE(take(q).size() == 2);
+  REQUIRE(!q.add(request_kind::Get, "/a:value"));
+
+  // Unknown replies are ignored
+  REQUIRE(!q.reply(request_kind::Get, "/b:value"));
+
+  REQUIRE(q.reply(request_kind::Get, "/a:value"));
+  REQUIRE(q.add(request_kind::Get, "/a:value"));
+}
+
+TEST_CASE("test_minuit_request_early_reply", "test_minuit_request_early_reply")
+{
+  ossia::minuit::request_queue q{1};
+  q.add(request_kind::Namespace, "/a");
+  q.add(request_kind::Namespace, "/b");
+  REQUIRE(take(q).size() == 1);
+
+  // Reply to a request sent during an earlier discovery:
+  // it is not sent again
+  REQUIRE(q.reply(request_kind::Namespace, "/b"));
+  REQUIRE(q.reply(request_kind::Namespace, "/a"));
+  REQUIRE(take(q).empty());
+  REQUIRE(q.empty());
+
+  sent_requests in_flight;
+  q.add(request_kind::Get, "/c");
+  take(q);
+  q.for_each_in_flight([&](request_kind k, ossia::string_view addr) {
+    in_flight.emplace_back(k, std::string(addr));
+  });
+  REQUIRE((in_flight == sent_requests{{request_kind::Get, "/c"}}));
+}
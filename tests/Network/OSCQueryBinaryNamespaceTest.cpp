@@ -0,0 +1,244 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/dataspace/dataspace.hpp>
+#include <ossia/network/dataspace/dataspace_visitors.hpp>
+#include <ossia/network/domain/domain.hpp>
+#include <ossia/network/exceptions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/network/oscquery/detail/binary_namespace.hpp>
+
+#include <algorithm>
+
+using namespace ossia;
+using namespace ossia::net;
+
+static void make_tree(generic_device& dev)
+{
+  auto& a = create_node(dev, "/foo/float");
+  auto pa = a.create_parameter(val_type::FLOAT);
+  pa->push_value(0.5f);
+  pa->set_domain(make_domain(0.f, 1.f));
+  pa->set_bounding(bounding_mode::CLIP);
+  pa->set_critical(true);
+  set_description(a, "a float");
+  set_tags(a, tags{"x", "y"});
+  set_priority(a, 3.f);
+
+  auto& b = create_node(dev, "/foo/list");
+  auto pb = b.create_parameter(val_type::LIST);
+  pb->push_value(std::vector<ossia::value>{1, std::string("two"), std::vector<ossia::value>{3.f}});
+  pb->set_access(access_mode::GET);
+
+  auto& c = create_node(dev, "/color");
+  auto pc = c.create_parameter(val_type::VEC3F);
+  pc->set_unit(ossia::rgb_u{});
+  pc->push_value(std::array<float, 3>{0.1f, 0.2f, 0.3f});
+
+  auto& d = create_node(dev, "/bar/choice");
+  auto pd = d.create_parameter(val_type::STRING);
+  pd->set_domain(make_domain(std::vector<std::string>{"a", "b"}));
+  pd->set_repetition_filter(repetition_filter::ON);
+  set_default_value(d, std::string("a"));
+  set_hidden(d, true);
+
+  create_node(dev, "/bar/empty");
+}
+
+static void check_tree(generic_device& dev)
+{
+  auto a = find_node(dev, "/foo/float");
+  REQUIRE(a);
+  REQUIRE(a->get_parameter());
+  REQUIRE(a->get_parameter()->value() == ossia::value{0.5f});
+  REQUIRE(get_min(a->get_parameter()->get_domain()) == ossia::value{0.f});
+  REQUIRE(get_max(a->get_parameter()->get_domain()) == ossia::value{1.f});
+  REQUIRE(a->get_parameter()->get_bounding() == bounding_mode::CLIP);
+  REQUIRE(a->get_parameter()->get_critical());
+  REQUIRE(get_description(*a) == std::string("a float"));
+  REQUIRE((get_tags(*a) == tags{"x", "y"}));
+  REQUIRE(get_priority(*a) == 3.f);
+
+  auto b = find_node(dev, "/foo/list");
+  REQUIRE(b);
+  REQUIRE(
+      b->get_parameter()->value()
+      == ossia::value{std::vector<ossia::value>{1, std::string("two"), std::vector<ossia::value>{3.f}}});
+  REQUIRE(b->get_parameter()->get_access() == access_mode::GET);
+
+  auto c = find_node(dev, "/color");
+  REQUIRE(c);
+  REQUIRE(c->get_parameter()->get_unit() == ossia::unit_t{ossia::rgb_u{}});
+  REQUIRE(
+      c->get_parameter()->value()
+      == ossia::value{std::array<float, 3>{0.1f, 0.2f, 0.3f}});
+
+  auto d = find_node(dev, "/bar/choice");
+  REQUIRE(d);
+  REQUIRE(get_values(d->get_parameter()->get_domain()).size() == 2);
+  REQUIRE(d->get_parameter()->get_repetition_filter() == repetition_filter::ON);
+  REQUIRE(get_default_value(*d) == ossia::value{std::string("a")});
+  REQUIRE(get_hidden(*d));
+
+  auto e = find_node(dev, "/bar/empty");
+  REQUIRE(e);
+  REQUIRE(!e->get_parameter());
+}
+
+TEST_CASE("test_binary_namespace_roundtrip", "test_binary_namespace_roundtrip")
+{
+  generic_device src{"src"};
+  make_tree(src);
+  const auto data = oscquery::write_binary_namespace(src);
+
+  // Whole
+  {
+    generic_device dst{"dst"};
+    create_node(dst, "/previous");
+
+    oscquery::binary_namespace_reader r{dst};
+    r.feed(data.data(), data.size());
+    r.finish();
+
+    // root, foo, float, list, color, bar, choice, empty
+    REQUIRE(r.nodes() == 8);
+    REQUIRE(!find_node(dst, "/previous"));
+    check_tree(dst);
+  }
+
+  // One byte at a time
+  {
+    generic_device dst{"dst"};
+    oscquery::binary_namespace_reader r{dst};
+    for (char c : data)
+      r.feed(&c, 1);
+    r.finish();
+    check_tree(dst);
+  }
+}
+
+TEST_CASE("test_binary_namespace_subtree", "test_binary_namespace_subtree")
+{
+  generic_device src{"src"};
+  make_tree(src);
+  const auto data = oscquery::write_binary_namespace(*find_node(src, "/foo"));
+
+  generic_device dst{"dst"};
+  auto& foo = create_node(dst, "/foo");
+  create_node(dst, "/other");
+
+  oscquery::binary_namespace_reader r{foo};
+  r.feed(data.data(), data.size());
+  r.finish();
+
+  REQUIRE(r.nodes() == 3);
+  REQUIRE(find_node(dst, "/other"));
+  REQUIRE(find_node(dst, "/foo/float"));
+  REQUIRE(find_node(dst, "/foo/list"));
+}
+
+TEST_CASE("test_binary_namespace_invalid", "test_binary_namespace_invalid")
+{
+  generic_device src{"src"};
+  make_tree(src);
+  const auto data = oscquery::write_binary_namespace(src);
+
+  {
+    generic_device dst{"dst"};
+    oscquery::binary_namespace_reader r{dst};
+    r.feed(data.data(), data.size() - 1);
+    REQUIRE_THROWS_AS(r.finish(), ossia::parse_error);
+  }
+
+  {
+    generic_device dst{"dst"};
+    oscquery::binary_namespace_reader r{dst};
+    REQUIRE_THROWS_AS(r.feed("JSON{}", 6), ossia::parse_error);
+  }
+}
+
+TEST_CASE("test_binary_namespace_names", "test_binary_namespace_names")
+{
+  // The names sent by a remote are not trusted
+  generic_device src{"src"};
+  auto& foo = static_cast<generic_node&>(create_node(src, "/foo"));
+  foo.unsafe_create_child("a/b");
+  foo.unsafe_create_child("x");
+  foo.unsafe_create_child("x");
+  const auto data = oscquery::write_binary_namespace(src);
+
+  generic_device dst{"dst"};
+  oscquery::binary_namespace_reader r{dst};
+  r.feed(data.data(), data.size());
+  r.finish();
+
+  auto n = find_node(dst, "/foo");
+  REQUIRE(n);
+  auto names = n->children_names();
+  std::sort(names.begin(), names.end());
+  REQUIRE(names.size() == 3);
+  REQUIRE(names[0] == "a_b");
+  REQUIRE(names[1] == "x");
+  REQUIRE(names[2] == "x.1");
+}
+
+namespace
+{
+struct announced_nodes
+{
+  int parameters{};
+  int attributes{};
+  bool all_attached{true};
+
+  void check(const node_base& n)
+  {
+    // Each node announced to the device must be one of its parent's children
+    for (auto cur = &n; cur->get_parent(); cur = cur->get_parent())
+    {
+      auto siblings = cur->get_parent()->children_copy();
+      if (std::find(siblings.begin(), siblings.end(), cur) == siblings.end())
+        all_attached = false;
+    }
+  }
+
+  void on_parameter(const parameter_base& p)
+  {
+    parameters++;
+    check(p.get_node());
+  }
+
+  void on_attribute(node_base& n, const std::string&)
+  {
+    attributes++;
+    check(n);
+  }
+};
+}
+
+TEST_CASE("test_binary_namespace_signals", "test_binary_namespace_signals")
+{
+  // Subtrees are built before being added: the device only hears about
+  // their parameters and attributes once they are attached
+  generic_device src{"src"};
+  make_tree(src);
+  const auto data = oscquery::write_binary_namespace(src);
+
+  generic_device dst{"dst"};
+  announced_nodes n;
+  dst.on_parameter_created.connect<&announced_nodes::on_parameter>(n);
+  dst.on_attribute_modified.connect<&announced_nodes::on_attribute>(n);
+
+  oscquery::binary_namespace_reader r{dst};
+  r.feed(data.data(), data.size());
+  r.finish();
+
+  REQUIRE(n.parameters == 4);
+  REQUIRE(n.attributes > 0);
+  REQUIRE(n.all_attached);
+  check_tree(dst);
+}
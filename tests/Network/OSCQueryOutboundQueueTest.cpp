@@ -0,0 +1,93 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/oscquery/detail/outbound_queue.hpp>
+
+#include <vector>
+
+using namespace ossia::oscquery;
+
+static shared_payload payload(std::string s)
+{
+  return std::make_shared<const std::string>(std::move(s));
+}
+
+static std::vector<std::string> drain(outbound_queue& q)
+{
+  std::vector<std::string> res;
+  q.consume([&](const outbound_queue::message& m) { res.push_back(*m.payload); });
+  return res;
+}
+
+TEST_CASE("test_outbound_queue_schedule", "test_outbound_queue_schedule")
+{
+  outbound_queue q;
+  // Only the first push after a consume asks for a flush
+  REQUIRE(q.push("/a", payload("a1"), false));
+  REQUIRE(!q.push("/b", payload("b1"), false));
+  REQUIRE(!q.push("/c", payload("c1"), true));
+
+  REQUIRE((drain(q) == std::vector<std::string>{"a1", "b1", "c1"}));
+  REQUIRE(drain(q).empty());
+
+  REQUIRE(q.push("/a", payload("a2"), false));
+}
+
+TEST_CASE("test_outbound_queue_latest_wins", "test_outbound_queue_latest_wins")
+{
+  outbound_queue q;
+  q.push("/a", payload("a1"), false);
+  q.push("/b", payload("b1"), false);
+  q.push("/a", payload("a2"), false);
+  q.push("/a", payload("a3"), false);
+
+  // The value keeps the position of the first one
+  REQUIRE((drain(q) == std::vector<std::string>{"a3", "b1"}));
+
+  // Once sent, a new value of the same address is queued again
+  q.push("/b", payload("b2"), false);
+  q.push("/a", payload("a4"), false);
+  REQUIRE((drain(q) == std::vector<std::string>{"b2", "a4"}));
+}
+
+TEST_CASE("test_outbound_queue_critical", "test_outbound_queue_critical")
+{
+  outbound_queue q;
+  q.push("/a", payload("a1"), true);
+  q.push("/a", payload("a2"), true);
+  q.push("/a", payload("a3"), true);
+
+  REQUIRE((drain(q) == std::vector<std::string>{"a1", "a2", "a3"}));
+}
+
+TEST_CASE("test_outbound_queue_bounded", "test_outbound_queue_bounded")
+{
+  outbound_queue q;
+  for (std::size_t i = 0; i < outbound_queue::max_size + 10; i++)
+    q.push("/a", payload(std::to_string(i)), true);
+
+  // New addresses are dropped as well
+  q.push("/b", payload("b1"), false);
+  REQUIRE(q.take_dropped() == 11);
+  REQUIRE(q.take_dropped() == 0);
+
+  auto res = drain(q);
+  REQUIRE(res.size() == outbound_queue::max_size);
+  REQUIRE(res.back() == std::to_string(outbound_queue::max_size - 1));
+}
+
+TEST_CASE("test_outbound_queue_shared_payload", "test_outbound_queue_shared_payload")
+{
+  outbound_queue q1, q2;
+  auto p = payload("a1");
+  q1.push("/a", p, false);
+  q2.push("/a", p, false);
+  REQUIRE(p.use_count() == 3);
+
+  drain(q1);
+  drain(q2);
+  REQUIRE(p.use_count() == 1);
+}
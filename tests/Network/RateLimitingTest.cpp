@@ -0,0 +1,92 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/network/generic/generic_parameter.hpp>
+#include <ossia/network/rate_limiting_protocol.hpp>
+
+#include <mutex>
+#include <thread>
+
+using namespace std::literals;
+
+namespace
+{
+struct counting_protocol final : ossia::net::protocol_base
+{
+  counting_protocol() : protocol_base{flags{}} { }
+
+  bool pull(ossia::net::parameter_base&) override { return false; }
+  bool push(const ossia::net::parameter_base&, const ossia::value& v) override
+  {
+    std::lock_guard l{mutex};
+    values.push_back(v);
+    return true;
+  }
+  bool push_bundle(const std::vector<const ossia::net::parameter_base*>& v) override
+  {
+    std::lock_guard l{mutex};
+    bundles.push_back(v.size());
+    return true;
+  }
+  bool push_raw(const ossia::net::full_parameter_data&) override { return false; }
+  bool observe(ossia::net::parameter_base&, bool) override { return false; }
+  bool update(ossia::net::node_base&) override { return false; }
+
+  std::mutex mutex;
+  std::vector<ossia::value> values;
+  std::vector<std::size_t> bundles;
+};
+}
+
+TEST_CASE ("test_rate_limiting_latest_value", "test_rate_limiting_latest_value")
+{
+  auto proto = std::make_unique<counting_protocol>();
+  auto& counter = *proto;
+  ossia::net::generic_device dev{
+    std::make_unique<ossia::net::rate_limiting_protocol>(50ms, std::move(proto)), "test"};
+
+  auto p = ossia::net::create_node(dev, "/foo").create_parameter(ossia::val_type::INT);
+  for(int i = 0; i < 100; i++)
+    p->push_value(i);
+
+  std::this_thread::sleep_for(150ms);
+
+  std::lock_guard l{counter.mutex};
+  // Only the latest value of each period is sent
+  REQUIRE(!counter.values.empty());
+  REQUIRE(counter.values.size() <= 2);
+  REQUIRE(counter.values.back() == ossia::value{99});
+}
+
+TEST_CASE ("test_rate_limiting_bundles", "test_rate_limiting_bundles")
+{
+  auto proto = std::make_unique<counting_protocol>();
+  auto& counter = *proto;
+  auto limiter = std::make_unique<ossia::net::rate_limiting_protocol>(50ms, std::move(proto));
+  limiter->set_bundling(true);
+  limiter->set_max_bundle_size(1400);
+  ossia::net::generic_device dev{std::move(limiter), "test"};
+
+  std::vector<ossia::net::parameter_base*> params;
+  for(int i = 0; i < 200; i++)
+    params.push_back(ossia::net::create_node(dev, "/foo." + std::to_string(i)).create_parameter(ossia::val_type::FLOAT));
+
+  for(int k = 0; k < 3; k++)
+    for(auto p : params)
+      p->push_value(float(k));
+
+  std::this_thread::sleep_for(150ms);
+
+  std::lock_guard l{counter.mutex};
+  REQUIRE(counter.values.empty());
+  REQUIRE(counter.bundles.size() > 1);
+
+  std::size_t total = 0;
+  for(auto sz : counter.bundles)
+    total += sz;
+  REQUIRE(total == 200);
+}
@@ -297,3 +297,57 @@ TEST_CASE ("test_bool", "test_bool")
       REQUIRE(a2->value() == ossia::value{false});
   }
 }
+
+TEST_CASE ("test_compiled_preset", "test_compiled_preset")
+{
+  ossia::net::generic_device dev{"mydevice"};
+  auto& root = dev.get_root_node();
+
+  auto a1 = ossia::net::find_or_create_node(root, "/foo/int").create_parameter(ossia::val_type::INT);
+  auto a2 = ossia::net::find_or_create_node(root, "/foo/float").create_parameter(ossia::val_type::FLOAT);
+  auto a3 = ossia::net::find_or_create_node(root, "/foo/string").create_parameter(ossia::val_type::STRING);
+
+  a1->push_value(0);
+  a2->push_value(0.f);
+  a3->push_value(std::string("a"));
+
+  ossia::presets::preset p{
+    {"/foo/int", 10},
+    {"/foo/float", 1.f},
+    {"/foo/string", std::string("b")},
+    {"/foo/missing", 1}};
+
+  ossia::presets::compiled_preset compiled{root, p};
+  REQUIRE(compiled.size() == 3);
+  REQUIRE(compiled.unresolved() == std::vector<std::string>{"/foo/missing"});
+
+  REQUIRE(compiled.apply() == 3);
+  REQUIRE(a1->value() == ossia::value{10});
+  REQUIRE(a2->value() == ossia::value{1.f});
+  REQUIRE(a3->value() == ossia::value{std::string("b")});
+
+  // Unchanged parameters are skipped
+  REQUIRE(compiled.apply() == 0);
+  a1->push_value(5);
+  REQUIRE(compiled.apply() == 1);
+
+  // Interpolated recall
+  a1->push_value(0);
+  a2->push_value(0.f);
+  a3->push_value(std::string("a"));
+  compiled.start_recall(4);
+  REQUIRE(compiled.recalling());
+
+  REQUIRE(compiled.tick());
+  REQUIRE(a1->value() == ossia::value{3});
+  REQUIRE(a2->value() == ossia::value{0.25f});
+  REQUIRE(a3->value() == ossia::value{std::string("a")});
+
+  REQUIRE(compiled.tick());
+  REQUIRE(compiled.tick());
+  REQUIRE(!compiled.tick());
+  REQUIRE(!compiled.recalling());
+  REQUIRE(a1->value() == ossia::value{10});
+  REQUIRE(a2->value() == ossia::value{1.f});
+  REQUIRE(a3->value() == ossia::value{std::string("b")});
+}